@@ -17,6 +17,11 @@ class AppDelegate: UIResponder, UIApplicationDelegate,  AppConnectDelegate {
     func appConnect(_ appConnect: AppConnect, authStateChangedTo newAuthState: ACAuthState, withMessage message: String?) {
         print("appconnect auth state changed")
     }
+
+    func appConnect(_ appConnect: AppConnect, secureServicesAvailabilityChangedTo secureServicesAvailability: ACSecureServicesAvailability) {
+        print("appconnect secure services availability changed")
+        DerivedKeyService.shared.flush()
+    }
     
 
     var appConnect: AppConnect?
@@ -30,6 +35,7 @@ class AppDelegate: UIResponder, UIApplicationDelegate,  AppConnectDelegate {
     
     
     func stopAppConnect() {
+        DerivedKeyService.shared.flush()
         self.appConnect!.retire()
         self.appConnect!.stop()
         self.appConnect = nil
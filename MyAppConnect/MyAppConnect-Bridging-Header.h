@@ -7,4 +7,4 @@
 //
 
 #import "AppConnectHandler.h"
-
+#import "Shared/SecureFileShims.h"
@@ -0,0 +1,170 @@
+//
+//  DerivedKeyService.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import AppConnect
+
+/// Where `DerivedKeyService` gets its keys: AppConnect in the app, a stub in tests.
+protocol DerivedKeySource: AnyObject {
+    /// Whether secure services are available; while they are not, the service flushes its cache and fails.
+    var isAvailable: Bool { get }
+
+    func derivedKey(for identifier: DerivedKeyService.Identifier) throws -> ACSensitiveData
+}
+
+/// Memoizing front end for -derivedAppKeyWithIdentifier:error: and -derivedSharedKeyWithIdentifier:error:.
+///
+/// The data layer asks for the same few identifiers on every request, and every AppConnect call runs the KDF again.
+/// Keys are derived once per identifier and kept in ACSensitiveDataContainers, so they stay in AppConnect's sensitive
+/// memory. When the cache is full, the least recently used key is dropped. The cache is flushed as soon as secure
+/// services are found unavailable, and by `flush()`, which the app delegate calls when AppConnect is retired or
+/// stopped and when secureServicesAvailability changes.
+final class DerivedKeyService {
+    enum Identifier: Hashable {
+        case app(String)
+        case shared(String)
+    }
+
+    struct Statistics {
+        var hits = 0
+        var misses = 0
+        var evictions = 0
+        var flushes = 0
+
+        var hitRate: Double {
+            let lookups = hits + misses
+            return lookups == 0 ? 0 : Double(hits) / Double(lookups)
+        }
+    }
+
+    static let shared = DerivedKeyService()
+    static let defaultCapacity = 64
+
+    let capacity: Int
+
+    private let source: DerivedKeySource
+    private var containers: [Identifier: (container: ACSensitiveDataContainer, lastUse: UInt64)] = [:]
+    private var clock: UInt64 = 0
+    private var generation: UInt64 = 0
+    private var stats = Statistics()
+    private let lock = NSLock()
+
+    init(capacity: Int = DerivedKeyService.defaultCapacity, source: DerivedKeySource = AppConnectDerivedKeySource()) {
+        self.capacity = max(capacity, 1)
+        self.source = source
+    }
+
+    var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    func derivedAppKey(withIdentifier identifier: String) throws -> ACSensitiveData {
+        return try derivedKeys(for: [.app(identifier)])[.app(identifier)]!
+    }
+
+    func derivedSharedKey(withIdentifier identifier: String) throws -> ACSensitiveData {
+        return try derivedKeys(for: [.shared(identifier)])[.shared(identifier)]!
+    }
+
+    /// Checks that secure services are available, flushing the cache and failing if they are not, and returns the
+    /// number of flushes so far. Caches of keys derived from these keys compare it to know when to drop their own.
+    func currentGeneration() throws -> UInt64 {
+        guard source.isAvailable else {
+            flush()
+            throw SecureFileError.noKeys
+        }
+        lock.lock()
+        defer { lock.unlock() }
+        return generation
+    }
+
+    /// Returns the keys for all of `identifiers`, taking the lock once to look them up and deriving only the ones not
+    /// cached yet.
+    ///
+    /// The KDF runs without the lock, so a slow derivation does not hold up lookups of cached keys. Secure services
+    /// may become unavailable, or the cache may be flushed, while it runs: the first fails the call, and the second
+    /// returns the new keys without caching them.
+    func derivedKeys(for identifiers: [Identifier]) throws -> [Identifier: ACSensitiveData] {
+        let generation = try currentGeneration()
+
+        var keys: [Identifier: ACSensitiveData] = [:]
+        var missing: [Identifier] = []
+        lock.lock()
+        for identifier in identifiers where keys[identifier] == nil && !missing.contains(identifier) {
+            clock += 1
+            if let container = containers[identifier]?.container {
+                stats.hits += 1
+                containers[identifier]?.lastUse = clock
+                keys[identifier] = container.data
+            } else {
+                stats.misses += 1
+                missing.append(identifier)
+            }
+        }
+        lock.unlock()
+        guard !missing.isEmpty else { return keys }
+
+        var derived: [Identifier: ACSensitiveData] = [:]
+        for identifier in missing {
+            derived[identifier] = try source.derivedKey(for: identifier)
+        }
+        guard source.isAvailable else {
+            flush()
+            throw SecureFileError.noKeys
+        }
+
+        lock.lock()
+        defer { lock.unlock() }
+        for (identifier, key) in derived {
+            keys[identifier] = key
+            // Another caller may have cached the same key meanwhile.
+            guard generation == self.generation, containers[identifier] == nil else { continue }
+            clock += 1
+            if containers.count >= capacity,
+                let oldest = containers.min(by: { $0.value.lastUse < $1.value.lastUse }) {
+                containers[oldest.key] = nil
+                stats.evictions += 1
+            }
+            containers[identifier] = (ACSensitiveDataContainer(data: key), clock)
+        }
+        return keys
+    }
+
+    /// Drops every cached key.
+    func flush() {
+        lock.lock()
+        defer { lock.unlock() }
+        if !containers.isEmpty {
+            stats.flushes += 1
+        }
+        containers.removeAll()
+        generation += 1
+    }
+}
+
+/// Derives keys with the shared AppConnect instance.
+final class AppConnectDerivedKeySource: DerivedKeySource {
+    var isAvailable: Bool {
+        guard let appConnect = AppConnect.sharedInstance() else { return false }
+        return appConnect.isReady && appConnect.secureServicesAvailability == .available
+    }
+
+    func derivedKey(for identifier: DerivedKeyService.Identifier) throws -> ACSensitiveData {
+        guard let appConnect = AppConnect.sharedInstance() else {
+            throw SecureFileError.noKeys
+        }
+        switch identifier {
+        case .app(let name):
+            return try appConnect.derivedAppKey(withIdentifier: name)
+        case .shared(let name):
+            return try appConnect.derivedSharedKey(withIdentifier: name)
+        }
+    }
+}
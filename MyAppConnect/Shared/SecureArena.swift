@@ -0,0 +1,305 @@
+//
+//  SecureArena.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import AppConnect
+
+/// Allocator for plaintext and key material.
+///
+/// Blocks of up to `maximumClassSize` bytes come from power-of-two size classes carved out of slabs. Each slab is
+/// mapped once, aligned to its size, locked in RAM with mlock so it is never paged out, and surrounded by inaccessible
+/// guard pages, so a linear overrun faults instead of reaching unrelated heap memory. Freed blocks are wiped and
+/// recycled. Every thread keeps a small cache of free blocks per class, so allocating and freeing a block takes no lock
+/// and no system call; a thread only touches the shared free lists to refill or flush its cache in batches. A slab
+/// whose blocks are all back in the shared free list is unmapped once its class holds more than
+/// `retainedSlabsPerClass` slabs of free blocks.
+///
+/// Larger blocks get a locked, guard-paged mapping of their own. Freed ones are wiped and kept in a pool of up to
+/// `largePoolBudget` bytes, so buffers that are allocated over and over, such as the comparison buffers of
+/// `SecureChunkedFile.contentsEqual(atPath:andPath:)`, skip the system calls after the first time. Memory handed out
+/// is always zeroed. When the system cannot map more memory, allocation fails with ACErrorLowMemory.
+final class SecureArena {
+    static let shared = SecureArena()
+
+    static let minimumClassSize = 16
+    static let maximumClassSize = 64 * 1024
+    static let slabSize = 256 * 1024
+    static let retainedSlabsPerClass = 1
+    static let largePoolBudget = 4 * 1024 * 1024
+
+    struct Statistics {
+        /// Slabs currently mapped.
+        var slabs = 0
+        /// Empty slabs given back to the system.
+        var releasedSlabs = 0
+        /// Large blocks mapped, not counting those served from the pool.
+        var largeAllocations = 0
+        var largePoolHits = 0
+        /// Bytes of freed large blocks kept in the pool.
+        var largePoolBytes = 0
+        /// Bytes mapped for slabs and large blocks that mlock managed to lock.
+        var lockedBytes = 0
+        /// Batches moved between the shared free lists and the thread caches.
+        var refills = 0
+        var flushes = 0
+    }
+
+    /// Blocks of a slab that are in the shared free list, and whether mlock locked it.
+    private struct Slab {
+        var freeBlocks: Int
+        let locked: Bool
+    }
+
+    /// Free blocks of one thread, returned to the shared lists when the thread exits.
+    private final class ThreadCache {
+        let arena: SecureArena
+        var magazines: [[UnsafeMutableRawPointer]]
+
+        init(arena: SecureArena) {
+            self.arena = arena
+            magazines = Array(repeating: [], count: arena.classCount)
+        }
+
+        deinit {
+            for (sizeClass, magazine) in magazines.enumerated() where !magazine.isEmpty {
+                arena.flush(magazine, sizeClass: sizeClass)
+            }
+        }
+    }
+
+    private let pageSize = Int(getpagesize())
+    private let classCount: Int
+    private var freeLists: [[UnsafeMutableRawPointer]]
+    private var slabs: [UnsafeMutableRawPointer: Slab] = [:]
+    private var stats = Statistics()
+    /// Whether each mapped large block, live or pooled, could be locked, so `lockedBytes` stays exact when it is
+    /// unmapped.
+    private var largeBlocks: [UnsafeMutableRawPointer: Bool] = [:]
+    /// Freed large blocks by mapped size.
+    private var largePool: [Int: [UnsafeMutableRawPointer]] = [:]
+    private let lock = NSLock()
+    private var cacheKey = pthread_key_t()
+
+    private init() {
+        classCount = (SecureArena.maximumClassSize / SecureArena.minimumClassSize).trailingZeroBitCount + 1
+        freeLists = Array(repeating: [], count: classCount)
+        pthread_key_create(&cacheKey) { cache in
+            Unmanaged<SecureArena.ThreadCache>.fromOpaque(cache).release()
+        }
+    }
+
+    var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// Returns `count` zeroed bytes aligned to at least 16 bytes, or throws ACErrorLowMemory.
+    func allocate(_ count: Int) throws -> UnsafeMutableRawPointer {
+        guard let sizeClass = self.sizeClass(for: count) else {
+            return try allocateLarge(count)
+        }
+        let cache = threadCache()
+        if let pointer = cache.magazines[sizeClass].popLast() {
+            return pointer
+        }
+        try refill(cache, sizeClass: sizeClass)
+        return cache.magazines[sizeClass].popLast()!
+    }
+
+    /// Wipes and recycles a block returned by `allocate(_:)` for the same `count`.
+    func deallocate(_ pointer: UnsafeMutableRawPointer, count: Int) {
+        guard let sizeClass = self.sizeClass(for: count) else {
+            deallocateLarge(pointer, count: count)
+            return
+        }
+        SecureMemory.wipe(UnsafeMutableRawBufferPointer(start: pointer, count: classSize(sizeClass)))
+        let cache = threadCache()
+        cache.magazines[sizeClass].append(pointer)
+        if cache.magazines[sizeClass].count > magazineCapacity(sizeClass) {
+            let keep = magazineCapacity(sizeClass) / 2
+            flush(Array(cache.magazines[sizeClass][keep...]), sizeClass: sizeClass)
+            cache.magazines[sizeClass].removeSubrange(keep...)
+        }
+    }
+
+    // MARK: Size classes
+
+    private func sizeClass(for count: Int) -> Int? {
+        guard count <= SecureArena.maximumClassSize else { return nil }
+        let size = max(count, SecureArena.minimumClassSize)
+        let rounded = size.nonzeroBitCount == 1 ? size : 1 << (Int.bitWidth - (size - 1).leadingZeroBitCount)
+        return (rounded / SecureArena.minimumClassSize).trailingZeroBitCount
+    }
+
+    private func classSize(_ sizeClass: Int) -> Int {
+        return SecureArena.minimumClassSize << sizeClass
+    }
+
+    /// Blocks a thread may keep per class: plenty of small ones, a few large ones.
+    private func magazineCapacity(_ sizeClass: Int) -> Int {
+        return max(4, min(64, SecureArena.slabSize / 4 / classSize(sizeClass)))
+    }
+
+    // MARK: Shared free lists
+
+    private func threadCache() -> ThreadCache {
+        if let cache = pthread_getspecific(cacheKey) {
+            return Unmanaged<ThreadCache>.fromOpaque(cache).takeUnretainedValue()
+        }
+        let cache = ThreadCache(arena: self)
+        pthread_setspecific(cacheKey, Unmanaged.passRetained(cache).toOpaque())
+        return cache
+    }
+
+    private func refill(_ cache: ThreadCache, sizeClass: Int) throws {
+        let batch = max(1, magazineCapacity(sizeClass) / 2)
+        lock.lock()
+        defer { lock.unlock() }
+        if freeLists[sizeClass].isEmpty {
+            try mapSlab(sizeClass)
+        }
+        let take = min(batch, freeLists[sizeClass].count)
+        for block in freeLists[sizeClass].suffix(take) {
+            slabs[slabBase(of: block)]!.freeBlocks -= 1
+        }
+        cache.magazines[sizeClass].append(contentsOf: freeLists[sizeClass].suffix(take))
+        freeLists[sizeClass].removeLast(take)
+        stats.refills += 1
+    }
+
+    private func flush(_ blocks: [UnsafeMutableRawPointer], sizeClass: Int) {
+        lock.lock()
+        defer { lock.unlock() }
+        freeLists[sizeClass].append(contentsOf: blocks)
+        stats.flushes += 1
+
+        let perSlab = SecureArena.slabSize / classSize(sizeClass)
+        var emptied: [UnsafeMutableRawPointer] = []
+        for block in blocks {
+            let base = slabBase(of: block)
+            slabs[base]!.freeBlocks += 1
+            if slabs[base]!.freeBlocks == perSlab {
+                emptied.append(base)
+            }
+        }
+        for base in emptied where freeLists[sizeClass].count > perSlab * SecureArena.retainedSlabsPerClass {
+            releaseSlab(base, sizeClass: sizeClass)
+        }
+    }
+
+    /// Maps a slab for `sizeClass` and adds its blocks to the free list. Called with `lock` held.
+    private func mapSlab(_ sizeClass: Int) throws {
+        guard let mapping = mapGuarded(SecureArena.slabSize, alignment: SecureArena.slabSize) else {
+            throw SecureFileError.appConnect(ACErrorLowMemory)
+        }
+        let (base, locked) = mapping
+        if locked {
+            stats.lockedBytes += SecureArena.slabSize
+        }
+        let size = classSize(sizeClass)
+        for offset in stride(from: 0, to: SecureArena.slabSize, by: size) {
+            freeLists[sizeClass].append(base + offset)
+        }
+        slabs[base] = Slab(freeBlocks: SecureArena.slabSize / size, locked: locked)
+        stats.slabs += 1
+    }
+
+    /// Drops the blocks of the empty slab at `base` from the free list and unmaps it. Called with `lock` held.
+    private func releaseSlab(_ base: UnsafeMutableRawPointer, sizeClass: Int) {
+        let end = base + SecureArena.slabSize
+        freeLists[sizeClass].removeAll { $0 >= base && $0 < end }
+        if slabs.removeValue(forKey: base)!.locked {
+            munlock(base, SecureArena.slabSize)
+            stats.lockedBytes -= SecureArena.slabSize
+        }
+        munmap(base - pageSize, SecureArena.slabSize + 2 * pageSize)
+        stats.slabs -= 1
+        stats.releasedSlabs += 1
+    }
+
+    private func slabBase(of block: UnsafeMutableRawPointer) -> UnsafeMutableRawPointer {
+        return UnsafeMutableRawPointer(bitPattern: UInt(bitPattern: block) & ~UInt(SecureArena.slabSize - 1))!
+    }
+
+    // MARK: Mappings
+
+    private func allocateLarge(_ count: Int) throws -> UnsafeMutableRawPointer {
+        let size = roundToPages(count)
+        lock.lock()
+        if let pointer = largePool[size]?.popLast() {
+            stats.largePoolHits += 1
+            stats.largePoolBytes -= size
+            lock.unlock()
+            return pointer
+        }
+        lock.unlock()
+
+        guard let mapping = mapGuarded(size, alignment: pageSize) else {
+            throw SecureFileError.appConnect(ACErrorLowMemory)
+        }
+        let (pointer, locked) = mapping
+        lock.lock()
+        stats.largeAllocations += 1
+        if locked {
+            stats.lockedBytes += size
+        }
+        largeBlocks[pointer] = locked
+        lock.unlock()
+        return pointer
+    }
+
+    private func deallocateLarge(_ pointer: UnsafeMutableRawPointer, count: Int) {
+        let size = roundToPages(count)
+        SecureMemory.wipe(UnsafeMutableRawBufferPointer(start: pointer, count: size))
+        lock.lock()
+        if stats.largePoolBytes + size <= SecureArena.largePoolBudget {
+            largePool[size, default: []].append(pointer)
+            stats.largePoolBytes += size
+            lock.unlock()
+            return
+        }
+        if largeBlocks.removeValue(forKey: pointer) == true {
+            munlock(pointer, size)
+            stats.lockedBytes -= size
+        }
+        lock.unlock()
+        munmap(pointer - pageSize, size + 2 * pageSize)
+    }
+
+    /// Maps `size` bytes at a multiple of `alignment` between two guard pages and tries to lock them, or returns nil
+    /// when the system has no memory to spare. Mapped memory is zero-filled.
+    private func mapGuarded(_ size: Int, alignment: Int) -> (UnsafeMutableRawPointer, locked: Bool)? {
+        // Reserve room to slide the block up to the alignment, then unmap what lies outside the guard pages.
+        let slack = alignment > pageSize ? alignment : 0
+        let total = size + 2 * pageSize + slack
+        guard let mapping = mmap(nil, total, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0), mapping != MAP_FAILED else {
+            return nil
+        }
+        let first = UInt(bitPattern: mapping + pageSize)
+        let aligned = (first + UInt(alignment) - 1) & ~(UInt(alignment) - 1)
+        let base = UnsafeMutableRawPointer(bitPattern: aligned)!
+        let head = mapping.distance(to: base - pageSize)
+        let tail = total - head - (size + 2 * pageSize)
+        if head > 0 {
+            munmap(mapping, head)
+        }
+        if tail > 0 {
+            munmap(base + size + pageSize, tail)
+        }
+        guard mprotect(base, size, PROT_READ | PROT_WRITE) == 0 else {
+            munmap(base - pageSize, size + 2 * pageSize)
+            return nil
+        }
+        return (base, mlock(base, size) == 0)
+    }
+
+    private func roundToPages(_ count: Int) -> Int {
+        return (max(count, 1) + pageSize - 1) / pageSize * pageSize
+    }
+}
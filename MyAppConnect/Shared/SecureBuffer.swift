@@ -0,0 +1,49 @@
+//
+//  SecureBuffer.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+
+/// Fixed-size, zero-initialized buffer for plaintext and key material. The memory comes from `SecureArena`, so it is
+/// locked in RAM and wiped before it is reused; creating one fails with ACErrorLowMemory when the arena cannot grow.
+final class SecureBuffer {
+    let count: Int
+    let pointer: UnsafeMutableRawPointer
+
+    init(count: Int) throws {
+        self.count = count
+        pointer = try SecureArena.shared.allocate(max(count, 1))
+        if SecureLifetimeTracker.shared.isEnabled {
+            SecureLifetimeTracker.shared.track(self, size: count)
+        }
+    }
+
+    deinit {
+        SecureArena.shared.deallocate(pointer, count: max(count, 1))
+    }
+
+    var bytes: UnsafeMutableRawBufferPointer {
+        return UnsafeMutableRawBufferPointer(start: pointer, count: count)
+    }
+
+    func wipe() {
+        SecureBuffer.wipe(bytes)
+    }
+
+    static func wipe(_ bytes: UnsafeMutableRawBufferPointer) {
+        SecureMemory.wipe(bytes)
+    }
+
+    /// Constant-time comparison of the contents, see `SecureMemory.constantTimeEqual(_:_:)`.
+    func isEqualInConstantTime(to other: SecureBuffer) -> Bool {
+        return SecureMemory.constantTimeEqual(UnsafeRawBufferPointer(bytes), UnsafeRawBufferPointer(other.bytes))
+    }
+
+    static func wipe(_ data: inout Data) {
+        data.withUnsafeMutableBytes { wipe($0) }
+    }
+}
@@ -0,0 +1,145 @@
+//
+//  SecureChunkCache.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+
+/// LRU cache of decrypted chunks, bounded by a byte budget. Evicted and removed chunks are wiped before reuse.
+///
+/// Not thread safe; the owning `SecureChunkedFile` serializes access.
+final class SecureChunkCache {
+    struct Statistics {
+        var hits = 0
+        var misses = 0
+        var evictions = 0
+    }
+
+    private final class Entry {
+        let index: UInt64
+        let buffer: SecureBuffer
+        var newer: Entry?
+        weak var older: Entry?
+
+        init(index: UInt64, buffer: SecureBuffer) {
+            self.index = index
+            self.buffer = buffer
+        }
+    }
+
+    let chunkSize: Int
+    let byteBudget: Int
+    private(set) var statistics = Statistics()
+
+    private var entries: [UInt64: Entry] = [:]
+    private var oldest: Entry?
+    private weak var newest: Entry?
+
+    init(chunkSize: Int, byteBudget: Int) {
+        self.chunkSize = chunkSize
+        self.byteBudget = byteBudget
+    }
+
+    deinit {
+        removeAll()
+    }
+
+    var capacity: Int {
+        return byteBudget / chunkSize
+    }
+
+    /// Returns the cached plaintext of chunk `index` and marks it most recently used.
+    func lookup(_ index: UInt64) -> UnsafeRawBufferPointer? {
+        guard let entry = entries[index] else {
+            statistics.misses += 1
+            return nil
+        }
+        statistics.hits += 1
+        moveToNewest(entry)
+        return UnsafeRawBufferPointer(entry.buffer.bytes)
+    }
+
+    /// Caches a copy of `plaintext` for chunk `index`, evicting the least recently used chunks over budget.
+    func insert(_ index: UInt64, plaintext: UnsafeRawBufferPointer) {
+        guard capacity > 0 else { return }
+        if let entry = entries[index] {
+            entry.buffer.bytes.copyMemory(from: plaintext)
+            moveToNewest(entry)
+            return
+        }
+
+        var buffer: SecureBuffer?
+        while entries.count >= capacity, let victim = oldest {
+            unlink(victim)
+            entries[victim.index] = nil
+            victim.buffer.wipe()
+            buffer = victim.buffer
+            statistics.evictions += 1
+        }
+        // Caching is best effort: without memory for a new entry the chunk is simply not cached.
+        guard let entryBuffer = buffer ?? (try? SecureBuffer(count: chunkSize)) else { return }
+        let entry = Entry(index: index, buffer: entryBuffer)
+        entry.buffer.bytes.copyMemory(from: plaintext)
+        entries[index] = entry
+        link(entry)
+    }
+
+    /// Refreshes chunk `index` if it is cached, without counting a lookup.
+    func update(_ index: UInt64, plaintext: UnsafeRawBufferPointer) {
+        guard let entry = entries[index] else { return }
+        entry.buffer.bytes.copyMemory(from: plaintext)
+    }
+
+    func remove(from index: UInt64) {
+        for entry in entries.values where entry.index >= index {
+            unlink(entry)
+            entries[entry.index] = nil
+            entry.buffer.wipe()
+        }
+    }
+
+    func removeAll() {
+        for entry in entries.values {
+            entry.buffer.wipe()
+        }
+        entries.removeAll()
+        oldest = nil
+        newest = nil
+    }
+
+    // MARK: Recency list
+
+    private func link(_ entry: Entry) {
+        entry.older = newest
+        entry.newer = nil
+        newest?.newer = entry
+        newest = entry
+        if oldest == nil {
+            oldest = entry
+        }
+    }
+
+    private func unlink(_ entry: Entry) {
+        let older = entry.older
+        let newer = entry.newer
+        older?.newer = newer
+        newer?.older = older
+        if oldest === entry {
+            oldest = newer
+        }
+        if newest === entry {
+            newest = older
+        }
+        entry.newer = nil
+        entry.older = nil
+    }
+
+    private func moveToNewest(_ entry: Entry) {
+        guard newest !== entry else { return }
+        unlink(entry)
+        link(entry)
+    }
+}
@@ -0,0 +1,210 @@
+//
+//  SecureChunkCipher.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import CryptoKit
+import AppConnect
+
+/// AEAD used for the chunks of a secure chunked file. The suite is recorded in the file header, so existing files keep
+/// their cipher while new files use `SecureChunkCipherSuite.preferred`.
+enum SecureChunkCipherSuite: UInt32 {
+    case aesGCM = 0
+    case chaChaPoly = 1
+
+    /// Suites whose backend passed its known-answer test in this process. Only these can make a cipher.
+    static let verifiedSuites = Set([SecureChunkCipherSuite.aesGCM, .chaChaPoly].filter { $0.passesKnownAnswerTest() })
+
+    /// Suite for new files, chosen once per process: AES-GCM when the CPU has AES instructions (ARMv8 crypto
+    /// extensions on devices, AES-NI and PCLMULQDQ in the simulator), otherwise ChaCha20-Poly1305, which is faster in
+    /// software. Nil when no backend passes its known-answer test, in which case nothing may be encrypted.
+    static let preferred: SecureChunkCipherSuite? = {
+        let candidates: [SecureChunkCipherSuite] =
+            SecureChunkCipherSuite.hasHardwareAES ? [.aesGCM, .chaChaPoly] : [.chaChaPoly, .aesGCM]
+        return candidates.first { SecureChunkCipherSuite.verifiedSuites.contains($0) }
+    }()
+
+    static var hasHardwareAES: Bool {
+        #if arch(arm64)
+        return true
+        #elseif arch(x86_64)
+        return sysctlFlag("hw.optional.aes")
+        #else
+        return false
+        #endif
+    }
+
+    /// Fails with ACErrorInternal when the backend did not pass its known-answer test.
+    func makeCipher(key: SymmetricKey) throws -> SecureChunkCipher {
+        guard SecureChunkCipherSuite.verifiedSuites.contains(self) else {
+            throw SecureFileError.appConnect(ACErrorInternal)
+        }
+        return makeBackend(key: key)
+    }
+
+    private func makeBackend(key: SymmetricKey) -> FixedNonceChunkCipher {
+        switch self {
+        case .aesGCM:
+            return AESGCMChunkCipher(key: key)
+        case .chaChaPoly:
+            return ChaChaPolyChunkCipher(key: key)
+        }
+    }
+
+    /// Checks the backend against a published vector: GCM test case 14 (McGrew and Viega) or RFC 8439 section 2.8.2.
+    func passesKnownAnswerTest() -> Bool {
+        let key: SymmetricKey
+        let nonce: [UInt8]
+        let plaintext: [UInt8]
+        let associatedData: [UInt8]
+        let expectedTag: [UInt8]
+        switch self {
+        case .aesGCM:
+            key = SymmetricKey(data: [UInt8](repeating: 0, count: 32))
+            nonce = [UInt8](repeating: 0, count: 12)
+            plaintext = [UInt8](repeating: 0, count: 16)
+            associatedData = []
+            expectedTag = SecureChunkCipherSuite.bytes("d0d1c8a799996bf0265b98b5d48ab919")
+        case .chaChaPoly:
+            key = SymmetricKey(data: (0x80...0x9f).map { UInt8($0) })
+            nonce = SecureChunkCipherSuite.bytes("070000004041424344454647")
+            plaintext = Array(("Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the " +
+                "future, sunscreen would be it.").utf8)
+            associatedData = SecureChunkCipherSuite.bytes("50515253c0c1c2c3c4c5c6c7")
+            expectedTag = SecureChunkCipherSuite.bytes("1ae10b594f09e26a7e902ecbd0600691")
+        }
+
+        let cipher = makeBackend(key: key)
+        var slot = [UInt8](repeating: 0, count: plaintext.count + SecureChunkedFile.nonceSize + SecureChunkedFile.tagSize)
+        var opened = [UInt8](repeating: 0, count: plaintext.count)
+        do {
+            try plaintext.withUnsafeBytes { input in
+                try slot.withUnsafeMutableBytes { output in
+                    try cipher.seal(input, authenticating: Data(associatedData), nonce: nonce, into: output)
+                }
+            }
+            guard Array(slot.suffix(SecureChunkedFile.tagSize)) == expectedTag else { return false }
+            try slot.withUnsafeBytes { input in
+                try opened.withUnsafeMutableBytes { output in
+                    try cipher.open(input, authenticating: Data(associatedData), into: output)
+                }
+            }
+        } catch {
+            return false
+        }
+        return opened == plaintext
+    }
+
+    private static func bytes(_ hex: String) -> [UInt8] {
+        var result: [UInt8] = []
+        var index = hex.startIndex
+        while index < hex.endIndex {
+            let next = hex.index(index, offsetBy: 2)
+            result.append(UInt8(hex[index..<next], radix: 16)!)
+            index = next
+        }
+        return result
+    }
+
+    private static func sysctlFlag(_ name: String) -> Bool {
+        var value: Int32 = 0
+        var size = MemoryLayout<Int32>.size
+        return sysctlbyname(name, &value, &size, nil, 0) == 0 && value != 0
+    }
+}
+
+/// Seals and opens one chunk slot laid out as nonce, ciphertext and 16 byte tag.
+///
+/// CryptoKit has no in-place or caller-buffer AEAD, so every call allocates: sealing returns the ciphertext in a new
+/// Data, and opening returns the plaintext in one, which is wiped as soon as it has been copied into `plaintext`.
+protocol SecureChunkCipher {
+    /// Encrypts `plaintext` into `slot` under a fresh random nonce, which is stored in the slot.
+    func seal(_ plaintext: UnsafeRawBufferPointer, authenticating associatedData: Data,
+              into slot: UnsafeMutableRawBufferPointer) throws
+
+    /// Authenticates and decrypts `slot` into `plaintext`.
+    func open(_ slot: UnsafeRawBufferPointer, authenticating associatedData: Data,
+              into plaintext: UnsafeMutableRawBufferPointer) throws
+}
+
+/// Backend that can also seal under a given nonce. Only the known-answer tests do, so the nonce of a real chunk is
+/// never in the hands of a caller.
+private protocol FixedNonceChunkCipher: SecureChunkCipher {
+    func seal(_ plaintext: UnsafeRawBufferPointer, authenticating associatedData: Data, nonce: [UInt8]?,
+              into slot: UnsafeMutableRawBufferPointer) throws
+}
+
+extension SecureChunkCipher {
+    fileprivate func store(nonce: ContiguousBytes, ciphertext: Data, tag: Data, into slot: UnsafeMutableRawBufferPointer) {
+        let ciphertextEnd = SecureChunkedFile.nonceSize + ciphertext.count
+        nonce.withUnsafeBytes {
+            UnsafeMutableRawBufferPointer(rebasing: slot[0..<SecureChunkedFile.nonceSize]).copyMemory(from: $0)
+        }
+        _ = ciphertext.copyBytes(to: UnsafeMutableRawBufferPointer(rebasing: slot[SecureChunkedFile.nonceSize..<ciphertextEnd]))
+        _ = tag.copyBytes(to: UnsafeMutableRawBufferPointer(rebasing: slot[ciphertextEnd...]))
+    }
+
+    fileprivate func split(_ slot: UnsafeRawBufferPointer)
+        -> (nonce: UnsafeRawBufferPointer, ciphertext: UnsafeRawBufferPointer, tag: UnsafeRawBufferPointer) {
+        let ciphertextEnd = slot.count - SecureChunkedFile.tagSize
+        return (UnsafeRawBufferPointer(rebasing: slot[0..<SecureChunkedFile.nonceSize]),
+                UnsafeRawBufferPointer(rebasing: slot[SecureChunkedFile.nonceSize..<ciphertextEnd]),
+                UnsafeRawBufferPointer(rebasing: slot[ciphertextEnd...]))
+    }
+}
+
+struct AESGCMChunkCipher: FixedNonceChunkCipher {
+    let key: SymmetricKey
+
+    func seal(_ plaintext: UnsafeRawBufferPointer, authenticating associatedData: Data,
+              into slot: UnsafeMutableRawBufferPointer) throws {
+        try seal(plaintext, authenticating: associatedData, nonce: nil, into: slot)
+    }
+
+    fileprivate func seal(_ plaintext: UnsafeRawBufferPointer, authenticating associatedData: Data, nonce: [UInt8]?,
+                          into slot: UnsafeMutableRawBufferPointer) throws {
+        let box = try AES.GCM.seal(plaintext, using: key, nonce: nonce.map { try AES.GCM.Nonce(data: $0) },
+                                   authenticating: associatedData)
+        store(nonce: box.nonce, ciphertext: box.ciphertext, tag: box.tag, into: slot)
+    }
+
+    func open(_ slot: UnsafeRawBufferPointer, authenticating associatedData: Data,
+              into plaintext: UnsafeMutableRawBufferPointer) throws {
+        let parts = split(slot)
+        let box = try AES.GCM.SealedBox(nonce: AES.GCM.Nonce(data: parts.nonce), ciphertext: parts.ciphertext,
+                                        tag: parts.tag)
+        var decrypted = try AES.GCM.open(box, using: key, authenticating: associatedData)
+        _ = decrypted.copyBytes(to: plaintext)
+        SecureBuffer.wipe(&decrypted)
+    }
+}
+
+struct ChaChaPolyChunkCipher: FixedNonceChunkCipher {
+    let key: SymmetricKey
+
+    func seal(_ plaintext: UnsafeRawBufferPointer, authenticating associatedData: Data,
+              into slot: UnsafeMutableRawBufferPointer) throws {
+        try seal(plaintext, authenticating: associatedData, nonce: nil, into: slot)
+    }
+
+    fileprivate func seal(_ plaintext: UnsafeRawBufferPointer, authenticating associatedData: Data, nonce: [UInt8]?,
+                          into slot: UnsafeMutableRawBufferPointer) throws {
+        let box = try ChaChaPoly.seal(plaintext, using: key, nonce: nonce.map { try ChaChaPoly.Nonce(data: $0) },
+                                      authenticating: associatedData)
+        store(nonce: box.nonce, ciphertext: box.ciphertext, tag: box.tag, into: slot)
+    }
+
+    func open(_ slot: UnsafeRawBufferPointer, authenticating associatedData: Data,
+              into plaintext: UnsafeMutableRawBufferPointer) throws {
+        let parts = split(slot)
+        let box = try ChaChaPoly.SealedBox(nonce: ChaChaPoly.Nonce(data: parts.nonce), ciphertext: parts.ciphertext,
+                                           tag: parts.tag)
+        var decrypted = try ChaChaPoly.open(box, using: key, authenticating: associatedData)
+        _ = decrypted.copyBytes(to: plaintext)
+        SecureBuffer.wipe(&decrypted)
+    }
+}
@@ -0,0 +1,82 @@
+//
+//  SecureChunkedFile+Attributes.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import CryptoKit
+
+/// Plaintext attributes of a secure chunked file, read from its authenticated header.
+struct SecureFileAttributes {
+    let size: UInt64
+    let modificationDate: Date
+    let chunkSize: Int
+    let cipherSuite: SecureChunkCipherSuite
+
+    /// The same keys -attributesOfSecureFileAtPath:error: reports for size and dates.
+    var fileAttributes: [FileAttributeKey: Any] {
+        return [.size: NSNumber(value: size), .modificationDate: modificationDate, .type: FileAttributeType.typeRegular]
+    }
+}
+
+extension SecureChunkedFile {
+    /// Counterpart of ACSecureLstat and -attributesOfSecureFileAtPath:error: that costs one `pread` of the header. No
+    /// chunk is read or decrypted; the header is still authenticated, so a tampered size is reported as corrupt data.
+    /// Symbolic links are not followed and fail with `ACErrorRegularFileOnly`.
+    static func attributes(atPath path: String, domain: SecureFileKeyDomain = .app,
+                           keyProvider: SecureFileKeyProvider = AppConnectKeyProvider.shared)
+        throws -> SecureFileAttributes {
+        return try attributes(atPath: path, keyEncryptionKey: keyProvider.keyEncryptionKey(for: domain))
+    }
+
+    /// Reads the attributes of every file in `paths` in parallel, deriving the domain key only once. Results are in
+    /// the order of `paths`; each file fails or succeeds on its own.
+    static func attributes(atPaths paths: [String], domain: SecureFileKeyDomain = .app,
+                           keyProvider: SecureFileKeyProvider = AppConnectKeyProvider.shared,
+                           maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount)
+        throws -> [Result<SecureFileAttributes, Error>] {
+        let keyEncryptionKey = try keyProvider.keyEncryptionKey(for: domain)
+        var results = [Result<SecureFileAttributes, Error>](repeating: .failure(SecureFileError.invalidArgument),
+                                                             count: paths.count)
+        let workers = max(1, min(maxConcurrency, paths.count))
+        let claim = NSLock()
+        var next = 0
+        results.withUnsafeMutableBufferPointer { output in
+            DispatchQueue.concurrentPerform(iterations: workers) { _ in
+                while true {
+                    claim.lock()
+                    let item = next
+                    next += 1
+                    claim.unlock()
+                    if item >= paths.count { return }
+                    output[item] = Result { try attributes(atPath: paths[item], keyEncryptionKey: keyEncryptionKey) }
+                }
+            }
+        }
+        return results
+    }
+
+    private static func attributes(atPath path: String, keyEncryptionKey: SymmetricKey) throws -> SecureFileAttributes {
+        let fd = Darwin.open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC)
+        guard fd >= 0 else {
+            throw errno == ELOOP ? SecureFileError.regularFileOnly : SecureFileError.posix()
+        }
+        defer { Darwin.close(fd) }
+        var info = stat()
+        guard fstat(fd, &info) == 0 else {
+            throw SecureFileError.posix()
+        }
+        guard info.st_mode & S_IFMT == S_IFREG else {
+            throw SecureFileError.regularFileOnly
+        }
+
+        let header = try readHeader(fd, keyEncryptionKey: keyEncryptionKey).header
+        let fallbackDate = Date(timeIntervalSince1970: Double(info.st_mtimespec.tv_sec) +
+            Double(info.st_mtimespec.tv_nsec) / 1e9)
+        return SecureFileAttributes(size: header.length, modificationDate: header.modificationDate ?? fallbackDate,
+                                    chunkSize: Int(header.chunkSize), cipherSuite: header.cipherSuite)
+    }
+}
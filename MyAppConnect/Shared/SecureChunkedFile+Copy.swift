@@ -0,0 +1,72 @@
+//
+//  SecureChunkedFile+Copy.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+
+extension SecureChunkedFile {
+    /// Copies the secure chunked file at `source` to the new file `destination`, which may be in another key domain,
+    /// for example when moving a file from the app key to an encryption group. Fails if `destination` exists.
+    ///
+    /// The copy gets a file identifier and file key of its own, wrapped only for `destinationDomain`, so its slots
+    /// cannot be swapped with the source's and the source's key is never handed to another domain. That means every
+    /// chunk is decrypted and sealed again; chunks are streamed a batch at a time through a `SecureBuffer` and sealed
+    /// on all cores, and runs of zeros stay holes. The copy is made durable before this returns.
+    static func copy(atPath source: String, toPath destination: String,
+                     from sourceDomain: SecureFileKeyDomain = .app, to destinationDomain: SecureFileKeyDomain = .app,
+                     keyProvider: SecureFileKeyProvider = AppConnectKeyProvider.shared) throws {
+        // Open the source first, so that a wrong domain or a corrupt header never leaves a destination behind. Every
+        // chunk is then read through the descriptor whose header was authenticated.
+        let input = try SecureChunkedFile(path: source, flags: O_RDONLY, domain: sourceDomain, keyProvider: keyProvider,
+                                          cacheBudget: 0)
+        defer { input.close() }
+        let output = try SecureChunkedFile(path: destination, flags: O_RDWR | O_CREAT | O_EXCL,
+                                           domain: destinationDomain, keyProvider: keyProvider,
+                                           chunkSize: input.chunkSize, cacheBudget: 0)
+        defer { output.close() }
+
+        do {
+            try copyChunks(from: input, to: output)
+            try output.synchronize()
+        } catch {
+            output.close()
+            Darwin.unlink(destination)
+            throw error
+        }
+    }
+
+    private static func copyChunks(from input: SecureChunkedFile, to output: SecureChunkedFile) throws {
+        let length = input.length
+        let chunkSize = input.chunkSize
+        let batch = try SecureBuffer(count: max(1, parallelBatchSize / chunkSize) * chunkSize)
+        defer { batch.wipe() }
+        var offset: UInt64 = 0
+        while offset < length {
+            let count = try input.read(into: batch.bytes, at: offset)
+            guard count > 0 else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            // Write each run of chunks that are not all zeros; the chunks between runs are left as holes. The empty
+            // chunk at `count` ends the last run.
+            var runStart: Int?
+            for start in Array(stride(from: 0, to: count, by: chunkSize)) + [count] {
+                let chunk = UnsafeRawBufferPointer(rebasing: batch.bytes[start..<min(start + chunkSize, count)])
+                let isZero = !chunk.contains { $0 != 0 }
+                if !isZero, runStart == nil {
+                    runStart = start
+                } else if isZero, let first = runStart {
+                    try output.write(UnsafeRawBufferPointer(rebasing: batch.bytes[first..<start]),
+                                     at: offset + UInt64(first))
+                    runStart = nil
+                }
+            }
+            offset += UInt64(count)
+        }
+        // A trailing run of zeros was skipped above; growing the length turns it into a hole.
+        try output.truncate(to: length)
+    }
+}
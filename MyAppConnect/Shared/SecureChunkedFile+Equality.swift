@@ -0,0 +1,55 @@
+//
+//  SecureChunkedFile+Equality.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+
+extension SecureChunkedFile {
+    static let defaultCompareBufferSize = 256 * 1024
+
+    /// Counterpart of -secureContentsEqualAtPath:andPath:error: for secure chunked files.
+    ///
+    /// Different lengths, or stored content digests of the same domain, decide the answer from the two headers alone.
+    /// Otherwise both files are decrypted side by side, `bufferSize` bytes at a time, and the comparison stops at the
+    /// first difference.
+    static func contentsEqual(atPath path1: String, andPath path2: String,
+                              domains: (SecureFileKeyDomain, SecureFileKeyDomain) = (.app, .app),
+                              keyProvider: SecureFileKeyProvider = AppConnectKeyProvider.shared,
+                              bufferSize: Int = SecureChunkedFile.defaultCompareBufferSize) throws -> Bool {
+        guard bufferSize > 0 else {
+            throw SecureFileError.invalidArgument
+        }
+        let first = try SecureChunkedFile(path: path1, flags: O_RDONLY, domain: domains.0, keyProvider: keyProvider,
+                                          cacheBudget: 0)
+        defer { first.close() }
+        let second = try SecureChunkedFile(path: path2, flags: O_RDONLY, domain: domains.1, keyProvider: keyProvider,
+                                           cacheBudget: 0)
+        defer { second.close() }
+
+        let length = first.length
+        guard length == second.length else { return false }
+        if domains.0 == domains.1, let digest1 = first.storedContentDigest, let digest2 = second.storedContentDigest {
+            return SecureMemory.constantTimeEqual(digest1, digest2)
+        }
+
+        let buffer1 = try SecureBuffer(count: bufferSize)
+        let buffer2 = try SecureBuffer(count: bufferSize)
+        var offset: UInt64 = 0
+        while offset < length {
+            let count1 = try first.read(into: buffer1.bytes, at: offset)
+            let count2 = try second.read(into: buffer2.bytes, at: offset)
+            guard count1 == count2, count1 > 0 else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            guard memcmp(buffer1.pointer, buffer2.pointer, count1) == 0 else {
+                return false
+            }
+            offset += UInt64(count1)
+        }
+        return true
+    }
+}
@@ -0,0 +1,782 @@
+//
+//  SecureChunkedFile.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import CryptoKit
+import AppConnect
+
+/// Random-access encrypted file made of fixed-size, independently encrypted and authenticated chunks.
+///
+/// After the `SecureChunkedFileHeader`, chunk `i` lives in a fixed slot holding a 12 byte nonce, `chunkSize` bytes of
+/// ciphertext and a 16 byte tag, sealed with the file's `SecureChunkCipherSuite`. The chunk index and the file
+/// identifier are authenticated with every chunk, so slots cannot be swapped within or between files. A write only
+/// re-encrypts the chunks it overlaps, and a read only decrypts the chunks that overlap the requested range.
+/// Plaintext past the logical length is always zero. Chunks skipped over when the file grows are holes: they are
+/// recorded in the authenticated header, their slots are left sparse on disk, and they read back as zeros. Any other
+/// slot must authenticate, so zeroing it on disk is detected like any other tampering.
+///
+/// Each file has a random file key, wrapped by the key-encryption key of its `SecureFileKeyDomain`.
+final class SecureChunkedFile {
+    static let defaultChunkSize = 16 * 1024
+    static let defaultCacheBudget = 8 * defaultChunkSize
+    static let defaultParallelThreshold = 1024 * 1024
+    static let parallelBatchSize = 4 * 1024 * 1024
+
+    static let nonceSize = 12
+    static let tagSize = 16
+
+    let path: String
+    let domain: SecureFileKeyDomain
+    let chunkSize: Int
+    let slotSize: Int
+
+    /// Writes of at least this many bytes encrypt their whole chunks on up to `maxConcurrency` threads.
+    var parallelThreshold = SecureChunkedFile.defaultParallelThreshold
+    var maxConcurrency = ProcessInfo.processInfo.activeProcessorCount
+
+    private var fd: Int32
+    private var header: SecureChunkedFileHeader
+    private let cipher: SecureChunkCipher
+    private let headerKey: SymmetricKey
+    private let digestKey: SymmetricKey
+    private let isWritable: Bool
+    private let plaintext: SecureBuffer
+    private let slot: UnsafeMutableRawBufferPointer
+    private let cache: SecureChunkCache
+    private var position: UInt64 = 0
+    private var headerIsDirty = false
+    private let lock = NSLock()
+
+    /// Opens the secure chunked file at `path`, creating it when `flags` contains `O_CREAT` and the file is empty.
+    /// Up to `cacheBudget` bytes of decrypted chunks are kept for repeated reads; pass 0 to disable the cache.
+    init(path: String, flags: Int32 = O_RDWR | O_CREAT, domain: SecureFileKeyDomain = .app,
+         keyProvider: SecureFileKeyProvider = AppConnectKeyProvider.shared,
+         chunkSize: Int = SecureChunkedFile.defaultChunkSize,
+         cacheBudget: Int = SecureChunkedFile.defaultCacheBudget) throws {
+        guard chunkSize > 0, chunkSize % 16 == 0, cacheBudget >= 0, flags & O_APPEND == 0 else {
+            throw SecureFileError.invalidArgument
+        }
+        let keyEncryptionKey = try keyProvider.keyEncryptionKey(for: domain)
+
+        let fd = Darwin.open(path, flags | O_CLOEXEC, 0o600)
+        guard fd >= 0 else {
+            throw SecureFileError.posix()
+        }
+        var info = stat()
+        guard fstat(fd, &info) == 0 else {
+            let error = SecureFileError.posix()
+            Darwin.close(fd)
+            throw error
+        }
+        guard info.st_mode & S_IFMT == S_IFREG else {
+            Darwin.close(fd)
+            throw SecureFileError.regularFileOnly
+        }
+
+        let header: SecureChunkedFileHeader
+        let fileKey: SymmetricKey
+        let cipher: SecureChunkCipher
+        let plaintext: SecureBuffer
+        let isNew = info.st_size == 0 && flags & O_ACCMODE != O_RDONLY
+        do {
+            if isNew {
+                guard let cipherSuite = SecureChunkCipherSuite.preferred else {
+                    throw SecureFileError.appConnect(ACErrorInternal)
+                }
+                let fileIdentifier = SymmetricKey(size: .bits128).withUnsafeBytes { Data($0) }
+                fileKey = SymmetricKey(size: .bits256)
+                let wrappedKey = try SecureChunkedFile.wrap(fileKey, fileIdentifier: fileIdentifier,
+                                                            keyEncryptionKey: keyEncryptionKey)
+                var created = SecureChunkedFileHeader(chunkSize: UInt32(chunkSize), cipherSuite: cipherSuite,
+                                                      fileIdentifier: fileIdentifier, wrappedKey: wrappedKey)
+                created.modificationDate = Date()
+                header = created
+            } else {
+                let loaded = try SecureChunkedFile.readHeader(fd, keyEncryptionKey: keyEncryptionKey)
+                header = loaded.header
+                fileKey = loaded.fileKey
+            }
+            cipher = try header.cipherSuite.makeCipher(
+                key: SecureKeyDerivation.deriveKey(from: fileKey, salt: header.fileIdentifier, info: "chunk"))
+            plaintext = try SecureBuffer(count: Int(header.chunkSize))
+        } catch let error as NSError where error.domain == ACErrorDomain || error.domain == NSPOSIXErrorDomain {
+            Darwin.close(fd)
+            throw error
+        } catch {
+            Darwin.close(fd)
+            throw SecureFileError.badKeyOrCorruptData
+        }
+
+        self.path = path
+        self.domain = domain
+        self.fd = fd
+        self.header = header
+        self.chunkSize = Int(header.chunkSize)
+        slotSize = Int(header.chunkSize) + SecureChunkedFile.nonceSize + SecureChunkedFile.tagSize
+        self.cipher = cipher
+        headerKey = SecureChunkedFile.headerKey(for: fileKey, fileIdentifier: header.fileIdentifier)
+        digestKey = SecureChunkedFile.digestKey(for: keyEncryptionKey)
+        isWritable = flags & O_ACCMODE != O_RDONLY
+        self.plaintext = plaintext
+        slot = UnsafeMutableRawBufferPointer.allocate(byteCount: slotSize, alignment: 16)
+        cache = SecureChunkCache(chunkSize: Int(header.chunkSize), byteBudget: cacheBudget)
+
+        if isNew {
+            try writeHeader()
+        }
+    }
+
+    deinit {
+        close()
+        slot.deallocate()
+    }
+
+    /// Logical plaintext length of the file.
+    var length: UInt64 {
+        lock.lock()
+        defer { lock.unlock() }
+        return header.length
+    }
+
+    /// Time of the last write or truncate, kept in the header so it can be read without decrypting anything.
+    var modificationDate: Date? {
+        lock.lock()
+        defer { lock.unlock() }
+        return header.modificationDate
+    }
+
+    /// The content digest recorded in the header, if the file has not changed since it was computed.
+    var storedContentDigest: Data? {
+        lock.lock()
+        defer { lock.unlock() }
+        return header.contentDigest
+    }
+
+    /// Chunk ranges recorded as holes in the header.
+    var holes: [Range<UInt64>] {
+        lock.lock()
+        defer { lock.unlock() }
+        return header.holes
+    }
+
+    var cacheStatistics: SecureChunkCache.Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return cache.statistics
+    }
+
+    // MARK: Reading
+
+    /// Reads up to `buffer.count` bytes at `offset`, decrypting only the chunks that overlap the range.
+    /// Returns the number of bytes read, which is short only at the end of the file.
+    func read(into buffer: UnsafeMutableRawBufferPointer, at offset: UInt64) throws -> Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return try SecureChunkedFile.withCursor(buffer.baseAddress, buffer.count) { try performRead(into: &$0, at: offset) }
+    }
+
+    /// Reads at the current position and advances it, like ACSecureFileRead.
+    func read(into buffer: UnsafeMutableRawBufferPointer) throws -> Int {
+        lock.lock()
+        defer { lock.unlock() }
+        let count = try SecureChunkedFile.withCursor(buffer.baseAddress, buffer.count) {
+            try performRead(into: &$0, at: position)
+        }
+        position += UInt64(count)
+        return count
+    }
+
+    /// Scatters the plaintext at `offset` straight into the caller's vectors.
+    func read(into vectors: UnsafeBufferPointer<iovec>, at offset: UInt64) throws -> Int {
+        lock.lock()
+        defer { lock.unlock() }
+        var cursor = SecureIOVecCursor(vectors)
+        return try performRead(into: &cursor, at: offset)
+    }
+
+    /// Reads at the current position into `vectors` and advances it, like ACSecureFileReadv.
+    func read(into vectors: UnsafeBufferPointer<iovec>) throws -> Int {
+        lock.lock()
+        defer { lock.unlock() }
+        var cursor = SecureIOVecCursor(vectors)
+        let count = try performRead(into: &cursor, at: position)
+        position += UInt64(count)
+        return count
+    }
+
+    func read(length: Int, at offset: UInt64) throws -> Data {
+        var data = Data(count: length)
+        let count = try data.withUnsafeMutableBytes { try read(into: $0, at: offset) }
+        data.count = count
+        return data
+    }
+
+    /// Moves the current position like ACSecureFileLseek; `whence` is SEEK_SET, SEEK_CUR or SEEK_END.
+    @discardableResult
+    func seek(to offset: Int64, whence: Int32 = SEEK_SET) throws -> UInt64 {
+        lock.lock()
+        defer { lock.unlock() }
+        try ensureOpen()
+        let base: Int64
+        switch whence {
+        case SEEK_SET:
+            base = 0
+        case SEEK_CUR:
+            base = Int64(position)
+        case SEEK_END:
+            base = Int64(header.length)
+        default:
+            throw SecureFileError.posix(EINVAL)
+        }
+        let (target, overflow) = base.addingReportingOverflow(offset)
+        guard !overflow else {
+            throw SecureFileError.posix(offset > 0 ? EOVERFLOW : EINVAL)
+        }
+        guard target >= 0 else {
+            throw SecureFileError.posix(EINVAL)
+        }
+        position = UInt64(target)
+        return position
+    }
+
+    /// Whole chunks that land inside a single destination vector are decrypted straight into it; only chunks that
+    /// straddle vectors or are read partially go through the internal plaintext buffer. Either way CryptoKit first
+    /// returns each chunk in a Data of its own, which `SecureChunkCipher.open` wipes once it has been copied out.
+    private func performRead(into cursor: inout SecureIOVecCursor, at offset: UInt64) throws -> Int {
+        try ensureOpen()
+        guard offset < header.length, cursor.remaining > 0 else { return 0 }
+
+        let count = Int(min(UInt64(cursor.remaining), header.length - offset))
+        var done = 0
+        while done < count {
+            let position = offset + UInt64(done)
+            let index = position / UInt64(chunkSize)
+            let within = Int(position % UInt64(chunkSize))
+            let span = min(chunkSize - within, count - done)
+            if span == chunkSize, let destination = cursor.contiguous(span) {
+                if let cached = cache.lookup(index) {
+                    destination.copyMemory(from: cached)
+                } else {
+                    try decryptChunk(index, into: destination)
+                    cache.insert(index, plaintext: UnsafeRawBufferPointer(destination))
+                }
+                cursor.advance(by: span)
+            } else {
+                let chunk = try loadChunk(index)
+                cursor.scatter(from: UnsafeRawBufferPointer(rebasing: chunk[within..<(within + span)]))
+            }
+            done += span
+        }
+        plaintext.wipe()
+        return count
+    }
+
+    // MARK: Writing
+
+    /// Writes `buffer` at `offset`, re-encrypting only the chunks the range overlaps. Writing past the end of the
+    /// file extends it; any gap reads back as zeros.
+    func write(_ buffer: UnsafeRawBufferPointer, at offset: UInt64) throws {
+        lock.lock()
+        defer { lock.unlock() }
+        try SecureChunkedFile.withCursor(buffer.baseAddress, buffer.count) { try performWrite(&$0, at: offset) }
+    }
+
+    /// Writes at the current position and advances it, like ACSecureFileWrite.
+    func write(_ buffer: UnsafeRawBufferPointer) throws {
+        lock.lock()
+        defer { lock.unlock() }
+        try SecureChunkedFile.withCursor(buffer.baseAddress, buffer.count) { try performWrite(&$0, at: position) }
+        position += UInt64(buffer.count)
+    }
+
+    /// Gathers the plaintext to write at `offset` straight from the caller's vectors.
+    func write(_ vectors: UnsafeBufferPointer<iovec>, at offset: UInt64) throws {
+        lock.lock()
+        defer { lock.unlock() }
+        var cursor = SecureIOVecCursor(vectors)
+        try performWrite(&cursor, at: offset)
+    }
+
+    /// Writes `vectors` at the current position and advances it, like ACSecureFileWritev.
+    func write(_ vectors: UnsafeBufferPointer<iovec>) throws {
+        lock.lock()
+        defer { lock.unlock() }
+        var cursor = SecureIOVecCursor(vectors)
+        let count = cursor.remaining
+        try performWrite(&cursor, at: position)
+        position += UInt64(count)
+    }
+
+    func write(_ data: Data, at offset: UInt64) throws {
+        try data.withUnsafeBytes { try write($0, at: offset) }
+    }
+
+    /// Replaces the contents of the secure chunked file at `path` with `data`, like -writeToSecureFile:options:error:.
+    static func write(_ data: Data, toPath path: String, domain: SecureFileKeyDomain = .app,
+                      keyProvider: SecureFileKeyProvider = AppConnectKeyProvider.shared) throws {
+        let file = try SecureChunkedFile(path: path, flags: O_RDWR | O_CREAT | O_TRUNC, domain: domain,
+                                         keyProvider: keyProvider)
+        defer { file.close() }
+        try file.write(data, at: 0)
+        try file.recordContentDigest(of: data)
+        try file.synchronize()
+    }
+
+    /// Whole chunks that lie inside a single source vector are sealed straight from it; only chunks that straddle
+    /// vectors or are written partially are assembled in the internal plaintext buffer.
+    private func performWrite(_ cursor: inout SecureIOVecCursor, at offset: UInt64) throws {
+        try ensureOpen()
+        let total = cursor.remaining
+        guard total > 0 else { return }
+        try checkLength(offset, adding: UInt64(total))
+
+        try invalidateContentDigest()
+        let firstChunk = offset / UInt64(chunkSize)
+        if firstChunk > chunkCount(for: header.length) {
+            // The chunks skipped over become a hole; pwrite extends the file past their slots.
+            try discardStaleSlots()
+            try addHole(chunkCount(for: header.length)..<firstChunk)
+        }
+        let parallel = total >= parallelThreshold && maxConcurrency > 1
+        var done = 0
+        while done < total {
+            let position = offset + UInt64(done)
+            let index = position / UInt64(chunkSize)
+            let within = Int(position % UInt64(chunkSize))
+            let span = min(chunkSize - within, total - done)
+            let wholeChunks = (total - done) / chunkSize
+            if parallel && within == 0 && wholeChunks > 1, let run = cursor.contiguous(wholeChunks * chunkSize) {
+                try encryptChunksInParallel(UnsafeRawBufferPointer(run), from: index)
+                cursor.advance(by: run.count)
+                done += run.count
+                continue
+            }
+            if span == chunkSize, let run = cursor.contiguous(span) {
+                try encryptChunk(index, from: UnsafeRawBufferPointer(run))
+                cache.update(index, plaintext: UnsafeRawBufferPointer(run))
+                cursor.advance(by: span)
+                done += span
+                continue
+            }
+            if span < chunkSize {
+                let chunk = try loadChunk(index)
+                if chunk.baseAddress != UnsafeRawPointer(plaintext.pointer) {
+                    plaintext.bytes.copyMemory(from: chunk)
+                }
+            }
+            cursor.gather(into: UnsafeMutableRawBufferPointer(rebasing: plaintext.bytes[within..<(within + span)]))
+            try encryptChunk(index, from: UnsafeRawBufferPointer(plaintext.bytes))
+            cache.update(index, plaintext: UnsafeRawBufferPointer(plaintext.bytes))
+            done += span
+        }
+        plaintext.wipe()
+
+        let end = offset + UInt64(total)
+        // Every slot the write covered has been sealed, so the header may stop calling it a hole.
+        try fillHoles(firstChunk..<chunkCount(for: end))
+        header.modificationDate = Date()
+        if end > header.length {
+            header.length = end
+            try writeHeader()
+        } else {
+            headerIsDirty = true
+        }
+    }
+
+    /// Changes the logical length, touching at most one chunk. Shrinking re-encrypts only the new boundary chunk;
+    /// growing only records the new chunks as a hole in the header and extends the file, so they read back as zeros
+    /// and take no space on disk.
+    ///
+    /// A shrunk header is made durable before the slots past it are cut off, so a crash in between leaves surplus
+    /// slots rather than a length that promises chunks the file no longer has.
+    func truncate(to newLength: UInt64) throws {
+        lock.lock()
+        defer { lock.unlock() }
+        try ensureOpen()
+        guard newLength != header.length else { return }
+        try checkLength(newLength, adding: 0)
+
+        try invalidateContentDigest()
+        if newLength < header.length {
+            cache.remove(from: newLength / UInt64(chunkSize))
+            let within = Int(newLength % UInt64(chunkSize))
+            let index = newLength / UInt64(chunkSize)
+            if within != 0 && !isHole(index) {
+                try decryptChunk(index, into: plaintext.bytes)
+                SecureBuffer.wipe(UnsafeMutableRawBufferPointer(rebasing: plaintext.bytes[within...]))
+                try encryptChunk(index, from: UnsafeRawBufferPointer(plaintext.bytes))
+                plaintext.wipe()
+            }
+            header.holes = header.holes.map { $0.clamped(to: 0..<chunkCount(for: newLength)) }.filter { !$0.isEmpty }
+            header.length = newLength
+            header.modificationDate = Date()
+            try writeHeader()
+            guard fsync(fd) == 0, ftruncate(fd, slotOffset(chunkCount(for: newLength))) == 0 else {
+                throw SecureFileError.posix()
+            }
+            return
+        }
+        if chunkCount(for: newLength) > chunkCount(for: header.length) {
+            try discardStaleSlots()
+            try addHole(chunkCount(for: header.length)..<chunkCount(for: newLength))
+            guard ftruncate(fd, slotOffset(chunkCount(for: newLength))) == 0 else {
+                throw SecureFileError.posix()
+            }
+        }
+        header.length = newLength
+        header.modificationDate = Date()
+        try writeHeader()
+    }
+
+    /// Writes a pending header update, such as the modification time of in-place writes, and flushes the file.
+    func synchronize() throws {
+        lock.lock()
+        defer { lock.unlock() }
+        try ensureOpen()
+        if headerIsDirty {
+            try writeHeader()
+        }
+        guard fsync(fd) == 0 else {
+            throw SecureFileError.posix()
+        }
+    }
+
+    func close() {
+        lock.lock()
+        defer { lock.unlock() }
+        guard fd >= 0 else { return }
+        if headerIsDirty {
+            try? writeHeader()
+        }
+        Darwin.close(fd)
+        fd = -1
+        plaintext.wipe()
+        cache.removeAll()
+    }
+
+    // MARK: Content digest
+
+    /// HMAC-SHA256 of the plaintext length and plaintext under a key derived from the domain's key-encryption key.
+    ///
+    /// Files of the same domain with equal contents have equal digests whatever their file keys, so
+    /// `contentsEqual(atPath:andPath:)` can compare two headers instead of decrypting both files. The digest is
+    /// computed on first use and kept in the header until the next write or truncate.
+    func contentDigest() throws -> Data {
+        lock.lock()
+        defer { lock.unlock() }
+        try ensureOpen()
+        if let digest = header.contentDigest {
+            return digest
+        }
+
+        var hmac = HMAC<SHA256>(key: digestKey)
+        withUnsafeBytes(of: header.length.littleEndian) { hmac.update(bufferPointer: $0) }
+        for index in 0..<chunkCount(for: header.length) {
+            let start = index * UInt64(chunkSize)
+            let count = Int(min(UInt64(chunkSize), header.length - start))
+            try decryptChunk(index, into: plaintext.bytes)
+            hmac.update(bufferPointer: UnsafeRawBufferPointer(rebasing: plaintext.bytes[0..<count]))
+        }
+        plaintext.wipe()
+        let digest = Data(hmac.finalize())
+        if isWritable {
+            header.contentDigest = digest
+            try writeHeader()
+        }
+        return digest
+    }
+
+    /// Records the digest of `data`, which the caller has just written as the whole file.
+    private func recordContentDigest(of data: Data) throws {
+        lock.lock()
+        defer { lock.unlock() }
+        try ensureOpen()
+        guard UInt64(data.count) == header.length else { return }
+
+        var hmac = HMAC<SHA256>(key: digestKey)
+        withUnsafeBytes(of: header.length.littleEndian) { hmac.update(bufferPointer: $0) }
+        hmac.update(data: data)
+        header.contentDigest = Data(hmac.finalize())
+        try writeHeader()
+    }
+
+    /// Clears the digest before the contents change, so a crash mid-write can never leave a stale digest behind.
+    private func invalidateContentDigest() throws {
+        guard header.contentDigest != nil else { return }
+        header.contentDigest = nil
+        try writeHeader()
+    }
+
+    // MARK: Chunks
+
+    private func ensureOpen() throws {
+        guard fd >= 0 else {
+            throw SecureFileError.posix(EBADF)
+        }
+    }
+
+    private func chunkCount(for length: UInt64) -> UInt64 {
+        return length / UInt64(chunkSize) + (length % UInt64(chunkSize) == 0 ? 0 : 1)
+    }
+
+    /// Fails with EFBIG unless a file `offset + count` bytes long still has every slot offset inside off_t.
+    private func checkLength(_ offset: UInt64, adding count: UInt64) throws {
+        let (end, overflow) = offset.addingReportingOverflow(count)
+        let maxChunks = UInt64(off_t.max - off_t(SecureChunkedFileHeader.size)) / UInt64(slotSize)
+        guard !overflow, chunkCount(for: end) <= maxChunks else {
+            throw SecureFileError.posix(EFBIG)
+        }
+    }
+
+    private func slotOffset(_ index: UInt64) -> off_t {
+        return off_t(SecureChunkedFileHeader.size) + off_t(index) * off_t(slotSize)
+    }
+
+    private func associatedData(_ index: UInt64) -> Data {
+        var data = header.fileIdentifier
+        withUnsafeBytes(of: index.littleEndian) { data.append(contentsOf: $0) }
+        return data
+    }
+
+    /// Returns the plaintext of chunk `index`, either from the cache or decrypted into `plaintext`.
+    private func loadChunk(_ index: UInt64) throws -> UnsafeRawBufferPointer {
+        if let cached = cache.lookup(index) {
+            return cached
+        }
+        try decryptChunk(index, into: plaintext.bytes)
+        let chunk = UnsafeRawBufferPointer(plaintext.bytes)
+        cache.insert(index, plaintext: chunk)
+        return chunk
+    }
+
+    /// Decrypts chunk `index` into `destination`. Chunks past the logical length, and recorded holes, read as zeros
+    /// without touching their slots; a missing slot inside the length means the file was cut short.
+    private func decryptChunk(_ index: UInt64, into destination: UnsafeMutableRawBufferPointer) throws {
+        guard index < chunkCount(for: header.length), !isHole(index) else {
+            SecureBuffer.wipe(destination)
+            return
+        }
+        let count = try SecureChunkedFile.readFully(fd, into: slot, at: slotOffset(index))
+        guard count == slotSize else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        do {
+            try cipher.open(UnsafeRawBufferPointer(slot), authenticating: associatedData(index), into: destination)
+        } catch {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+    }
+
+    /// Encrypts one chunk of `source` with a fresh nonce and writes it to the slot of chunk `index`.
+    private func encryptChunk(_ index: UInt64, from source: UnsafeRawBufferPointer) throws {
+        do {
+            try cipher.seal(source, authenticating: associatedData(index), into: slot)
+        } catch {
+            throw SecureFileError.appConnect(ACErrorInternal)
+        }
+        try SecureChunkedFile.writeFully(fd, UnsafeRawBufferPointer(slot), at: slotOffset(index))
+    }
+
+    /// Seals the whole chunks in `chunks` concurrently, then writes their slots in order, one batch at a time.
+    /// Workers claim chunks one by one, so a slow chunk never holds up the others.
+    private func encryptChunksInParallel(_ chunks: UnsafeRawBufferPointer, from firstIndex: UInt64) throws {
+        let count = chunks.count / chunkSize
+        let batchChunks = max(1, SecureChunkedFile.parallelBatchSize / slotSize)
+        let output = UnsafeMutableRawBufferPointer.allocate(byteCount: min(count, batchChunks) * slotSize, alignment: 16)
+        defer { output.deallocate() }
+
+        var batchStart = 0
+        while batchStart < count {
+            let batchCount = min(batchChunks, count - batchStart)
+            let claim = NSLock()
+            var next = 0
+            var failed = false
+            DispatchQueue.concurrentPerform(iterations: min(maxConcurrency, batchCount)) { _ in
+                while true {
+                    claim.lock()
+                    let item = next
+                    next += 1
+                    let stop = failed || item >= batchCount
+                    claim.unlock()
+                    if stop { return }
+
+                    let chunk = batchStart + item
+                    let plaintext = UnsafeRawBufferPointer(rebasing: chunks[(chunk * chunkSize)..<((chunk + 1) * chunkSize)])
+                    let slot = UnsafeMutableRawBufferPointer(rebasing: output[(item * slotSize)..<((item + 1) * slotSize)])
+                    do {
+                        try cipher.seal(plaintext, authenticating: associatedData(firstIndex + UInt64(chunk)), into: slot)
+                    } catch {
+                        claim.lock()
+                        failed = true
+                        claim.unlock()
+                    }
+                }
+            }
+            guard !failed else {
+                throw SecureFileError.appConnect(ACErrorInternal)
+            }
+
+            let batchIndex = firstIndex + UInt64(batchStart)
+            try SecureChunkedFile.writeFully(fd, UnsafeRawBufferPointer(rebasing: output[0..<(batchCount * slotSize)]),
+                                             at: slotOffset(batchIndex))
+            for item in 0..<batchCount {
+                let chunk = batchStart + item
+                cache.update(batchIndex + UInt64(item),
+                             plaintext: UnsafeRawBufferPointer(rebasing: chunks[(chunk * chunkSize)..<((chunk + 1) * chunkSize)]))
+            }
+            batchStart += batchCount
+        }
+    }
+
+    // MARK: Holes
+
+    private func isHole(_ index: UInt64) -> Bool {
+        return header.holes.contains { $0.contains(index) }
+    }
+
+    /// Records `chunks`, which lie past every chunk of the file, as a hole.
+    private func addHole(_ chunks: Range<UInt64>) throws {
+        guard !chunks.isEmpty else { return }
+        if let last = header.holes.last, last.upperBound == chunks.lowerBound {
+            header.holes[header.holes.count - 1] = last.lowerBound..<chunks.upperBound
+        } else {
+            header.holes.append(chunks)
+        }
+        try sealExcessHoles()
+    }
+
+    /// Drops `chunks`, whose slots have just been sealed, from the holes. Splitting a hole can exceed the header's
+    /// capacity, see `sealExcessHoles()`.
+    private func fillHoles(_ chunks: Range<UInt64>) throws {
+        guard header.holes.contains(where: { $0.overlaps(chunks) }) else { return }
+        header.holes = header.holes.flatMap { hole -> [Range<UInt64>] in
+            guard hole.overlaps(chunks) else { return [hole] }
+            return [hole.clamped(to: 0..<chunks.lowerBound), hole.clamped(to: chunks.upperBound..<UInt64.max)]
+                .filter { !$0.isEmpty }
+        }
+        headerIsDirty = true
+        try sealExcessHoles()
+    }
+
+    /// Seals zero chunks into the slots of the smallest holes until the header can record the rest. The slots are
+    /// written before the header stops listing the hole, so a crash in between still reads zeros.
+    private func sealExcessHoles() throws {
+        while header.holes.count > SecureChunkedFileHeader.maxHoles,
+            let smallest = header.holes.indices.min(by: { header.holes[$0].count < header.holes[$1].count }) {
+            plaintext.wipe()
+            for index in header.holes[smallest] {
+                try encryptChunk(index, from: UnsafeRawBufferPointer(plaintext.bytes))
+            }
+            header.holes.remove(at: smallest)
+            headerIsDirty = true
+        }
+    }
+
+    /// Cuts off slots past the logical length, which a crash during a shrinking truncate can leave behind, so that
+    /// growing the file exposes zeros rather than old chunks.
+    private func discardStaleSlots() throws {
+        var info = stat()
+        let end = slotOffset(chunkCount(for: header.length))
+        guard fstat(fd, &info) == 0 else {
+            throw SecureFileError.posix()
+        }
+        guard info.st_size <= end || ftruncate(fd, end) == 0 else {
+            throw SecureFileError.posix()
+        }
+    }
+
+    private static func withCursor<R>(_ base: UnsafeRawPointer?, _ count: Int,
+                                      _ body: (inout SecureIOVecCursor) throws -> R) rethrows -> R {
+        var vector = iovec(iov_base: UnsafeMutableRawPointer(mutating: base), iov_len: count)
+        return try withUnsafePointer(to: &vector) { pointer in
+            var cursor = SecureIOVecCursor(UnsafeBufferPointer(start: pointer, count: 1))
+            return try body(&cursor)
+        }
+    }
+
+    private func writeHeader() throws {
+        let bytes = header.encoded(macKey: headerKey)
+        try bytes.withUnsafeBytes { try SecureChunkedFile.writeFully(fd, $0, at: 0) }
+        headerIsDirty = false
+    }
+
+    // MARK: Keys
+
+    /// Reads the header of `fd`, unwraps the file key with `keyEncryptionKey` and authenticates the header with it.
+    static func readHeader(_ fd: Int32, keyEncryptionKey: SymmetricKey) throws
+        -> (header: SecureChunkedFileHeader, fileKey: SymmetricKey) {
+        var bytes = [UInt8](repeating: 0, count: SecureChunkedFileHeader.size)
+        let count = try bytes.withUnsafeMutableBytes { try readFully(fd, into: $0, at: 0) }
+        let header = try bytes.withUnsafeBytes {
+            try SecureChunkedFileHeader(decoding: UnsafeRawBufferPointer(rebasing: $0[0..<count]))
+        }
+        let fileKey: SymmetricKey
+        do {
+            var unwrapped = try AES.GCM.open(AES.GCM.SealedBox(combined: header.wrappedKey),
+                                             using: keyEncryptionKey, authenticating: header.fileIdentifier)
+            fileKey = SymmetricKey(data: unwrapped)
+            SecureBuffer.wipe(&unwrapped)
+        } catch {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        let macKey = headerKey(for: fileKey, fileIdentifier: header.fileIdentifier)
+        guard bytes.withUnsafeBytes({ SecureChunkedFileHeader.isAuthentic($0, macKey: macKey) }) else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        return (header, fileKey)
+    }
+
+    /// Wraps `fileKey` for the header; the file identifier is authenticated so a wrapped key cannot be moved.
+    static func wrap(_ fileKey: SymmetricKey, fileIdentifier: Data, keyEncryptionKey: SymmetricKey) throws -> Data {
+        do {
+            let box = try fileKey.withUnsafeBytes {
+                try AES.GCM.seal($0, using: keyEncryptionKey, authenticating: fileIdentifier)
+            }
+            return box.combined!
+        } catch {
+            throw SecureFileError.appConnect(ACErrorInternal)
+        }
+    }
+
+    static func headerKey(for fileKey: SymmetricKey, fileIdentifier: Data) -> SymmetricKey {
+        return SecureKeyDerivation.deriveKey(from: fileKey, salt: fileIdentifier, info: "header")
+    }
+
+    static func digestKey(for keyEncryptionKey: SymmetricKey) -> SymmetricKey {
+        return SecureKeyDerivation.deriveKey(from: keyEncryptionKey, salt: Data(), info: "content-digest")
+    }
+
+    // MARK: POSIX
+
+    /// Reads until `buffer` is full or the end of the file is reached; returns the number of bytes read.
+    static func readFully(_ fd: Int32, into buffer: UnsafeMutableRawBufferPointer, at offset: off_t) throws -> Int {
+        var done = 0
+        while done < buffer.count {
+            let count = Darwin.pread(fd, buffer.baseAddress! + done, buffer.count - done, offset + off_t(done))
+            if count < 0 {
+                if errno == EINTR { continue }
+                throw SecureFileError.posix()
+            }
+            if count == 0 { break }
+            done += count
+        }
+        return done
+    }
+
+    static func writeFully(_ fd: Int32, _ buffer: UnsafeRawBufferPointer, at offset: off_t) throws {
+        var done = 0
+        while done < buffer.count {
+            let count = Darwin.pwrite(fd, buffer.baseAddress! + done, buffer.count - done, offset + off_t(done))
+            if count < 0 {
+                if errno == EINTR { continue }
+                throw SecureFileError.posix()
+            }
+            done += count
+        }
+    }
+}
@@ -0,0 +1,178 @@
+//
+//  SecureChunkedFileHeader.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import CryptoKit
+
+/// Fixed-size authenticated header at the start of every secure chunked file.
+///
+/// Layout (little endian):
+///
+///     0   magic "ACCF"          4
+///     4   version               2
+///     6   flags                 2
+///     8   chunk size            4
+///     12  chunk cipher suite    4
+///     16  plaintext length      8
+///     24  file identifier       16
+///     40  wrapped file key      60   (AES-GCM nonce, ciphertext, tag)
+///     100 content digest        32   (valid when flags has `contentDigestFlag`)
+///     132 modification time     8    (nanoseconds since 1970, 0 if unknown)
+///     140 hole count            4
+///     144 holes                 80   (up to 5 chunk ranges: first chunk 8, chunk count 8)
+///     224 HMAC-SHA256           32
+struct SecureChunkedFileHeader {
+    static let size = 256
+    static let currentVersion: UInt16 = 1
+    static let fileIdentifierSize = 16
+    static let wrappedKeySize = 60
+    static let contentDigestSize = SHA256.byteCount
+    static let contentDigestFlag: UInt16 = 1 << 0
+    static let maxHoles = 5
+
+    private static let magic: [UInt8] = Array("ACCF".utf8)
+    private static let macOffset = size - SHA256.byteCount
+
+    var version: UInt16 = SecureChunkedFileHeader.currentVersion
+    var flags: UInt16 = 0
+    var chunkSize: UInt32
+    var cipherSuite: SecureChunkCipherSuite
+    var length: UInt64 = 0
+    var fileIdentifier: Data
+    var wrappedKey: Data
+
+    /// Time of the last change to the plaintext, in nanoseconds since 1970; 0 if unknown.
+    var modificationTime: UInt64 = 0
+
+    /// Chunk ranges that were never written and read as zeros, sorted and separated by at least one chunk. Their slots
+    /// are never read, see `SecureChunkedFile.truncate(to:)`.
+    var holes: [Range<UInt64>] = []
+
+    var modificationDate: Date? {
+        get {
+            guard modificationTime != 0 else { return nil }
+            return Date(timeIntervalSince1970: Double(modificationTime) / 1e9)
+        }
+        set {
+            modificationTime = newValue.map { UInt64(max(0, $0.timeIntervalSince1970 * 1e9)) } ?? 0
+        }
+    }
+
+    /// Keyed digest of the plaintext, see `SecureChunkedFile.contentDigest()`. Setting it updates `flags`.
+    var contentDigest: Data? {
+        didSet {
+            if contentDigest != nil {
+                flags |= SecureChunkedFileHeader.contentDigestFlag
+            } else {
+                flags &= ~SecureChunkedFileHeader.contentDigestFlag
+            }
+        }
+    }
+
+    init(chunkSize: UInt32, cipherSuite: SecureChunkCipherSuite, fileIdentifier: Data, wrappedKey: Data) {
+        self.chunkSize = chunkSize
+        self.cipherSuite = cipherSuite
+        self.fileIdentifier = fileIdentifier
+        self.wrappedKey = wrappedKey
+    }
+
+    /// Parses the unauthenticated fields; call `isAuthentic(_:macKey:)` once the file key is known.
+    init(decoding bytes: UnsafeRawBufferPointer) throws {
+        guard bytes.count >= SecureChunkedFileHeader.size,
+            Array(bytes[0..<4]) == SecureChunkedFileHeader.magic else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        version = UInt16(truncatingIfNeeded: SecureChunkedFileHeader.load(bytes, at: 4, size: 2))
+        guard version == SecureChunkedFileHeader.currentVersion else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        flags = UInt16(truncatingIfNeeded: SecureChunkedFileHeader.load(bytes, at: 6, size: 2))
+        chunkSize = UInt32(truncatingIfNeeded: SecureChunkedFileHeader.load(bytes, at: 8, size: 4))
+        guard let cipherSuite = SecureChunkCipherSuite(
+            rawValue: UInt32(truncatingIfNeeded: SecureChunkedFileHeader.load(bytes, at: 12, size: 4))) else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        self.cipherSuite = cipherSuite
+        length = SecureChunkedFileHeader.load(bytes, at: 16, size: 8)
+        fileIdentifier = Data(bytes[24..<(24 + SecureChunkedFileHeader.fileIdentifierSize)])
+        wrappedKey = Data(bytes[40..<(40 + SecureChunkedFileHeader.wrappedKeySize)])
+        modificationTime = SecureChunkedFileHeader.load(bytes, at: 132, size: 8)
+        let holeCount = SecureChunkedFileHeader.load(bytes, at: 140, size: 4)
+        guard holeCount <= SecureChunkedFileHeader.maxHoles else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        for hole in 0..<Int(holeCount) {
+            let first = SecureChunkedFileHeader.load(bytes, at: 144 + 16 * hole, size: 8)
+            let count = SecureChunkedFileHeader.load(bytes, at: 152 + 16 * hole, size: 8)
+            guard count > 0, first <= UInt64.max - count, first > holes.last?.upperBound ?? 0 || hole == 0 else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            holes.append(first..<(first + count))
+        }
+        if flags & SecureChunkedFileHeader.contentDigestFlag != 0 {
+            contentDigest = Data(bytes[100..<(100 + SecureChunkedFileHeader.contentDigestSize)])
+        }
+        guard chunkSize > 0, chunkSize % 16 == 0 else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+    }
+
+    func encoded(macKey: SymmetricKey) -> [UInt8] {
+        var bytes = [UInt8](repeating: 0, count: SecureChunkedFileHeader.size)
+        bytes.withUnsafeMutableBytes { buffer in
+            buffer.baseAddress!.copyMemory(from: SecureChunkedFileHeader.magic, byteCount: 4)
+            SecureChunkedFileHeader.store(UInt64(version), into: buffer, at: 4, size: 2)
+            SecureChunkedFileHeader.store(UInt64(flags), into: buffer, at: 6, size: 2)
+            SecureChunkedFileHeader.store(UInt64(chunkSize), into: buffer, at: 8, size: 4)
+            SecureChunkedFileHeader.store(UInt64(cipherSuite.rawValue), into: buffer, at: 12, size: 4)
+            SecureChunkedFileHeader.store(length, into: buffer, at: 16, size: 8)
+            _ = fileIdentifier.copyBytes(to: UnsafeMutableRawBufferPointer(rebasing: buffer[24...]),
+                                         count: SecureChunkedFileHeader.fileIdentifierSize)
+            _ = wrappedKey.copyBytes(to: UnsafeMutableRawBufferPointer(rebasing: buffer[40...]),
+                                     count: SecureChunkedFileHeader.wrappedKeySize)
+            SecureChunkedFileHeader.store(modificationTime, into: buffer, at: 132, size: 8)
+            SecureChunkedFileHeader.store(UInt64(holes.count), into: buffer, at: 140, size: 4)
+            for (hole, range) in holes.enumerated() {
+                SecureChunkedFileHeader.store(range.lowerBound, into: buffer, at: 144 + 16 * hole, size: 8)
+                SecureChunkedFileHeader.store(range.upperBound - range.lowerBound, into: buffer, at: 152 + 16 * hole,
+                                              size: 8)
+            }
+            if let digest = contentDigest {
+                _ = digest.copyBytes(to: UnsafeMutableRawBufferPointer(rebasing: buffer[100...]),
+                                     count: SecureChunkedFileHeader.contentDigestSize)
+            }
+            let authenticated = UnsafeRawBufferPointer(rebasing: buffer[0..<SecureChunkedFileHeader.macOffset])
+            let mac = HMAC<SHA256>.authenticationCode(for: authenticated, using: macKey)
+            mac.withUnsafeBytes {
+                UnsafeMutableRawBufferPointer(rebasing: buffer[SecureChunkedFileHeader.macOffset...]).copyMemory(from: $0)
+            }
+        }
+        return bytes
+    }
+
+    static func isAuthentic(_ bytes: UnsafeRawBufferPointer, macKey: SymmetricKey) -> Bool {
+        guard bytes.count >= size else { return false }
+        let mac = UnsafeRawBufferPointer(rebasing: bytes[macOffset..<size])
+        let authenticated = UnsafeRawBufferPointer(rebasing: bytes[0..<macOffset])
+        return HMAC<SHA256>.isValidAuthenticationCode(mac, authenticating: authenticated, using: macKey)
+    }
+
+    private static func load(_ bytes: UnsafeRawBufferPointer, at offset: Int, size: Int) -> UInt64 {
+        var value: UInt64 = 0
+        for index in (0..<size).reversed() {
+            value = value << 8 | UInt64(bytes[offset + index])
+        }
+        return value
+    }
+
+    private static func store(_ value: UInt64, into bytes: UnsafeMutableRawBufferPointer, at offset: Int, size: Int) {
+        for index in 0..<size {
+            bytes[offset + index] = UInt8(truncatingIfNeeded: value >> (8 * UInt64(index)))
+        }
+    }
+}
@@ -0,0 +1,194 @@
+//
+//  SecureCollectionJournal.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import CryptoKit
+import AppConnect
+
+/// Journal of the changes made to a property list collection since it was last saved in full as an AppConnect secure
+/// file.
+///
+/// The journal lives next to the collection, in `<path>.journal`, as a secure chunked file. It starts with the SHA-256
+/// digest of the base contents it applies to, so a journal left behind by a crash between writing a new base and
+/// starting a new journal no longer matches and is ignored, while a base and journal that are copied or restored
+/// together still match. Each save appends one batch of operations, a 32 bit length and a binary property list, and
+/// every batch after the first starts on a chunk boundary, so a torn append can only damage the last batch.
+final class SecureCollectionJournal {
+    static let chunkSize = 4096
+    /// Journals smaller than this are never folded back into the base, however small the base is.
+    static let minimumCompactionSize: UInt64 = 1024 * 1024
+
+    private static let headerSize = UInt64(SHA256.byteCount)
+
+    let basePath: String
+    let journalPath: String
+
+    private var file: SecureChunkedFile?
+    /// Digest of a base whose journal could not be started yet; the next append tries again.
+    private var unstartedBaseDigest: Data?
+    private var offset: UInt64 = 0
+    private var baseSize: UInt64 = 0
+
+    init(basePath: String) {
+        self.basePath = basePath
+        journalPath = basePath + ".journal"
+    }
+
+    deinit {
+        close()
+    }
+
+    /// Appended bytes that a compaction would fold into the base.
+    var length: UInt64 {
+        return offset
+    }
+
+    /// True once the journal has outgrown the base, so rewriting the base costs no more than the appends it replaces.
+    var needsCompaction: Bool {
+        return offset > max(SecureCollectionJournal.minimumCompactionSize, baseSize)
+    }
+
+    /// The decrypted contents of the base file at `path`, nil when there is none. Pass them to `open(base:_:)`.
+    static func readBase(atPath path: String) throws -> Data? {
+        guard FileManager.default.fileExists(atPath: path) else { return nil }
+        return try NSData(contentsOfSecureFile: path, options: []) as Data
+    }
+
+    /// Passes every operation recorded against `base`, the contents of the base file, to `apply`, oldest first, and
+    /// readies the journal for appending. A journal written for another base is discarded.
+    func open(base: Data?, _ apply: (Any) throws -> Void) throws {
+        let digest = SecureCollectionJournal.digest(of: base ?? Data())
+        baseSize = UInt64(base?.count ?? 0)
+        if FileManager.default.fileExists(atPath: journalPath) {
+            let journal = try SecureChunkedFile(path: journalPath, flags: O_RDWR, cacheBudget: 0)
+            let header: Data
+            do {
+                header = try journal.read(length: Int(SecureCollectionJournal.headerSize), at: 0)
+            } catch {
+                journal.close()
+                // The first chunk also holds the first batch, so it can only have been torn if nothing follows it.
+                guard journal.length <= UInt64(SecureCollectionJournal.chunkSize) else {
+                    throw SecureFileError.badKeyOrCorruptData
+                }
+                header = Data()
+            }
+            if header == digest {
+                offset = try replay(journal, apply)
+                if journal.length > offset {
+                    try journal.truncate(to: offset)
+                }
+                file = journal
+                return
+            }
+            journal.close()
+            Darwin.unlink(journalPath)
+        }
+        try start(baseDigest: digest)
+    }
+
+    /// Appends one batch and returns once it is durable. A failed append leaves the journal as it was.
+    func append(_ operations: [Any]) throws {
+        if file == nil, let baseDigest = unstartedBaseDigest {
+            try start(baseDigest: baseDigest)
+        }
+        guard let file = file else {
+            throw SecureFileError.posix(EBADF)
+        }
+        let payload = try PropertyListSerialization.data(fromPropertyList: operations, format: .binary, options: 0)
+        var batch = Data()
+        SecureKeyValueCodec.append(UInt32(payload.count), to: &batch)
+        batch.append(payload)
+        do {
+            try file.write(batch, at: offset)
+            try file.synchronize()
+        } catch {
+            try? file.truncate(to: offset)
+            throw error
+        }
+        let chunkSize = UInt64(SecureCollectionJournal.chunkSize)
+        offset = (offset + UInt64(batch.count) + chunkSize - 1) / chunkSize * chunkSize
+    }
+
+    /// Durably replaces the base with `contents`, a serialized property list, and starts an empty journal for it. Once
+    /// the base is written this succeeds: if the journal cannot be started, the next append starts it or throws.
+    func replaceBase(with contents: Data) throws {
+        try SecureGroupCommit.shared.write(contents, toPath: basePath, format: .appConnect(encryptionGroupId: nil))
+        close()
+        baseSize = UInt64(contents.count)
+        try? start(baseDigest: SecureCollectionJournal.digest(of: contents))
+    }
+
+    /// Closes the journal. Later appends fail with EBADF.
+    func close() {
+        file?.close()
+        file = nil
+        unstartedBaseDigest = nil
+    }
+
+    /// Replaces any journal file with an empty one for the base whose contents have `baseDigest`. On failure no journal
+    /// file is left behind, and `append(_:)` tries again.
+    private func start(baseDigest: Data) throws {
+        unstartedBaseDigest = baseDigest
+        offset = 0
+        Darwin.unlink(journalPath)
+        let journal = try SecureChunkedFile(path: journalPath, flags: O_RDWR | O_CREAT | O_EXCL,
+                                            chunkSize: SecureCollectionJournal.chunkSize, cacheBudget: 0)
+        do {
+            try journal.write(baseDigest, at: 0)
+            try journal.synchronize()
+        } catch {
+            journal.close()
+            Darwin.unlink(journalPath)
+            throw error
+        }
+        file = journal
+        unstartedBaseDigest = nil
+        offset = SecureCollectionJournal.headerSize
+    }
+
+    /// Applies every batch and returns the offset after the last one. Only the last batch can have been torn, and it
+    /// was never acknowledged, so a batch that cannot be read is dropped when it reaches the end of the journal;
+    /// anywhere else the journal is corrupt.
+    private func replay(_ journal: SecureChunkedFile, _ apply: (Any) throws -> Void) throws -> UInt64 {
+        let chunkSize = UInt64(SecureCollectionJournal.chunkSize)
+        var offset = SecureCollectionJournal.headerSize
+        while offset < journal.length {
+            // Where the batch ends, as far as is known: its length prefix until that has been read.
+            var end = offset + 4
+            let payload: Data
+            do {
+                let prefix = try journal.read(length: 4, at: offset)
+                guard let length = SecureKeyValueCodec.integer(UInt32.self, in: prefix, at: 0), length > 0 else {
+                    throw SecureFileError.badKeyOrCorruptData
+                }
+                end = offset + 4 + UInt64(length)
+                payload = try journal.read(length: Int(length), at: offset + 4)
+                guard payload.count == Int(length) else {
+                    throw SecureFileError.badKeyOrCorruptData
+                }
+            } catch {
+                guard (end + chunkSize - 1) / chunkSize * chunkSize >= journal.length else {
+                    throw SecureFileError.badKeyOrCorruptData
+                }
+                break
+            }
+            // A complete batch that does not decode was not torn; the journal is corrupt.
+            guard let operations = try? PropertyListSerialization.propertyList(from: payload, format: nil) as? [Any]
+                else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            try operations.forEach(apply)
+            offset = (end + chunkSize - 1) / chunkSize * chunkSize
+        }
+        return offset
+    }
+
+    private static func digest(of contents: Data) -> Data {
+        return Data(SHA256.hash(data: contents))
+    }
+}
@@ -0,0 +1,215 @@
+//
+//  SecureFileDescriptorTable.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import os
+import AppConnect
+
+/// Integer descriptors for secure chunked files, with the same conventions as the ACSecureFile* functions: calls
+/// return -1 and set errno on failure, and `lastError(_:)` returns the ACErrorDomain code of the last failure on a
+/// descriptor, like ACSecureFileLastError.
+///
+/// The descriptor is the index of a slot that has its own unfair lock and is padded to a cache line, so calls on
+/// different descriptors never share a lock or a cache line. A slot lock is held only to look up or swap the file,
+/// never across I/O; each `SecureChunkedFile` serializes its own I/O.
+final class SecureFileDescriptorTable {
+    static let shared = SecureFileDescriptorTable()
+    static let defaultCapacity = 1024
+
+    /// Apple silicon uses 128 byte cache lines.
+    private static let slotStride = 128
+
+    private struct Slot {
+        var lock = os_unfair_lock()
+        var file: Unmanaged<SecureChunkedFile>?
+        var lastError: Int32 = 0
+    }
+
+    let capacity: Int
+    private let slots: UnsafeMutableRawPointer
+
+    init(capacity: Int = SecureFileDescriptorTable.defaultCapacity) {
+        precondition(MemoryLayout<Slot>.size <= SecureFileDescriptorTable.slotStride)
+        self.capacity = max(capacity, 1)
+        slots = UnsafeMutableRawPointer.allocate(byteCount: self.capacity * SecureFileDescriptorTable.slotStride,
+                                                 alignment: SecureFileDescriptorTable.slotStride)
+        for index in 0..<self.capacity {
+            (slots + index * SecureFileDescriptorTable.slotStride).initializeMemory(as: Slot.self, repeating: Slot(),
+                                                                                    count: 1)
+        }
+    }
+
+    deinit {
+        for index in 0..<capacity {
+            slot(Int32(index)).pointee.file?.release()
+        }
+        slots.deallocate()
+    }
+
+    /// Opens `path` into the lowest free descriptor.
+    func open(_ path: String, flags: Int32 = O_RDWR | O_CREAT, domain: SecureFileKeyDomain = .app) -> Int32 {
+        let file: SecureChunkedFile
+        do {
+            file = try SecureChunkedFile(path: path, flags: flags, domain: domain)
+        } catch {
+            errno = SecureFileDescriptorTable.posixCode(for: error)
+            return -1
+        }
+        return insert(file)
+    }
+
+    /// Puts `file` into the lowest free descriptor, which then owns it, for callers that open the file themselves to
+    /// keep its errors. Closes `file` and fails with EMFILE when every descriptor is taken.
+    func insert(_ file: SecureChunkedFile) -> Int32 {
+        for index in 0..<capacity {
+            let slot = self.slot(Int32(index))
+            guard os_unfair_lock_trylock(&slot.pointee.lock) else { continue }
+            if slot.pointee.file == nil {
+                slot.pointee.file = Unmanaged.passRetained(file)
+                slot.pointee.lastError = 0
+                os_unfair_lock_unlock(&slot.pointee.lock)
+                return Int32(index)
+            }
+            os_unfair_lock_unlock(&slot.pointee.lock)
+        }
+        file.close()
+        errno = EMFILE
+        return -1
+    }
+
+    func pread(_ fd: Int32, _ buffer: UnsafeMutableRawBufferPointer, _ offset: off_t) -> Int {
+        guard offset >= 0 else {
+            errno = EINVAL
+            return -1
+        }
+        return perform(fd) { try $0.read(into: buffer, at: UInt64(offset)) }
+    }
+
+    func pwrite(_ fd: Int32, _ buffer: UnsafeRawBufferPointer, _ offset: off_t) -> Int {
+        guard offset >= 0 else {
+            errno = EINVAL
+            return -1
+        }
+        return perform(fd) { file -> Int in
+            try file.write(buffer, at: UInt64(offset))
+            return buffer.count
+        }
+    }
+
+    func read(_ fd: Int32, _ buffer: UnsafeMutableRawBufferPointer) -> Int {
+        return perform(fd) { try $0.read(into: buffer) }
+    }
+
+    func write(_ fd: Int32, _ buffer: UnsafeRawBufferPointer) -> Int {
+        return perform(fd) { file -> Int in
+            try file.write(buffer)
+            return buffer.count
+        }
+    }
+
+    func ftruncate(_ fd: Int32, _ length: off_t) -> Int32 {
+        guard length >= 0 else {
+            errno = EINVAL
+            return -1
+        }
+        return Int32(perform(fd) { file -> Int in
+            try file.truncate(to: UInt64(length))
+            return 0
+        })
+    }
+
+    func fsync(_ fd: Int32) -> Int32 {
+        return Int32(perform(fd) { file -> Int in
+            try file.synchronize()
+            return 0
+        })
+    }
+
+    /// Plaintext length of `fd`, the st_size ACSecureFstat would report.
+    func size(_ fd: Int32) -> off_t {
+        return off_t(perform(fd) { Int($0.length) })
+    }
+
+    func close(_ fd: Int32) -> Int32 {
+        guard fd >= 0, Int(fd) < capacity else {
+            errno = EBADF
+            return -1
+        }
+        let slot = self.slot(fd)
+        os_unfair_lock_lock(&slot.pointee.lock)
+        let file = slot.pointee.file
+        slot.pointee.file = nil
+        os_unfair_lock_unlock(&slot.pointee.lock)
+        guard let closing = file else {
+            errno = EBADF
+            return -1
+        }
+        closing.takeRetainedValue().close()
+        return 0
+    }
+
+    /// ACErrorDomain code of the last failed call on `fd`, or 0.
+    func lastError(_ fd: Int32) -> Int32 {
+        guard fd >= 0, Int(fd) < capacity else { return 0 }
+        let slot = self.slot(fd)
+        os_unfair_lock_lock(&slot.pointee.lock)
+        defer { os_unfair_lock_unlock(&slot.pointee.lock) }
+        return slot.pointee.lastError
+    }
+
+    private func slot(_ fd: Int32) -> UnsafeMutablePointer<Slot> {
+        return (slots + Int(fd) * SecureFileDescriptorTable.slotStride).assumingMemoryBound(to: Slot.self)
+    }
+
+    /// Runs `body` on the file behind `fd` outside the slot lock, holding a reference so a concurrent close cannot
+    /// free it mid-call.
+    private func perform(_ fd: Int32, _ body: (SecureChunkedFile) throws -> Int) -> Int {
+        guard fd >= 0, Int(fd) < capacity else {
+            errno = EBADF
+            return -1
+        }
+        let slot = self.slot(fd)
+        os_unfair_lock_lock(&slot.pointee.lock)
+        let file = slot.pointee.file?.takeUnretainedValue()
+        os_unfair_lock_unlock(&slot.pointee.lock)
+        guard let target = file else {
+            errno = EBADF
+            return -1
+        }
+
+        do {
+            return try body(target)
+        } catch {
+            let code = SecureFileDescriptorTable.posixCode(for: error)
+            os_unfair_lock_lock(&slot.pointee.lock)
+            if slot.pointee.file?.takeUnretainedValue() === target {
+                let error = error as NSError
+                slot.pointee.lastError = error.domain == ACErrorDomain ? Int32(truncatingIfNeeded: error.code) : 0
+            }
+            os_unfair_lock_unlock(&slot.pointee.lock)
+            errno = code
+            return -1
+        }
+    }
+
+    /// errno for `error`, following the mapping documented in ACSecureFile.h.
+    private static func posixCode(for error: Error) -> Int32 {
+        let error = error as NSError
+        if error.domain == NSPOSIXErrorDomain {
+            return Int32(truncatingIfNeeded: error.code)
+        }
+        switch error.code {
+        case ACErrorNoKeys:
+            return EACCES
+        case ACErrorInvalidArg:
+            return EINVAL
+        default:
+            return EIO
+        }
+    }
+}
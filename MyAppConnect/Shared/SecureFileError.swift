@@ -0,0 +1,37 @@
+//
+//  SecureFileError.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import AppConnect
+
+/// Builds the NSErrors reported by the secure file layer, using the same domains and codes as the AppConnect SDK.
+enum SecureFileError {
+    static func appConnect(_ code: Int) -> NSError {
+        return NSError(domain: ACErrorDomain, code: code, userInfo: nil)
+    }
+
+    static func posix(_ code: Int32 = errno) -> NSError {
+        return NSError(domain: NSPOSIXErrorDomain, code: Int(code), userInfo: nil)
+    }
+
+    static var noKeys: NSError {
+        return appConnect(ACErrorNoKeys)
+    }
+
+    static var badKeyOrCorruptData: NSError {
+        return appConnect(ACErrorBadKeyOrCorruptData)
+    }
+
+    static var invalidArgument: NSError {
+        return appConnect(ACErrorInvalidArg)
+    }
+
+    static var regularFileOnly: NSError {
+        return appConnect(ACErrorRegularFileOnly)
+    }
+}
@@ -0,0 +1,147 @@
+//
+//  SecureFileIOQueue.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+
+/// Submission and completion queue for secure chunked file I/O.
+///
+/// Callers submit batches of reads, writes and syncs without blocking, and reap completions when convenient.
+/// Operations run on a bounded pool of worker threads, so disk I/O of one operation overlaps with the encryption of
+/// others. Operations on the same file complete in submission order; operations on different files run in parallel.
+final class SecureFileIOQueue {
+    enum Operation {
+        case read(SecureChunkedFile, offset: UInt64, length: Int)
+        case write(SecureChunkedFile, offset: UInt64, data: Data)
+        case synchronize(SecureChunkedFile)
+
+        var file: SecureChunkedFile {
+            switch self {
+            case .read(let file, _, _), .write(let file, _, _), .synchronize(let file):
+                return file
+            }
+        }
+    }
+
+    struct Request {
+        /// Caller-chosen value returned with the completion, like io_uring user data.
+        let tag: Int
+        let operation: Operation
+    }
+
+    struct Completion {
+        let tag: Int
+        /// Bytes read for `.read`, nil for other operations.
+        let result: Result<Data?, Error>
+        /// Time from submission to completion.
+        let latency: TimeInterval
+    }
+
+    private let workers = OperationQueue()
+    private let condition = NSCondition()
+    private var completions: [Completion] = []
+    private var pending = 0
+    private var lastOperation: [ObjectIdentifier: Foundation.Operation] = [:]
+
+    init(maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount) {
+        workers.name = "SecureFileIOQueue"
+        workers.maxConcurrentOperationCount = max(maxConcurrency, 1)
+        workers.qualityOfService = .userInitiated
+    }
+
+    /// Runs every request already submitted before returning, so releasing the queue never drops a write. Their
+    /// completions are not reported, since nobody is left to reap them.
+    deinit {
+        // The last release can happen inside a completion on a worker, which must not wait for itself.
+        if OperationQueue.current !== workers {
+            workers.waitUntilAllOperationsAreFinished()
+        }
+    }
+
+    /// Queues `requests` and returns immediately.
+    func submit(_ requests: [Request]) {
+        guard !requests.isEmpty else { return }
+        var operations: [Foundation.Operation] = []
+        condition.lock()
+        pending += requests.count
+        for request in requests {
+            let submitted = Date()
+            let operation = BlockOperation { [weak self] in
+                let result = SecureFileIOQueue.perform(request.operation)
+                self?.complete(Completion(tag: request.tag, result: result,
+                                          latency: Date().timeIntervalSince(submitted)))
+            }
+            let key = ObjectIdentifier(request.operation.file)
+            if let previous = lastOperation[key], !previous.isFinished {
+                operation.addDependency(previous)
+            }
+            operation.completionBlock = { [weak self, weak operation] in
+                self?.forget(operation, key: key)
+            }
+            lastOperation[key] = operation
+            operations.append(operation)
+        }
+        condition.unlock()
+        workers.addOperations(operations, waitUntilFinished: false)
+    }
+
+    /// Returns the completions available, waiting until at least `minimum` are (or all submitted requests have
+    /// completed) or until `deadline` passes.
+    func reap(minimum: Int = 1, deadline: Date = .distantFuture) -> [Completion] {
+        condition.lock()
+        defer { condition.unlock() }
+        while completions.count < minimum && pending > 0 {
+            if !condition.wait(until: deadline) {
+                break
+            }
+        }
+        let reaped = completions
+        completions.removeAll(keepingCapacity: true)
+        return reaped
+    }
+
+    /// Number of submitted requests that have not completed yet.
+    var inFlight: Int {
+        condition.lock()
+        defer { condition.unlock() }
+        return pending
+    }
+
+    private func complete(_ completion: Completion) {
+        condition.lock()
+        completions.append(completion)
+        pending -= 1
+        condition.broadcast()
+        condition.unlock()
+    }
+
+    /// Drops the ordering entry of a finished operation unless a later operation on the same file replaced it.
+    private func forget(_ operation: Foundation.Operation?, key: ObjectIdentifier) {
+        condition.lock()
+        if let operation = operation, lastOperation[key] === operation {
+            lastOperation[key] = nil
+        }
+        condition.unlock()
+    }
+
+    private static func perform(_ operation: Operation) -> Result<Data?, Error> {
+        do {
+            switch operation {
+            case .read(let file, let offset, let length):
+                return .success(try file.read(length: length, at: offset))
+            case .write(let file, let offset, let data):
+                try file.write(data, at: offset)
+                return .success(nil)
+            case .synchronize(let file):
+                try file.synchronize()
+                return .success(nil)
+            }
+        } catch {
+            return .failure(error)
+        }
+    }
+}
@@ -0,0 +1,76 @@
+//
+//  SecureFileKeyProvider.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import CryptoKit
+import AppConnect
+
+/// Key domain a secure file belongs to: the app's own key, or a key shared with other apps of an encryption group.
+enum SecureFileKeyDomain: Hashable {
+    case app
+    case group(String)
+}
+
+/// Supplies the key-encryption keys that wrap the per-file keys of secure chunked files.
+protocol SecureFileKeyProvider: AnyObject {
+    func keyEncryptionKey(for domain: SecureFileKeyDomain) throws -> SymmetricKey
+}
+
+/// Key provider backed by the AppConnect derived app and shared keys.
+///
+/// Deriving a key from AppConnect is far more expensive than opening a small file, so the master keys come from
+/// `DerivedKeyService`, which derives each one once and drops them all when secure services become unavailable. The
+/// key-encryption keys derived from them are cached per domain as well, and dropped whenever the service flushes.
+final class AppConnectKeyProvider: SecureFileKeyProvider {
+    static let shared = AppConnectKeyProvider()
+    static let defaultCacheCapacity = 32
+
+    /// Identifier passed to AppConnect when deriving the master key; never reuse it for another purpose.
+    static let keyIdentifier = "MyAppConnect.SecureChunkedFile.KEK"
+
+    private let keys: DerivedKeyService
+    private let cache: SecureKeyCache<SecureFileKeyDomain>
+
+    init(keys: DerivedKeyService = .shared, cacheCapacity: Int = AppConnectKeyProvider.defaultCacheCapacity) {
+        self.keys = keys
+        cache = SecureKeyCache(capacity: cacheCapacity)
+    }
+
+    var cacheStatistics: SecureKeyCache<SecureFileKeyDomain>.Statistics {
+        return cache.statistics
+    }
+
+    func keyEncryptionKey(for domain: SecureFileKeyDomain) throws -> SymmetricKey {
+        let generation = try keys.currentGeneration()
+        return try cache.key(for: domain, generation: generation) {
+            let master: ACSensitiveData
+            switch domain {
+            case .app:
+                master = try keys.derivedAppKey(withIdentifier: AppConnectKeyProvider.keyIdentifier)
+            case .group(let groupId):
+                master = try keys.derivedSharedKey(withIdentifier: "\(AppConnectKeyProvider.keyIdentifier).\(groupId)")
+            }
+            let bytes = UnsafeRawBufferPointer(start: master.bytes, count: master.length)
+            return SecureKeyDerivation.deriveKey(from: bytes, salt: Data(), info: "key-encryption")
+        }
+    }
+}
+
+/// HKDF-SHA256 (RFC 5869) limited to a single 32 byte output block, which is all the secure file layer needs.
+enum SecureKeyDerivation {
+    static func deriveKey<K: ContiguousBytes>(from inputKeyMaterial: K, salt: Data, info: String) -> SymmetricKey {
+        let saltKey = SymmetricKey(data: salt.isEmpty ? Data(count: SHA256.byteCount) : salt)
+        let pseudoRandomKey = inputKeyMaterial.withUnsafeBytes {
+            HMAC<SHA256>.authenticationCode(for: $0, using: saltKey)
+        }
+        var block = Data(info.utf8)
+        block.append(1)
+        let output = HMAC<SHA256>.authenticationCode(for: block, using: SymmetricKey(data: pseudoRandomKey))
+        return SymmetricKey(data: output)
+    }
+}
@@ -0,0 +1,23 @@
+//
+//  SecureFileShims.h
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+#ifndef SecureFileShims_h
+#define SecureFileShims_h
+
+#import <AppConnect/ACSecureFile.h>
+
+/** Non-variadic wrappers so Swift can call the variadic AppConnect open functions */
+static inline int SecureFileOpen(const char * _Nonnull path, int oflag, mode_t mode) {
+    return ACSecureFileOpen(path, oflag, mode);
+}
+
+static inline int SharedSecureFileOpen(const char * _Nonnull path, const char * _Nonnull sharedGroupId, int oflag, mode_t mode) {
+    return ACSharedSecureFileOpen(path, sharedGroupId, oflag, mode);
+}
+
+#endif /* SecureFileShims_h */
@@ -0,0 +1,143 @@
+//
+//  SecureFileStream.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import AppConnect
+
+/// Plaintext that can be read sequentially in bounded buffers.
+protocol SecureByteSource: AnyObject {
+    /// Reads at the current position and advances it; returns 0 at the end of the file.
+    func read(into buffer: UnsafeMutableRawBufferPointer) throws -> Int
+}
+
+extension SecureChunkedFile: SecureByteSource {}
+
+/// AppConnect secure file opened read-only with ACSecureFileOpen or ACSharedSecureFileOpen.
+final class ACSecureFileSource: SecureByteSource {
+    private var fd: Int32
+
+    init(path: String, encryptionGroupId: String? = nil) throws {
+        if let groupId = encryptionGroupId {
+            fd = SharedSecureFileOpen(path, groupId, O_RDONLY, 0)
+        } else {
+            fd = SecureFileOpen(path, O_RDONLY, 0)
+        }
+        guard fd >= 0 else {
+            throw ACSecureFileSource.error(errno)
+        }
+    }
+
+    deinit {
+        close()
+    }
+
+    /// Plaintext length, as reported by ACSecureFstat.
+    func length() throws -> UInt64 {
+        var info = stat()
+        guard ACSecureFstat(fd, &info) == 0 else {
+            throw ACSecureFileSource.error(errno)
+        }
+        return UInt64(info.st_size)
+    }
+
+    func read(into buffer: UnsafeMutableRawBufferPointer) throws -> Int {
+        guard let base = buffer.baseAddress, buffer.count > 0 else { return 0 }
+        while true {
+            let count = ACSecureFileRead(fd, base, buffer.count)
+            if count >= 0 {
+                return count
+            }
+            if errno != EINTR {
+                throw ACSecureFileSource.error(errno)
+            }
+        }
+    }
+
+    /// Reads at `offset` with ACSecureFilePread, leaving the current position alone.
+    func read(into buffer: UnsafeMutableRawBufferPointer, at offset: UInt64) throws -> Int {
+        guard let base = buffer.baseAddress, buffer.count > 0 else { return 0 }
+        var done = 0
+        while done < buffer.count {
+            let count = ACSecureFilePread(fd, base + done, buffer.count - done, off_t(offset) + off_t(done))
+            if count < 0 {
+                if errno == EINTR { continue }
+                throw ACSecureFileSource.error(errno)
+            }
+            if count == 0 { break }
+            done += count
+        }
+        return done
+    }
+
+    func close() {
+        guard fd >= 0 else { return }
+        _ = ACSecureFileClose(fd)
+        fd = -1
+    }
+
+    /// Maps errno from the AppConnect POSIX layer to the matching ACErrorDomain error, as documented in ACSecureFile.h.
+    static func error(_ code: Int32) -> NSError {
+        switch code {
+        case EACCES:
+            return SecureFileError.noKeys
+        case EIO:
+            return SecureFileError.badKeyOrCorruptData
+        default:
+            return SecureFileError.posix(code)
+        }
+    }
+}
+
+/// Pull-based reader that walks a secure file through one reusable buffer, so memory use does not depend on the file
+/// size. The buffer is wiped once the reader is exhausted or released.
+final class SecureFileStreamReader {
+    static let defaultBufferSize = 64 * 1024
+
+    private let source: SecureByteSource
+    private let buffer: SecureBuffer
+
+    init(source: SecureByteSource, bufferSize: Int = SecureFileStreamReader.defaultBufferSize) throws {
+        self.source = source
+        buffer = try SecureBuffer(count: max(bufferSize, 1))
+    }
+
+    /// Returns the next run of plaintext, or nil at the end of the file. The bytes stay valid until the next call.
+    func next() throws -> UnsafeRawBufferPointer? {
+        var filled = 0
+        while filled < buffer.count {
+            let count = try source.read(into: UnsafeMutableRawBufferPointer(rebasing: buffer.bytes[filled...]))
+            if count == 0 { break }
+            filled += count
+        }
+        guard filled > 0 else {
+            buffer.wipe()
+            return nil
+        }
+        return UnsafeRawBufferPointer(rebasing: buffer.bytes[0..<filled])
+    }
+
+    func forEach(_ body: (UnsafeRawBufferPointer) throws -> Void) throws {
+        defer { buffer.wipe() }
+        while let chunk = try next() {
+            try body(chunk)
+        }
+    }
+}
+
+extension FileManager {
+    /// Streams the decrypted contents of the AppConnect secure file at `path` to `body`, holding at most `bufferSize`
+    /// bytes of plaintext at a time. Use this for files that -secureContentsAtPath:error: rejects with
+    /// ACErrorFileTooBig or ACErrorLowMemory; they are too large to be held in memory whole by any path.
+    func streamSecureContents(atPath path: String, encryptionGroupId: String? = nil,
+                              bufferSize: Int = SecureFileStreamReader.defaultBufferSize,
+                              _ body: (UnsafeRawBufferPointer) throws -> Void) throws {
+        let source = try ACSecureFileSource(path: path, encryptionGroupId: encryptionGroupId)
+        defer { source.close() }
+        try SecureFileStreamReader(source: source, bufferSize: bufferSize).forEach(body)
+    }
+}
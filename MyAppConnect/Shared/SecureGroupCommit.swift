@@ -0,0 +1,308 @@
+//
+//  SecureGroupCommit.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import AppConnect
+
+/// Group commit for atomic secure file writes.
+///
+/// Like -writeToSecureFile:atomically:YES, each write goes to a temporary file that replaces the destination with a
+/// rename, so a reader or a crash sees either the old or the new contents of a file, never a mix. Writes that arrive
+/// while a commit is in progress are committed together by the next one: their temporary files are synced, a single
+/// F_FULLFSYNC barrier makes them all durable, they are renamed (with ACSecureFileRename for AppConnect files), and
+/// one more barrier after syncing their directories makes the renames durable. A burst of small documents therefore
+/// pays two device flushes per batch instead of one or more per file.
+///
+/// A crash can leave temporary files behind. The first write into a directory removes the ones an earlier run left
+/// there.
+final class SecureGroupCommit {
+    enum Format {
+        /// AppConnect secure file, as written by -writeToSecureFile:atomically:.
+        case appConnect(encryptionGroupId: String?)
+        case chunked(SecureFileKeyDomain)
+    }
+
+    struct Statistics {
+        var commits = 0
+        var files = 0
+    }
+
+    /// Points in a commit at which a test can stop it, see `init(keyProvider:crashPoint:)`.
+    enum Step {
+        /// The temporary files are durable but nothing has been renamed.
+        case synced
+        /// The renames have happened but the directories have not been synced.
+        case renamed
+    }
+
+    static let shared = SecureGroupCommit()
+
+    /// When the first instance was created; temporary files modified before it were left by an earlier run.
+    private static let launchDate = Date()
+
+    private let keyProvider: SecureFileKeyProvider
+    private let crashPoint: Step?
+
+    private final class Entry {
+        let path: String
+        let temporaryPath: String
+        let format: Format
+        var error: Error?
+        var isDone = false
+
+        init(path: String, temporaryPath: String, format: Format) {
+            self.path = path
+            self.temporaryPath = temporaryPath
+            self.format = format
+        }
+    }
+
+    private let condition = NSCondition()
+    private var queued: [Entry] = []
+    private var isCommitting = false
+    private var stats = Statistics()
+    private var sweptDirectories = Set<String>()
+
+    /// `crashPoint` is for tests: every batch is abandoned after that step, leaving the files as a crash there would,
+    /// and its writes fail with ECANCELED.
+    init(keyProvider: SecureFileKeyProvider = AppConnectKeyProvider.shared, crashPoint: Step? = nil) {
+        _ = SecureGroupCommit.launchDate
+        self.keyProvider = keyProvider
+        self.crashPoint = crashPoint
+    }
+
+    var statistics: Statistics {
+        condition.lock()
+        defer { condition.unlock() }
+        return stats
+    }
+
+    /// Atomically replaces the file at `path` with `data` and returns once the new contents are durable. Encryption
+    /// happens on the calling thread; only the sync and rename steps are shared with concurrent writers.
+    func write(_ data: Data, toPath path: String, format: Format = .appConnect(encryptionGroupId: nil)) throws {
+        let entry = Entry(path: path, temporaryPath: SecureGroupCommit.temporaryPath(for: path), format: format)
+        removeOrphans(in: (path as NSString).deletingLastPathComponent)
+        do {
+            try SecureGroupCommit.writeTemporary(data, to: entry.temporaryPath, format: format,
+                                                 keyProvider: keyProvider)
+        } catch {
+            unlink(entry.temporaryPath)
+            throw error
+        }
+        try enqueue(entry)
+    }
+
+    /// Commits a temporary file that the caller wrote itself, such as a streamed archive, the way `write(_:toPath:
+    /// format:)` commits its own: it is synced and renamed over `path` together with concurrent writes, and removed if
+    /// the commit fails. Name it with `temporaryPath(for:)`, so that it is in the same directory as `path` and a crash
+    /// before the commit leaves a file the next run removes.
+    func commitTemporaryFile(atPath temporaryPath: String, toPath path: String,
+                             format: Format = .appConnect(encryptionGroupId: nil)) throws {
+        removeOrphans(in: (path as NSString).deletingLastPathComponent)
+        try enqueue(Entry(path: path, temporaryPath: temporaryPath, format: format))
+    }
+
+    /// A new temporary file name next to `path`: ".<name>.<UUID>.tmp".
+    static func temporaryPath(for path: String) -> String {
+        let name = ".\((path as NSString).lastPathComponent).\(UUID().uuidString).tmp"
+        return ((path as NSString).deletingLastPathComponent as NSString).appendingPathComponent(name)
+    }
+
+    /// Queues `entry`, whose temporary file is written, and returns once a commit has included it.
+    private func enqueue(_ entry: Entry) throws {
+        condition.lock()
+        queued.append(entry)
+        while !entry.isDone {
+            if isCommitting {
+                condition.wait()
+                continue
+            }
+            // Become the leader and commit everything queued so far, including this entry.
+            isCommitting = true
+            let batch = queued
+            queued.removeAll()
+            condition.unlock()
+            SecureGroupCommit.commit(batch, crashingAfter: crashPoint)
+            condition.lock()
+            stats.commits += 1
+            stats.files += batch.count
+            isCommitting = false
+            condition.broadcast()
+        }
+        condition.unlock()
+
+        if let error = entry.error {
+            throw error
+        }
+    }
+
+    /// Removes the temporary files that a crash in an earlier run left in `directory`. Runs once per directory.
+    private func removeOrphans(in directory: String) {
+        condition.lock()
+        let isFirst = sweptDirectories.insert(directory).inserted
+        condition.unlock()
+        let location = directory.isEmpty ? "." : directory
+        guard isFirst, let names = try? FileManager.default.contentsOfDirectory(atPath: location) else { return }
+
+        let launch = SecureGroupCommit.launchDate.timeIntervalSince1970
+        for name in names where SecureGroupCommit.isTemporaryName(name) {
+            let path = (location as NSString).appendingPathComponent(name)
+            var info = stat()
+            guard lstat(path, &info) == 0 else { continue }
+            let modified = TimeInterval(info.st_mtimespec.tv_sec) + TimeInterval(info.st_mtimespec.tv_nsec) / 1e9
+            if modified < launch {
+                unlink(path)
+            }
+        }
+    }
+
+    /// Whether `name` has the form of `temporaryPath(for:)`.
+    static func isTemporaryName(_ name: String) -> Bool {
+        guard name.hasPrefix("."), name.hasSuffix(".tmp") else { return false }
+        let stem = name.dropLast(4)
+        return stem.count > 38 && stem.dropLast(36).hasSuffix(".") && UUID(uuidString: String(stem.suffix(36))) != nil
+    }
+
+    private static func writeTemporary(_ data: Data, to path: String, format: Format,
+                                       keyProvider: SecureFileKeyProvider) throws {
+        switch format {
+        case .chunked(let domain):
+            let file = try SecureChunkedFile(path: path, flags: O_RDWR | O_CREAT | O_EXCL, domain: domain,
+                                             keyProvider: keyProvider)
+            defer { file.close() }
+            try file.write(data, at: 0)
+        case .appConnect(let groupId):
+            let fd: Int32
+            if let groupId = groupId {
+                fd = SharedSecureFileOpen(path, groupId, O_WRONLY | O_CREAT | O_EXCL, 0o600)
+            } else {
+                fd = SecureFileOpen(path, O_WRONLY | O_CREAT | O_EXCL, 0o600)
+            }
+            guard fd >= 0 else {
+                throw ACSecureFileSource.error(errno)
+            }
+            var failure: Error?
+            data.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+                var done = 0
+                while done < bytes.count {
+                    let count = ACSecureFileWrite(fd, bytes.baseAddress! + done, bytes.count - done)
+                    if count < 0 {
+                        if errno == EINTR { continue }
+                        failure = ACSecureFileSource.error(errno)
+                        return
+                    }
+                    done += count
+                }
+            }
+            if ACSecureFileClose(fd) != 0 && failure == nil {
+                failure = ACSecureFileSource.error(errno)
+            }
+            if let failure = failure {
+                throw failure
+            }
+        }
+    }
+
+    /// Syncs, renames and syncs again. Each entry succeeds or fails on its own; a failed entry leaves its destination
+    /// untouched and its temporary file removed.
+    private static func commit(_ batch: [Entry], crashingAfter crashPoint: Step?) {
+        defer {
+            for entry in batch {
+                entry.isDone = true
+            }
+        }
+
+        // 1. Push every temporary file to the device, then flush the device cache once.
+        var barrierFD: Int32 = -1
+        for entry in batch {
+            let fd = Darwin.open(entry.temporaryPath, O_RDONLY | O_CLOEXEC)
+            if fd < 0 || fsync(fd) != 0 {
+                fail(entry, SecureFileError.posix())
+            }
+            if fd >= 0 {
+                if barrierFD >= 0 {
+                    Darwin.close(barrierFD)
+                }
+                barrierFD = fd
+            }
+        }
+        if barrierFD >= 0 {
+            let error = fullSync(barrierFD) ? nil : SecureFileError.posix()
+            Darwin.close(barrierFD)
+            if let error = error {
+                batch.filter { $0.error == nil }.forEach { fail($0, error) }
+            }
+        }
+        guard crashPoint != .synced else {
+            abandon(batch)
+            return
+        }
+
+        // 2. Rename, so each destination flips from old to new contents in one step.
+        var directories = Set<String>()
+        for entry in batch where entry.error == nil {
+            switch entry.format {
+            case .appConnect:
+                if ACSecureFileRename(entry.temporaryPath, entry.path) != 0 {
+                    fail(entry, ACSecureFileSource.error(errno))
+                }
+            case .chunked:
+                if Darwin.rename(entry.temporaryPath, entry.path) != 0 {
+                    fail(entry, SecureFileError.posix())
+                }
+            }
+            guard entry.error == nil else { continue }
+            directories.insert((entry.path as NSString).deletingLastPathComponent)
+        }
+        guard crashPoint != .renamed else {
+            abandon(batch)
+            return
+        }
+
+        // 3. Push the directories to the device and make the renames durable with one more barrier. The renames have
+        // happened by now, so a failure here is reported but leaves the new contents in place.
+        barrierFD = -1
+        for directory in directories {
+            let fd = Darwin.open(directory.isEmpty ? "." : directory, O_RDONLY | O_CLOEXEC)
+            if fd < 0 || fsync(fd) != 0 {
+                let error = SecureFileError.posix()
+                batch.filter { $0.error == nil && ($0.path as NSString).deletingLastPathComponent == directory }
+                    .forEach { $0.error = error }
+            }
+            if fd >= 0 {
+                if barrierFD >= 0 {
+                    Darwin.close(barrierFD)
+                }
+                barrierFD = fd
+            }
+        }
+        if barrierFD >= 0 {
+            let error = fullSync(barrierFD) ? nil : SecureFileError.posix()
+            Darwin.close(barrierFD)
+            if let error = error {
+                batch.filter { $0.error == nil }.forEach { $0.error = error }
+            }
+        }
+    }
+
+    /// Stops a batch as a crash would: whatever is on disk stays there, temporary files included.
+    private static func abandon(_ batch: [Entry]) {
+        batch.filter { $0.error == nil }.forEach { $0.error = SecureFileError.posix(ECANCELED) }
+    }
+
+    private static func fail(_ entry: Entry, _ error: Error) {
+        guard entry.error == nil else { return }
+        entry.error = error
+        unlink(entry.temporaryPath)
+    }
+
+    /// F_FULLFSYNC flushes the device's write cache, which plain fsync does not on Darwin.
+    private static func fullSync(_ fd: Int32) -> Bool {
+        return fcntl(fd, F_FULLFSYNC) != -1
+    }
+}
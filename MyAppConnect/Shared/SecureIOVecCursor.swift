@@ -0,0 +1,74 @@
+//
+//  SecureIOVecCursor.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+
+/// Position within an iovec array, used to gather plaintext from or scatter plaintext into the caller's buffers
+/// without first coalescing them.
+struct SecureIOVecCursor {
+    private let vectors: UnsafeBufferPointer<iovec>
+    private var index = 0
+    private var offset = 0
+    private(set) var remaining: Int
+
+    init(_ vectors: UnsafeBufferPointer<iovec>) {
+        self.vectors = vectors
+        remaining = vectors.reduce(0) { $0 + $1.iov_len }
+        skipEmpty()
+    }
+
+    /// The next `count` bytes, if they all lie within the current vector.
+    func contiguous(_ count: Int) -> UnsafeMutableRawBufferPointer? {
+        guard index < vectors.count, let base = vectors[index].iov_base, vectors[index].iov_len - offset >= count else {
+            return nil
+        }
+        return UnsafeMutableRawBufferPointer(start: base + offset, count: count)
+    }
+
+    mutating func advance(by count: Int) {
+        var left = count
+        while left > 0 {
+            let step = min(left, vectors[index].iov_len - offset)
+            offset += step
+            left -= step
+            skipEmpty()
+        }
+        remaining -= count
+    }
+
+    /// Copies the next `destination.count` bytes into `destination`.
+    mutating func gather(into destination: UnsafeMutableRawBufferPointer) {
+        var done = 0
+        while done < destination.count {
+            let step = min(destination.count - done, vectors[index].iov_len - offset)
+            UnsafeMutableRawBufferPointer(rebasing: destination[done..<(done + step)])
+                .copyMemory(from: UnsafeRawBufferPointer(start: vectors[index].iov_base! + offset, count: step))
+            done += step
+            advance(by: step)
+        }
+    }
+
+    /// Copies `source` into the next `source.count` bytes.
+    mutating func scatter(from source: UnsafeRawBufferPointer) {
+        var done = 0
+        while done < source.count {
+            let step = min(source.count - done, vectors[index].iov_len - offset)
+            UnsafeMutableRawBufferPointer(start: vectors[index].iov_base! + offset, count: step)
+                .copyMemory(from: UnsafeRawBufferPointer(rebasing: source[done..<(done + step)]))
+            done += step
+            advance(by: step)
+        }
+    }
+
+    private mutating func skipEmpty() {
+        while index < vectors.count && offset == vectors[index].iov_len {
+            index += 1
+            offset = 0
+        }
+    }
+}
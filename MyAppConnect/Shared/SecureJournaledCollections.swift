@@ -0,0 +1,219 @@
+//
+//  SecureJournaledCollections.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import AppConnect
+
+/// NSMutableArray kept in an AppConnect secure file, saved incrementally.
+///
+/// -writeToSecureFile:atomically: rewrites the whole array on every save. Here `save()` appends only the changes made
+/// since the previous save to a `SecureCollectionJournal`, and loading replays them on top of the base file. Once the
+/// journal outgrows the base, a save folds it back in by rewriting the base as a binary property list, which
+/// +arrayWithContentsOfSecureFile:error: still reads. Elements must be property list objects. Not thread-safe, like
+/// NSMutableArray itself.
+final class SecureJournaledArray {
+    let path: String
+
+    private let storage: NSMutableArray
+    private let journal: SecureCollectionJournal
+    private var pending: [Any] = []
+
+    init(contentsOfSecureFile path: String) throws {
+        let base = try SecureCollectionJournal.readBase(atPath: path)
+        let storage = NSMutableArray()
+        if let base = base {
+            let list = try PropertyListSerialization.propertyList(from: base, format: nil)
+            guard let contents = list as? [Any] else {
+                throw CocoaError(.propertyListReadCorrupt)
+            }
+            storage.addObjects(from: contents)
+        }
+        let journal = SecureCollectionJournal(basePath: path)
+        try journal.open(base: base) { try SecureJournaledArray.apply($0, to: storage) }
+        self.path = path
+        self.storage = storage
+        self.journal = journal
+    }
+
+    var count: Int {
+        return storage.count
+    }
+
+    /// Snapshot of the current contents.
+    var array: NSArray {
+        return storage.copy() as! NSArray
+    }
+
+    subscript(index: Int) -> Any {
+        get {
+            return storage[index]
+        }
+        set {
+            storage.replaceObject(at: index, with: newValue)
+            pending.append(["s", index, newValue])
+        }
+    }
+
+    func append(_ element: Any) {
+        storage.add(element)
+        pending.append(["a", element])
+    }
+
+    func insert(_ element: Any, at index: Int) {
+        storage.insert(element, at: index)
+        pending.append(["i", index, element])
+    }
+
+    func remove(at index: Int) {
+        storage.removeObject(at: index)
+        pending.append(["r", index])
+    }
+
+    func removeAll() {
+        storage.removeAllObjects()
+        pending = [["c"]]
+    }
+
+    /// Makes the changes since the last save durable with one journal append, compacting when the journal has grown
+    /// larger than the base. Unsaved changes are kept for the next attempt if this fails.
+    func save() throws {
+        guard !pending.isEmpty else { return }
+        try journal.append(pending)
+        pending.removeAll()
+        if journal.needsCompaction {
+            try compact()
+        }
+    }
+
+    /// Rewrites the base with the current contents, discarding the journal.
+    func compact() throws {
+        let contents = try PropertyListSerialization.data(fromPropertyList: storage, format: .binary, options: 0)
+        try journal.replaceBase(with: contents)
+        pending.removeAll()
+    }
+
+    private static func apply(_ operation: Any, to storage: NSMutableArray) throws {
+        guard let operation = operation as? [Any], let code = operation.first as? String else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        let index = operation.count > 1 ? operation[1] as? Int : nil
+        switch (code, operation.count) {
+        case ("a", 2):
+            storage.add(operation[1])
+        case ("i", 3):
+            guard let index = index, index >= 0, index <= storage.count else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            storage.insert(operation[2], at: index)
+        case ("s", 3):
+            guard let index = index, index >= 0, index < storage.count else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            storage.replaceObject(at: index, with: operation[2])
+        case ("r", 2):
+            guard let index = index, index >= 0, index < storage.count else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            storage.removeObject(at: index)
+        case ("c", 1):
+            storage.removeAllObjects()
+        default:
+            throw SecureFileError.badKeyOrCorruptData
+        }
+    }
+}
+
+/// NSMutableDictionary kept in an AppConnect secure file, saved incrementally like `SecureJournaledArray`. Keys are
+/// strings and values property list objects.
+final class SecureJournaledDictionary {
+    let path: String
+
+    private let storage: NSMutableDictionary
+    private let journal: SecureCollectionJournal
+    private var pending: [Any] = []
+
+    init(contentsOfSecureFile path: String) throws {
+        let base = try SecureCollectionJournal.readBase(atPath: path)
+        let storage = NSMutableDictionary()
+        if let base = base {
+            let list = try PropertyListSerialization.propertyList(from: base, format: nil)
+            guard let contents = list as? [AnyHashable: Any] else {
+                throw CocoaError(.propertyListReadCorrupt)
+            }
+            storage.addEntries(from: contents)
+        }
+        let journal = SecureCollectionJournal(basePath: path)
+        try journal.open(base: base) { try SecureJournaledDictionary.apply($0, to: storage) }
+        self.path = path
+        self.storage = storage
+        self.journal = journal
+    }
+
+    var count: Int {
+        return storage.count
+    }
+
+    /// Snapshot of the current contents.
+    var dictionary: NSDictionary {
+        return storage.copy() as! NSDictionary
+    }
+
+    /// Setting nil removes the key.
+    subscript(key: String) -> Any? {
+        get {
+            return storage[key]
+        }
+        set {
+            if let value = newValue {
+                storage[key] = value
+                pending.append(["s", key, value])
+            } else {
+                storage.removeObject(forKey: key)
+                pending.append(["r", key])
+            }
+        }
+    }
+
+    func removeAll() {
+        storage.removeAllObjects()
+        pending = [["c"]]
+    }
+
+    /// See `SecureJournaledArray.save()`.
+    func save() throws {
+        guard !pending.isEmpty else { return }
+        try journal.append(pending)
+        pending.removeAll()
+        if journal.needsCompaction {
+            try compact()
+        }
+    }
+
+    func compact() throws {
+        let contents = try PropertyListSerialization.data(fromPropertyList: storage, format: .binary, options: 0)
+        try journal.replaceBase(with: contents)
+        pending.removeAll()
+    }
+
+    private static func apply(_ operation: Any, to storage: NSMutableDictionary) throws {
+        guard let operation = operation as? [Any], let code = operation.first as? String else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        let key = operation.count > 1 ? operation[1] as? String : nil
+        switch (code, operation.count, key) {
+        case ("s", 3, let key?):
+            storage[key] = operation[2]
+        case ("r", 2, let key?):
+            storage.removeObject(forKey: key)
+        case ("c", 1, nil):
+            storage.removeAllObjects()
+        default:
+            throw SecureFileError.badKeyOrCorruptData
+        }
+    }
+}
@@ -0,0 +1,107 @@
+//
+//  SecureKeyCache.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import CryptoKit
+
+/// Bounded, thread-safe cache of keys derived from other keys.
+///
+/// Key bytes are kept in `SecureBuffer`s and wiped when an entry is evicted or the cache is flushed. When the
+/// cache is full, the least recently used entry is evicted. Each lookup passes the generation of the keys it derives
+/// from, see `DerivedKeyService.currentGeneration()`: a newer generation flushes the cache, and a key derived under an
+/// older one is returned without being cached.
+final class SecureKeyCache<Key: Hashable> {
+    struct Statistics {
+        var hits = 0
+        var misses = 0
+        var evictions = 0
+        var flushes = 0
+
+        var hitRate: Double {
+            let lookups = hits + misses
+            return lookups == 0 ? 0 : Double(hits) / Double(lookups)
+        }
+    }
+
+    private struct Entry {
+        let bytes: SecureBuffer
+        var lastUse: UInt64
+    }
+
+    let capacity: Int
+
+    private var entries: [Key: Entry] = [:]
+    private var clock: UInt64 = 0
+    private var generation: UInt64 = 0
+    private var stats = Statistics()
+    private let lock = NSLock()
+
+    init(capacity: Int) {
+        self.capacity = max(capacity, 1)
+    }
+
+    var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// Returns the cached key for `key`, or derives it with `derive` and caches it. `derive` runs without the cache
+    /// lock, so concurrent misses for the same key may each derive it; the first result is cached.
+    func key(for key: Key, generation: UInt64 = 0, derive: () throws -> SymmetricKey) rethrows -> SymmetricKey {
+        lock.lock()
+        if generation > self.generation {
+            removeAllLocked()
+            self.generation = generation
+        }
+        clock += 1
+        if let entry = entries[key] {
+            stats.hits += 1
+            entries[key]?.lastUse = clock
+            lock.unlock()
+            return SymmetricKey(data: UnsafeRawBufferPointer(entry.bytes.bytes))
+        }
+        stats.misses += 1
+        lock.unlock()
+
+        let derived = try derive()
+
+        lock.lock()
+        defer { lock.unlock() }
+        guard generation == self.generation, entries[key] == nil else { return derived }
+        if entries.count >= capacity, let oldest = entries.min(by: { $0.value.lastUse < $1.value.lastUse }) {
+            entries[oldest.key] = nil
+            stats.evictions += 1
+        }
+        // Without memory for the entry the key is returned uncached.
+        guard let bytes = try? SecureBuffer(count: derived.bitCount / 8) else { return derived }
+        derived.withUnsafeBytes { bytes.bytes.copyMemory(from: $0) }
+        entries[key] = Entry(bytes: bytes, lastUse: clock)
+        return derived
+    }
+
+    func remove(_ key: Key) {
+        lock.lock()
+        defer { lock.unlock() }
+        entries[key] = nil
+    }
+
+    /// Drops and wipes every cached key.
+    func removeAll() {
+        lock.lock()
+        defer { lock.unlock() }
+        removeAllLocked()
+    }
+
+    private func removeAllLocked() {
+        if !entries.isEmpty {
+            stats.flushes += 1
+        }
+        entries.removeAll()
+    }
+}
@@ -0,0 +1,341 @@
+//
+//  SecureKeyValueSegment.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+
+/// Record encoding shared by the log and the segments of a `SecureKeyValueStore`: a little-endian 32 bit key length,
+/// a 32 bit value length (all ones for a deletion), the key and the value. Keys are never empty, so a zero key length
+/// marks the end of the records.
+enum SecureKeyValueCodec {
+    static let tombstone = UInt32.max
+
+    static func encodedSize(key: Data, value: Data?) -> Int {
+        return 8 + key.count + (value?.count ?? 0)
+    }
+
+    static func append(key: Data, value: Data?, to data: inout Data) {
+        append(UInt32(key.count), to: &data)
+        append(value.map { UInt32($0.count) } ?? tombstone, to: &data)
+        data.append(key)
+        if let value = value {
+            data.append(value)
+        }
+    }
+
+    static func append<T: FixedWidthInteger>(_ value: T, to data: inout Data) {
+        withUnsafeBytes(of: value.littleEndian) { data.append(contentsOf: $0) }
+    }
+
+    /// Decodes the record at `offset` and moves `offset` past it. Returns nil at the end of the records or when
+    /// `data` ends inside the record.
+    static func record(in data: Data, at offset: inout Int) -> (key: Data, value: Data?)? {
+        guard let keyLength = integer(UInt32.self, in: data, at: offset), keyLength > 0,
+            let valueLength = integer(UInt32.self, in: data, at: offset + 4) else {
+            return nil
+        }
+        let keyStart = offset + 8
+        let valueStart = keyStart + Int(keyLength)
+        let end = valueStart + (valueLength == tombstone ? 0 : Int(valueLength))
+        guard end <= data.count else { return nil }
+        let base = data.startIndex
+        let key = Data(data[(base + keyStart)..<(base + valueStart)])
+        let value = valueLength == tombstone ? nil : Data(data[(base + valueStart)..<(base + end)])
+        offset = end
+        return (key, value)
+    }
+
+    static func integer<T: FixedWidthInteger>(_ type: T.Type, in data: Data, at offset: Int) -> T? {
+        let size = MemoryLayout<T>.size
+        guard offset >= 0, offset + size <= data.count else { return nil }
+        var value: T = 0
+        for index in (0..<size).reversed() {
+            value = value << 8 | T(data[data.startIndex + offset + index])
+        }
+        return value
+    }
+
+    static func precedes(_ lhs: Data, _ rhs: Data) -> Bool {
+        return lhs.lexicographicallyPrecedes(rhs)
+    }
+}
+
+/// Bloom filter over the keys of one segment, about 1% false positives at 10 bits per key.
+struct SecureBloomFilter {
+    static let bitsPerKey = 10
+
+    let bits: Data
+    let hashCount: Int
+
+    init(bits: Data, hashCount: Int) {
+        self.bits = bits
+        self.hashCount = hashCount
+    }
+
+    /// Builds a filter from the `hash(_:)` of every key.
+    init(hashes: [UInt64]) {
+        let bitCount = max(hashes.count * SecureBloomFilter.bitsPerKey, 64)
+        var bytes = [UInt8](repeating: 0, count: (bitCount + 7) / 8)
+        let hashCount = SecureBloomFilter.bitsPerKey * 69 / 100
+        for hash in hashes {
+            SecureBloomFilter.forEachBit(of: hash, hashCount: hashCount, bitCount: bytes.count * 8) {
+                bytes[$0 >> 3] |= 1 << UInt8($0 & 7)
+            }
+        }
+        self.init(bits: Data(bytes), hashCount: hashCount)
+    }
+
+    func mayContain(_ key: Data) -> Bool {
+        guard !bits.isEmpty else { return true }
+        var found = true
+        SecureBloomFilter.forEachBit(of: SecureBloomFilter.hash(key), hashCount: hashCount, bitCount: bits.count * 8) {
+            if bits[bits.startIndex + $0 >> 3] & (1 << UInt8($0 & 7)) == 0 {
+                found = false
+            }
+        }
+        return found
+    }
+
+    /// 64 bit FNV-1a.
+    static func hash(_ key: Data) -> UInt64 {
+        var hash: UInt64 = 0xcbf2_9ce4_8422_2325
+        for byte in key {
+            hash = (hash ^ UInt64(byte)) &* 0x100_0000_01b3
+        }
+        return hash
+    }
+
+    /// Double hashing: probe `i` is h1 + i * h2, with both halves taken from one 64 bit hash.
+    private static func forEachBit(of hash: UInt64, hashCount: Int, bitCount: Int, _ body: (Int) -> Void) {
+        var probe = hash & 0xffff_ffff
+        let step = hash >> 32 | 1
+        for _ in 0..<hashCount {
+            body(Int(probe % UInt64(bitCount)))
+            probe = probe &+ step
+        }
+    }
+}
+
+/// Immutable sorted run of a `SecureKeyValueStore`, stored as a secure chunked file.
+///
+/// Records are grouped into blocks of at most `blockSize` bytes, and every block starts on a chunk boundary of a file
+/// whose chunk size is `blockSize`. The block index and the bloom filter are loaded when the segment is opened, so a
+/// point lookup either stops at the filter or decrypts the single chunk holding its block. The file ends with the
+/// index, the filter and a fixed-size footer locating them.
+final class SecureKeyValueSegment {
+    static let blockSize = 4096
+    static let footerSize = 40
+    private static let magic: UInt32 = 0x3153_5641
+
+    private struct Block {
+        let firstKey: Data
+        let offset: UInt64
+        let length: Int
+    }
+
+    let path: String
+    let entryCount: UInt64
+    private let file: SecureChunkedFile
+    private let blocks: [Block]
+    private let filter: SecureBloomFilter
+
+    init(path: String, domain: SecureFileKeyDomain,
+         keyProvider: SecureFileKeyProvider = AppConnectKeyProvider.shared) throws {
+        let file = try SecureChunkedFile(path: path, flags: O_RDONLY, domain: domain, keyProvider: keyProvider)
+        let length = file.length
+        guard length >= UInt64(SecureKeyValueSegment.footerSize) else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        let footer = try file.read(length: SecureKeyValueSegment.footerSize,
+                                   at: length - UInt64(SecureKeyValueSegment.footerSize))
+        guard let indexOffset = SecureKeyValueCodec.integer(UInt64.self, in: footer, at: 0),
+            let indexLength = SecureKeyValueCodec.integer(UInt32.self, in: footer, at: 8),
+            let filterOffset = SecureKeyValueCodec.integer(UInt64.self, in: footer, at: 12),
+            let filterLength = SecureKeyValueCodec.integer(UInt32.self, in: footer, at: 20),
+            let hashCount = SecureKeyValueCodec.integer(UInt32.self, in: footer, at: 24),
+            let entryCount = SecureKeyValueCodec.integer(UInt64.self, in: footer, at: 28),
+            SecureKeyValueCodec.integer(UInt32.self, in: footer, at: 36) == SecureKeyValueSegment.magic,
+            indexOffset + UInt64(indexLength) <= length, filterOffset + UInt64(filterLength) <= length else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+
+        let index = try file.read(length: Int(indexLength), at: indexOffset)
+        var blocks: [Block] = []
+        var offset = 0
+        while offset < index.count {
+            guard let keyLength = SecureKeyValueCodec.integer(UInt32.self, in: index, at: offset),
+                offset + 4 + Int(keyLength) + 12 <= index.count else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            let keyStart = index.startIndex + offset + 4
+            let firstKey = Data(index[keyStart..<(keyStart + Int(keyLength))])
+            offset += 4 + Int(keyLength)
+            blocks.append(Block(firstKey: firstKey,
+                                offset: SecureKeyValueCodec.integer(UInt64.self, in: index, at: offset)!,
+                                length: Int(SecureKeyValueCodec.integer(UInt32.self, in: index, at: offset + 8)!)))
+            offset += 12
+        }
+        let bits = try file.read(length: Int(filterLength), at: filterOffset)
+
+        self.path = path
+        self.entryCount = entryCount
+        self.file = file
+        self.blocks = blocks
+        filter = SecureBloomFilter(bits: bits, hashCount: Int(hashCount))
+    }
+
+    /// Looks `key` up: nil when the segment does not mention it, `.some(nil)` when it records a deletion.
+    func value(for key: Data) throws -> Data?? {
+        guard filter.mayContain(key) else { return nil }
+        // The last block whose first key is not after `key`.
+        var low = 0
+        var high = blocks.count
+        while low < high {
+            let middle = (low + high) / 2
+            if SecureKeyValueCodec.precedes(key, blocks[middle].firstKey) {
+                high = middle
+            } else {
+                low = middle + 1
+            }
+        }
+        guard low > 0 else { return nil }
+
+        let block = try readBlock(low - 1)
+        var offset = 0
+        while let record = SecureKeyValueCodec.record(in: block, at: &offset) {
+            if record.key == key {
+                return .some(record.value)
+            }
+            if SecureKeyValueCodec.precedes(key, record.key) {
+                break
+            }
+        }
+        return nil
+    }
+
+    private func readBlock(_ index: Int) throws -> Data {
+        let block = try file.read(length: blocks[index].length, at: blocks[index].offset)
+        guard block.count == blocks[index].length else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        return block
+    }
+
+    // MARK: Cursor
+
+    /// Walks the records of a segment in key order, decrypting one block at a time.
+    final class Cursor {
+        private let segment: SecureKeyValueSegment
+        private var nextBlock = 0
+        private var block = Data()
+        private var offset = 0
+        private(set) var current: (key: Data, value: Data?)?
+
+        init(_ segment: SecureKeyValueSegment) throws {
+            self.segment = segment
+            try advance()
+        }
+
+        func advance() throws {
+            while true {
+                if let record = SecureKeyValueCodec.record(in: block, at: &offset) {
+                    current = record
+                    return
+                }
+                guard nextBlock < segment.blocks.count else {
+                    current = nil
+                    return
+                }
+                block = try segment.readBlock(nextBlock)
+                nextBlock += 1
+                offset = 0
+            }
+        }
+    }
+
+    // MARK: Writing
+
+    /// Writes a new segment from records appended in strictly ascending key order.
+    final class Writer {
+        let path: String
+        private let file: SecureChunkedFile
+        private var block = Data()
+        private var blockFirstKey = Data()
+        private var offset: UInt64 = 0
+        private var blocks: [Block] = []
+        private var hashes: [UInt64] = []
+
+        init(path: String, domain: SecureFileKeyDomain,
+             keyProvider: SecureFileKeyProvider = AppConnectKeyProvider.shared) throws {
+            self.path = path
+            file = try SecureChunkedFile(path: path, flags: O_RDWR | O_CREAT | O_EXCL, domain: domain,
+                                         keyProvider: keyProvider, chunkSize: SecureKeyValueSegment.blockSize,
+                                         cacheBudget: 0)
+        }
+
+        var entryCount: Int {
+            return hashes.count
+        }
+
+        func append(key: Data, value: Data?) throws {
+            let size = SecureKeyValueCodec.encodedSize(key: key, value: value)
+            if !block.isEmpty && block.count + size > SecureKeyValueSegment.blockSize {
+                try flushBlock()
+            }
+            if block.isEmpty {
+                blockFirstKey = key
+            }
+            SecureKeyValueCodec.append(key: key, value: value, to: &block)
+            hashes.append(SecureBloomFilter.hash(key))
+        }
+
+        /// Writes the index, filter and footer and makes the segment durable.
+        func finish() throws {
+            if !block.isEmpty {
+                try flushBlock()
+            }
+            var index = Data()
+            for block in blocks {
+                SecureKeyValueCodec.append(UInt32(block.firstKey.count), to: &index)
+                index.append(block.firstKey)
+                SecureKeyValueCodec.append(block.offset, to: &index)
+                SecureKeyValueCodec.append(UInt32(block.length), to: &index)
+            }
+            let filter = SecureBloomFilter(hashes: hashes)
+            let indexOffset = offset
+            let filterOffset = indexOffset + UInt64(index.count)
+
+            var tail = index
+            tail.append(filter.bits)
+            SecureKeyValueCodec.append(indexOffset, to: &tail)
+            SecureKeyValueCodec.append(UInt32(index.count), to: &tail)
+            SecureKeyValueCodec.append(filterOffset, to: &tail)
+            SecureKeyValueCodec.append(UInt32(filter.bits.count), to: &tail)
+            SecureKeyValueCodec.append(UInt32(filter.hashCount), to: &tail)
+            SecureKeyValueCodec.append(UInt64(hashes.count), to: &tail)
+            SecureKeyValueCodec.append(SecureKeyValueSegment.magic, to: &tail)
+            try file.write(tail, at: indexOffset)
+            try file.synchronize()
+            file.close()
+        }
+
+        /// Closes and removes an unfinished segment.
+        func abandon() {
+            file.close()
+            Darwin.unlink(path)
+        }
+
+        /// Writes the current block at the next chunk boundary.
+        private func flushBlock() throws {
+            try file.write(block, at: offset)
+            blocks.append(Block(firstKey: blockFirstKey, offset: offset, length: block.count))
+            let blockSize = UInt64(SecureKeyValueSegment.blockSize)
+            offset = (offset + UInt64(block.count) + blockSize - 1) / blockSize * blockSize
+            block.removeAll(keepingCapacity: true)
+        }
+    }
+}
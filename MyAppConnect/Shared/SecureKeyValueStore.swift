@@ -0,0 +1,488 @@
+//
+//  SecureKeyValueStore.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+
+/// Embedded log-structured key-value store whose files are all secure chunked files.
+///
+/// Updates are appended to a log and applied to an in-memory table; the whole state is never rewritten, unlike a
+/// dictionary saved with -writeToSecureFile:atomically:. Writers that arrive while a commit is in progress are
+/// committed together by the next one, with a single log append and sync. Each commit starts on a chunk boundary of
+/// the log, so a torn append can only damage the commit that was being written, which was never acknowledged.
+///
+/// When the table reaches `memtableBudget` bytes it is written out as a sorted `SecureKeyValueSegment` on a background
+/// queue and a new log is started. Once `compactionTrigger` segments exist, the same queue merges them into one,
+/// dropping overwritten values and deletions. The manifest naming the live segments and logs is replaced atomically
+/// through `SecureGroupCommit`.
+final class SecureKeyValueStore {
+    static let defaultMemtableBudget = 4 * 1024 * 1024
+    static let compactionTrigger = 4
+    static let logChunkSize = 4096
+
+    struct Statistics {
+        var commits = 0
+        var batches = 0
+        var flushes = 0
+        var compactions = 0
+    }
+
+    let directory: String
+    let domain: SecureFileKeyDomain
+    let memtableBudget: Int
+
+    private let keyProvider: SecureFileKeyProvider
+    /// Replaces the manifest; `SecureGroupCommit.shared` unless the store has its own key provider.
+    private let manifestWriter: SecureGroupCommit
+    private final class PendingBatch {
+        let payload: Data
+        let records: [(key: Data, value: Data?)]
+        var error: Error?
+        var isDone = false
+
+        init(payload: Data, records: [(key: Data, value: Data?)]) {
+            self.payload = payload
+            self.records = records
+        }
+    }
+
+    private let condition = NSCondition()
+    private let worker = DispatchQueue(label: "SecureKeyValueStore", qos: .utility)
+    private var memtable: [Data: Data?] = [:]
+    private var memtableSize = 0
+    private var immutable: [Data: Data?]?
+    /// Newest first.
+    private var segments: [SecureKeyValueSegment] = []
+    private var log: SecureChunkedFile?
+    private var logNumber: UInt64 = 0
+    private var logOffset: UInt64 = 0
+    /// Oldest log the manifest still needs replayed.
+    private var manifestLogNumber: UInt64 = 0
+    private var nextFileNumber: UInt64 = 1
+    private var queued: [PendingBatch] = []
+    private var isCommitting = false
+    private var backgroundError: Error?
+    private var stats = Statistics()
+
+    /// Opens the store in `directory`, creating it if needed, and replays the logs left by the previous session.
+    init(directory: String, domain: SecureFileKeyDomain = .app,
+         keyProvider: SecureFileKeyProvider = AppConnectKeyProvider.shared,
+         memtableBudget: Int = SecureKeyValueStore.defaultMemtableBudget) throws {
+        self.directory = directory
+        self.domain = domain
+        self.keyProvider = keyProvider
+        self.memtableBudget = max(memtableBudget, 1)
+        manifestWriter = keyProvider === AppConnectKeyProvider.shared
+            ? SecureGroupCommit.shared : SecureGroupCommit(keyProvider: keyProvider)
+        try FileManager.default.createDirectory(atPath: directory, withIntermediateDirectories: true, attributes: nil)
+
+        var segmentNumbers: [UInt64] = []
+        if FileManager.default.fileExists(atPath: manifestPath) {
+            let manifest = try SecureChunkedFile(path: manifestPath, flags: O_RDONLY, domain: domain,
+                                                 keyProvider: keyProvider, cacheBudget: 0)
+            let contents = try manifest.read(length: Int(manifest.length), at: 0)
+            manifest.close()
+            guard let logNumber = SecureKeyValueCodec.integer(UInt64.self, in: contents, at: 0),
+                let nextFileNumber = SecureKeyValueCodec.integer(UInt64.self, in: contents, at: 8),
+                let count = SecureKeyValueCodec.integer(UInt32.self, in: contents, at: 16),
+                contents.count == 20 + 8 * Int(count) else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            for index in 0..<Int(count) {
+                segmentNumbers.append(SecureKeyValueCodec.integer(UInt64.self, in: contents, at: 20 + 8 * index)!)
+            }
+            manifestLogNumber = logNumber
+            self.nextFileNumber = nextFileNumber
+        } else {
+            manifestLogNumber = nextFileNumber
+            nextFileNumber += 1
+            try manifestWriter.write(manifestContents(), toPath: manifestPath, format: .chunked(domain))
+        }
+        segments = try segmentNumbers.map {
+            try SecureKeyValueSegment(path: path(segment: $0), domain: domain, keyProvider: keyProvider)
+        }
+
+        // Logs from a rotation whose flush never reached the manifest are replayed too, oldest first.
+        var logNumbers: [UInt64] = []
+        for name in try FileManager.default.contentsOfDirectory(atPath: directory) {
+            if name.hasPrefix("log-"), let number = UInt64(name.dropFirst(4)) {
+                if number >= manifestLogNumber {
+                    logNumbers.append(number)
+                } else {
+                    Darwin.unlink(path(log: number))
+                }
+            } else if name.hasPrefix("segment-"), let number = UInt64(name.dropFirst(8)),
+                !segmentNumbers.contains(number) {
+                Darwin.unlink(path(segment: number))
+            }
+        }
+        logNumbers.sort()
+        nextFileNumber = max(nextFileNumber, (logNumbers.last ?? 0) + 1)
+        for number in logNumbers {
+            try replay(number)
+        }
+        logNumber = logNumbers.last ?? manifestLogNumber
+        let log = try SecureChunkedFile(path: path(log: logNumber), flags: O_RDWR | O_CREAT, domain: domain,
+                                        keyProvider: keyProvider, chunkSize: SecureKeyValueStore.logChunkSize,
+                                        cacheBudget: 0)
+        if log.length > logOffset {
+            try log.truncate(to: logOffset)
+        }
+        self.log = log
+    }
+
+    deinit {
+        // Pending background work retains the store, so there is none left to wait for here.
+        log?.close()
+    }
+
+    var statistics: Statistics {
+        condition.lock()
+        defer { condition.unlock() }
+        return stats
+    }
+
+    // MARK: Reading
+
+    func value(forKey key: Data) throws -> Data? {
+        condition.lock()
+        if let value = memtable[key] {
+            condition.unlock()
+            return value
+        }
+        if let table = immutable, let value = table[key] {
+            condition.unlock()
+            return value
+        }
+        let segments = self.segments
+        condition.unlock()
+
+        for segment in segments {
+            if let value = try segment.value(for: key) {
+                return value
+            }
+        }
+        return nil
+    }
+
+    // MARK: Writing
+
+    func setValue(_ value: Data, forKey key: Data) throws {
+        try write([(key: key, value: value)])
+    }
+
+    func removeValue(forKey key: Data) throws {
+        try write([(key: key, value: nil)])
+    }
+
+    /// Applies `records` atomically, deleting the keys whose value is nil, and returns once they are durable.
+    func write(_ records: [(key: Data, value: Data?)]) throws {
+        guard !records.isEmpty else { return }
+        let limit = Int(SecureKeyValueCodec.tombstone)
+        guard !records.contains(where: { $0.key.isEmpty || $0.key.count >= limit || $0.value?.count ?? 0 >= limit })
+            else {
+            throw SecureFileError.invalidArgument
+        }
+        var payload = Data()
+        for record in records {
+            SecureKeyValueCodec.append(key: record.key, value: record.value, to: &payload)
+        }
+        let batch = PendingBatch(payload: payload, records: records)
+
+        condition.lock()
+        defer { condition.unlock() }
+        // Hold writers back while the previous table is still being written out.
+        while backgroundError == nil && log != nil && immutable != nil && memtableSize >= memtableBudget {
+            condition.wait()
+        }
+        if let error = backgroundError {
+            throw error
+        }
+        guard log != nil else {
+            throw SecureFileError.posix(EBADF)
+        }
+
+        queued.append(batch)
+        while !batch.isDone {
+            if isCommitting {
+                condition.wait()
+                continue
+            }
+            // Become the leader and commit everything queued so far, including this batch.
+            isCommitting = true
+            let group = queued
+            queued.removeAll()
+            commit(group)
+            isCommitting = false
+            condition.broadcast()
+        }
+        if let error = batch.error {
+            throw error
+        }
+    }
+
+    /// Waits for background work and closes the log. Later writes fail with EBADF.
+    func close() {
+        worker.sync {}
+        condition.lock()
+        defer { condition.unlock() }
+        log?.close()
+        log = nil
+        condition.broadcast()
+    }
+
+    /// Called with `condition` locked; drops it while the log is written.
+    private func commit(_ group: [PendingBatch]) {
+        guard let log = log else {
+            for batch in group {
+                batch.error = SecureFileError.posix(EBADF)
+                batch.isDone = true
+            }
+            return
+        }
+        var framed = Data()
+        SecureKeyValueCodec.append(UInt32(group.reduce(0) { $0 + $1.payload.count }), to: &framed)
+        group.forEach { framed.append($0.payload) }
+        let offset = logOffset
+
+        condition.unlock()
+        var failure: Error?
+        do {
+            try log.write(framed, at: offset)
+            try log.synchronize()
+        } catch {
+            failure = error
+            // Drop whatever part of the commit reached the file, so replay cannot pick it up.
+            try? log.truncate(to: offset)
+        }
+        condition.lock()
+
+        if failure == nil {
+            let chunkSize = UInt64(SecureKeyValueStore.logChunkSize)
+            logOffset = (offset + UInt64(framed.count) + chunkSize - 1) / chunkSize * chunkSize
+            for batch in group {
+                for record in batch.records {
+                    apply(record.key, record.value)
+                }
+            }
+            stats.commits += 1
+            stats.batches += group.count
+            rotateIfNeeded()
+        }
+        for batch in group {
+            batch.error = failure
+            batch.isDone = true
+        }
+    }
+
+    private func apply(_ key: Data, _ value: Data?) {
+        if let old = memtable.updateValue(value, forKey: key) {
+            memtableSize -= SecureKeyValueCodec.encodedSize(key: key, value: old)
+        }
+        memtableSize += SecureKeyValueCodec.encodedSize(key: key, value: value)
+    }
+
+    // MARK: Flush and compaction
+
+    /// Called with `condition` locked. Freezes a full table, starts a new log and hands the table to the worker.
+    private func rotateIfNeeded() {
+        guard memtableSize >= memtableBudget, immutable == nil, backgroundError == nil else { return }
+        let number = nextFileNumber
+        let newLog: SecureChunkedFile
+        do {
+            newLog = try SecureChunkedFile(path: path(log: number), flags: O_RDWR | O_CREAT | O_EXCL, domain: domain,
+                                           keyProvider: keyProvider, chunkSize: SecureKeyValueStore.logChunkSize,
+                                           cacheBudget: 0)
+        } catch {
+            // Keep appending to the current log; the next commit tries again.
+            return
+        }
+        nextFileNumber += 1
+        log?.close()
+        log = newLog
+        logNumber = number
+        logOffset = 0
+        immutable = memtable
+        memtable = [:]
+        memtableSize = 0
+        let segmentNumber = nextFileNumber
+        nextFileNumber += 1
+        worker.async {
+            self.flush(segmentNumber: segmentNumber)
+        }
+    }
+
+    private func flush(segmentNumber: UInt64) {
+        condition.lock()
+        let table = immutable ?? [:]
+        condition.unlock()
+
+        do {
+            let records = table.sorted { SecureKeyValueCodec.precedes($0.key, $1.key) }
+            let segment = try writeSegment(segmentNumber) { writer in
+                for record in records {
+                    try writer.append(key: record.key, value: record.value)
+                }
+            }
+
+            condition.lock()
+            if let segment = segment {
+                segments.insert(segment, at: 0)
+            }
+            immutable = nil
+            let obsoleteLogs = manifestLogNumber..<logNumber
+            manifestLogNumber = logNumber
+            let manifest = manifestContents()
+            stats.flushes += 1
+            condition.broadcast()
+            condition.unlock()
+
+            try manifestWriter.write(manifest, toPath: manifestPath, format: .chunked(domain))
+            for number in obsoleteLogs {
+                Darwin.unlink(path(log: number))
+            }
+            try compactIfNeeded()
+        } catch {
+            condition.lock()
+            backgroundError = error
+            condition.broadcast()
+            condition.unlock()
+        }
+    }
+
+    /// Merges every segment into one. Only the worker adds or removes segments, so none appear meanwhile.
+    private func compactIfNeeded() throws {
+        condition.lock()
+        let inputs = segments
+        guard inputs.count >= SecureKeyValueStore.compactionTrigger else {
+            condition.unlock()
+            return
+        }
+        let segmentNumber = nextFileNumber
+        nextFileNumber += 1
+        condition.unlock()
+
+        let cursors = try inputs.map { try SecureKeyValueSegment.Cursor($0) }
+        let segment = try writeSegment(segmentNumber) { writer in
+            while true {
+                // The smallest current key; on ties the newest segment, which comes first, wins.
+                var winner: (key: Data, value: Data?)?
+                for cursor in cursors {
+                    guard let current = cursor.current else { continue }
+                    if winner == nil || SecureKeyValueCodec.precedes(current.key, winner!.key) {
+                        winner = current
+                    }
+                }
+                guard let record = winner else { break }
+                for cursor in cursors where cursor.current?.key == record.key {
+                    try cursor.advance()
+                }
+                // Nothing older remains, so a deletion needs no record.
+                if let value = record.value {
+                    try writer.append(key: record.key, value: value)
+                }
+            }
+        }
+
+        condition.lock()
+        segments = segment.map { [$0] } ?? []
+        let manifest = manifestContents()
+        stats.compactions += 1
+        condition.unlock()
+
+        try manifestWriter.write(manifest, toPath: manifestPath, format: .chunked(domain))
+        // Lookups still holding an input keep reading through its open descriptor.
+        for input in inputs {
+            Darwin.unlink(input.path)
+        }
+    }
+
+    /// Writes the records `fill` appends, in key order, as segment `number`; nil when it appends none.
+    private func writeSegment(_ number: UInt64, _ fill: (SecureKeyValueSegment.Writer) throws -> Void) throws
+        -> SecureKeyValueSegment? {
+        let writer = try SecureKeyValueSegment.Writer(path: path(segment: number), domain: domain,
+                                                      keyProvider: keyProvider)
+        do {
+            try fill(writer)
+            guard writer.entryCount > 0 else {
+                writer.abandon()
+                return nil
+            }
+            try writer.finish()
+            return try SecureKeyValueSegment(path: writer.path, domain: domain, keyProvider: keyProvider)
+        } catch {
+            writer.abandon()
+            throw error
+        }
+    }
+
+    // MARK: Files
+
+    private var manifestPath: String {
+        return (directory as NSString).appendingPathComponent("manifest")
+    }
+
+    private func path(log number: UInt64) -> String {
+        return (directory as NSString).appendingPathComponent("log-\(number)")
+    }
+
+    private func path(segment number: UInt64) -> String {
+        return (directory as NSString).appendingPathComponent("segment-\(number)")
+    }
+
+    /// Oldest needed log, next file number and the live segments, newest first. Called with `condition` locked.
+    private func manifestContents() -> Data {
+        var contents = Data()
+        SecureKeyValueCodec.append(manifestLogNumber, to: &contents)
+        SecureKeyValueCodec.append(nextFileNumber, to: &contents)
+        SecureKeyValueCodec.append(UInt32(segments.count), to: &contents)
+        for segment in segments {
+            let name = (segment.path as NSString).lastPathComponent
+            SecureKeyValueCodec.append(UInt64(name.dropFirst(8)) ?? 0, to: &contents)
+        }
+        return contents
+    }
+
+    /// Applies every commit of log `number` and leaves `logOffset` after the last one.
+    ///
+    /// Only the commit being written when the process died can be torn, and it was never acknowledged, so a commit that
+    /// cannot be read is dropped when it reaches the end of the log. Anywhere else, dropping it would lose the
+    /// acknowledged commits after it, so replay fails and the log is left as it is.
+    private func replay(_ number: UInt64) throws {
+        let log = try SecureChunkedFile(path: path(log: number), flags: O_RDONLY, domain: domain,
+                                        keyProvider: keyProvider, cacheBudget: 0)
+        defer { log.close() }
+        let chunkSize = UInt64(SecureKeyValueStore.logChunkSize)
+        var offset: UInt64 = 0
+        while offset < log.length {
+            // Where the commit ends, as far as is known: its first chunk until the frame has been read.
+            var end = offset + 4
+            do {
+                let contents = try log.read(length: 4, at: offset)
+                guard let length = SecureKeyValueCodec.integer(UInt32.self, in: contents, at: 0), length > 0 else {
+                    throw SecureFileError.badKeyOrCorruptData
+                }
+                end = offset + 4 + UInt64(length)
+                let payload = try log.read(length: Int(length), at: offset + 4)
+                guard payload.count == Int(length) else {
+                    throw SecureFileError.badKeyOrCorruptData
+                }
+                var position = 0
+                while let record = SecureKeyValueCodec.record(in: payload, at: &position) {
+                    apply(record.key, record.value)
+                }
+            } catch {
+                guard (end + chunkSize - 1) / chunkSize * chunkSize >= log.length else {
+                    throw SecureFileError.badKeyOrCorruptData
+                }
+                break
+            }
+            offset = (end + chunkSize - 1) / chunkSize * chunkSize
+        }
+        logOffset = offset
+    }
+}
@@ -0,0 +1,325 @@
+//
+//  SecureLifetimeTracker.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+
+/// Finds sensitive objects that stay alive too long, like AC_SENSITIVE_DATA_MAX_LIFETIME and
+/// AC_SENSITIVE_DATA_MAX_RUN_LOOP_ITERATIONS do for ACSensitiveData, but reporting them instead of raising.
+///
+/// Tracking is cheap enough for production canaries. Registering an object appends a weak reference to a list owned
+/// by the calling thread, so there is no shared lock and no timer per object. A single sweeper drains the thread lists
+/// a few times a second into a timing wheel keyed by deadline; each tick it looks only at the slot that falls due, and
+/// objects released by then have simply left a nil weak reference behind. The wheel spans at most `maxWheelSlots`
+/// ticks; records due later stay in their slot and are looked at once per turn. One registration in every
+/// `sampleInterval` per thread also records the allocation stack.
+///
+/// `shared` reads SECURE_DATA_MAX_LIFETIME (seconds) and SECURE_DATA_MAX_RUN_LOOP_ITERATIONS from the environment;
+/// the AppConnect variables are left alone because setting them makes the SDK raise. Every `SecureBuffer` registers
+/// itself when tracking is enabled; other objects, such as ACSensitiveData instances, can be passed to
+/// `track(_:size:)`.
+final class SecureLifetimeTracker {
+    static let shared = SecureLifetimeTracker(environment: ProcessInfo.processInfo.environment)
+
+    static let defaultSampleInterval = 64
+    static let tickInterval: TimeInterval = 0.25
+    static let maxWheelSlots = 4096
+    /// Longer lifetimes, infinity included, are clamped to this.
+    static let longestLifetime: TimeInterval = 30 * 24 * 60 * 60
+
+    struct Report {
+        let age: TimeInterval
+        let size: Int
+        /// Main run loop iterations since allocation, for objects allocated on the main thread.
+        let runLoopIterations: Int?
+        /// Symbolicated allocation stack, empty unless the registration was sampled.
+        let allocationSite: [String]
+    }
+
+    private final class Record {
+        weak var object: AnyObject?
+        let birth: UInt64
+        let size: Int
+        let birthIteration: Int?
+        let stack: [NSNumber]?
+        var deadlineTick: UInt64 = 0
+        /// Set once the record is in `overdue`, so a record due by both lifetime and run loop is reported once.
+        var isOverdue = false
+
+        init(object: AnyObject, birth: UInt64, size: Int, birthIteration: Int?, stack: [NSNumber]?) {
+            self.object = object
+            self.birth = birth
+            self.size = size
+            self.birthIteration = birthIteration
+            self.stack = stack
+        }
+    }
+
+    /// Registrations of one thread, waiting for the sweeper.
+    private final class ThreadList {
+        let lock = NSLock()
+        var inbox: [Record] = []
+        var registrations = 0
+        var isRetired = false
+    }
+
+    let maxLifetime: TimeInterval?
+    let maxRunLoopIterations: Int?
+    let sampleInterval: Int
+
+    var isEnabled: Bool {
+        return maxLifetime != nil || maxRunLoopIterations != nil
+    }
+
+    private let queue = DispatchQueue(label: "SecureLifetimeTracker", qos: .utility)
+    private var timer: DispatchSourceTimer?
+    private var listKey = pthread_key_t()
+    private var hasListKey = false
+    private let registryLock = NSLock()
+    private var lists: [ThreadList] = []
+
+    private let lifetimeNanoseconds: UInt64
+
+    // Sweeper state, only touched on `queue`.
+    private var wheel: [[Record]] = []
+    private var lastTick: UInt64 = 0
+    /// Main thread records in registration order, and therefore by birth iteration; the first `runLoopHead` have been
+    /// checked already.
+    private var runLoopRecords: [Record] = []
+    private var runLoopHead = 0
+    private var overdue: [Record] = []
+
+    private let iterationLock = NSLock()
+    private var mainIterations = 0
+    private var observer: CFRunLoopObserver?
+
+    init(maxLifetime: TimeInterval?, maxRunLoopIterations: Int?,
+         sampleInterval: Int = SecureLifetimeTracker.defaultSampleInterval) {
+        // NaN fails the comparison and disables the limit.
+        self.maxLifetime = maxLifetime.flatMap { $0 > 0 ? min($0, SecureLifetimeTracker.longestLifetime) : nil }
+        self.maxRunLoopIterations = maxRunLoopIterations.flatMap { $0 > 0 ? $0 : nil }
+        self.sampleInterval = max(sampleInterval, 1)
+        lifetimeNanoseconds = self.maxLifetime.map { UInt64($0 * 1e9) } ?? 0
+        guard isEnabled else { return }
+
+        hasListKey = pthread_key_create(&listKey) { list in
+            let list = Unmanaged<SecureLifetimeTracker.ThreadList>.fromOpaque(list).takeRetainedValue()
+            list.lock.lock()
+            list.isRetired = true
+            list.lock.unlock()
+        } == 0
+        if let lifetime = self.maxLifetime {
+            let ticks = lifetime / SecureLifetimeTracker.tickInterval + 2
+            wheel = Array(repeating: [], count: Int(min(ticks, Double(SecureLifetimeTracker.maxWheelSlots))))
+        }
+        lastTick = SecureLifetimeTracker.tick(of: SecureLifetimeTracker.now())
+        if self.maxRunLoopIterations != nil {
+            installRunLoopObserver()
+        }
+
+        let timer = DispatchSource.makeTimerSource(queue: queue)
+        timer.schedule(deadline: .now() + SecureLifetimeTracker.tickInterval,
+                       repeating: SecureLifetimeTracker.tickInterval)
+        timer.setEventHandler { [weak self] in
+            self?.sweep()
+        }
+        timer.resume()
+        self.timer = timer
+    }
+
+    convenience init(environment: [String: String]) {
+        self.init(maxLifetime: environment["SECURE_DATA_MAX_LIFETIME"].flatMap { TimeInterval($0) },
+                  maxRunLoopIterations: environment["SECURE_DATA_MAX_RUN_LOOP_ITERATIONS"].flatMap { Int($0) })
+    }
+
+    deinit {
+        timer?.cancel()
+        if let observer = observer {
+            CFRunLoopRemoveObserver(CFRunLoopGetMain(), observer, .commonModes)
+        }
+        guard hasListKey else { return }
+        // Deleting the key clears it in every thread without running the destructor, so the lists of threads that are
+        // still running are released here.
+        pthread_key_delete(listKey)
+        registryLock.lock()
+        defer { registryLock.unlock() }
+        for list in lists {
+            list.lock.lock()
+            let isRetired = list.isRetired
+            list.isRetired = true
+            list.lock.unlock()
+            if !isRetired {
+                Unmanaged.passUnretained(list).release()
+            }
+        }
+    }
+
+    /// Starts watching `object`, which holds `size` bytes of sensitive data. Does nothing when tracking is disabled.
+    func track(_ object: AnyObject, size: Int) {
+        guard isEnabled, let list = threadList() else { return }
+        list.registrations += 1
+        let stack = list.registrations % sampleInterval == 1 || sampleInterval == 1
+            ? Thread.callStackReturnAddresses : nil
+        let record = Record(object: object, birth: SecureLifetimeTracker.now(), size: size,
+                            birthIteration: maxRunLoopIterations != nil && Thread.isMainThread ? iterations() : nil,
+                            stack: stack)
+        list.lock.lock()
+        list.inbox.append(record)
+        list.lock.unlock()
+    }
+
+    /// Objects that are still alive past their deadline, oldest first.
+    func overdueInstances() -> [Report] {
+        return queue.sync {
+            sweep()
+            let now = SecureLifetimeTracker.now()
+            let iterations = self.iterations()
+            return overdue.filter { $0.object != nil }.sorted { $0.birth < $1.birth }.map { record in
+                Report(age: TimeInterval(now - record.birth) / 1e9, size: record.size,
+                       runLoopIterations: record.birthIteration.map { iterations - $0 },
+                       allocationSite: record.stack.map(SecureLifetimeTracker.symbolicate) ?? [])
+            }
+        }
+    }
+
+    // MARK: Sweeping
+
+    private func sweep() {
+        let now = SecureLifetimeTracker.now()
+        let currentTick = SecureLifetimeTracker.tick(of: now)
+
+        registryLock.lock()
+        let lists = self.lists
+        registryLock.unlock()
+        var retired: [ObjectIdentifier] = []
+        for list in lists {
+            list.lock.lock()
+            let records = list.inbox
+            list.inbox.removeAll(keepingCapacity: true)
+            if list.isRetired {
+                retired.append(ObjectIdentifier(list))
+            }
+            list.lock.unlock()
+            for record in records where record.object != nil {
+                schedule(record, currentTick: currentTick)
+            }
+        }
+        if !retired.isEmpty {
+            registryLock.lock()
+            self.lists.removeAll { retired.contains(ObjectIdentifier($0)) }
+            registryLock.unlock()
+        }
+
+        if !wheel.isEmpty && currentTick > lastTick {
+            for tick in (lastTick + 1)...min(currentTick, lastTick + UInt64(wheel.count)) {
+                let slot = Int(tick % UInt64(wheel.count))
+                var pending: [Record] = []
+                for record in wheel[slot] where record.object != nil {
+                    if record.deadlineTick <= currentTick {
+                        markOverdue(record)
+                    } else {
+                        pending.append(record)
+                    }
+                }
+                wheel[slot] = pending
+            }
+        }
+        lastTick = max(lastTick, currentTick)
+
+        // Only the oldest records can have hit the limit, so each tick looks at just the ones that are due.
+        if let limit = maxRunLoopIterations {
+            let iterations = self.iterations()
+            while runLoopHead < runLoopRecords.count,
+                iterations - runLoopRecords[runLoopHead].birthIteration! >= limit {
+                let record = runLoopRecords[runLoopHead]
+                runLoopHead += 1
+                if record.object != nil {
+                    markOverdue(record)
+                }
+            }
+            if runLoopHead * 2 >= runLoopRecords.count {
+                runLoopRecords.removeFirst(runLoopHead)
+                runLoopHead = 0
+            }
+        }
+        overdue.removeAll { $0.object == nil }
+    }
+
+    private func markOverdue(_ record: Record) {
+        guard !record.isOverdue else { return }
+        record.isOverdue = true
+        overdue.append(record)
+    }
+
+    private func schedule(_ record: Record, currentTick: UInt64) {
+        if record.birthIteration != nil {
+            runLoopRecords.append(record)
+        }
+        guard maxLifetime != nil else { return }
+        record.deadlineTick = SecureLifetimeTracker.tick(of: record.birth + lifetimeNanoseconds) + 1
+        if record.deadlineTick <= currentTick {
+            markOverdue(record)
+        } else {
+            wheel[Int(record.deadlineTick % UInt64(wheel.count))].append(record)
+        }
+    }
+
+    // MARK: Threads and run loop
+
+    /// The calling thread's list, or nil if no thread key could be created.
+    private func threadList() -> ThreadList? {
+        guard hasListKey else { return nil }
+        if let list = pthread_getspecific(listKey) {
+            return Unmanaged<ThreadList>.fromOpaque(list).takeUnretainedValue()
+        }
+        let list = ThreadList()
+        pthread_setspecific(listKey, Unmanaged.passRetained(list).toOpaque())
+        registryLock.lock()
+        lists.append(list)
+        registryLock.unlock()
+        return list
+    }
+
+    private func installRunLoopObserver() {
+        let observer = CFRunLoopObserverCreateWithHandler(nil, CFRunLoopActivity.beforeTimers.rawValue, true, 0) {
+            [weak self] _, _ in
+            guard let self = self else { return }
+            self.iterationLock.lock()
+            self.mainIterations += 1
+            self.iterationLock.unlock()
+        }
+        CFRunLoopAddObserver(CFRunLoopGetMain(), observer, .commonModes)
+        self.observer = observer
+    }
+
+    private func iterations() -> Int {
+        iterationLock.lock()
+        defer { iterationLock.unlock() }
+        return mainIterations
+    }
+
+    private static func now() -> UInt64 {
+        return DispatchTime.now().uptimeNanoseconds
+    }
+
+    private static func tick(of time: UInt64) -> UInt64 {
+        return time / UInt64(tickInterval * 1e9)
+    }
+
+    private static func symbolicate(_ addresses: [NSNumber]) -> [String] {
+        return addresses.map { number in
+            var info = Dl_info()
+            guard let address = UnsafeRawPointer(bitPattern: number.uintValue), dladdr(address, &info) != 0,
+                let symbol = info.dli_sname else {
+                return String(format: "0x%lx", number.uintValue)
+            }
+            let image = info.dli_fname.map { (String(cString: $0) as NSString).lastPathComponent } ?? "?"
+            let offset = Int(bitPattern: address) - Int(bitPattern: info.dli_saddr)
+            return "\(image) \(String(cString: symbol)) + \(offset)"
+        }
+    }
+}
@@ -0,0 +1,266 @@
+//
+//  SecureMappedView.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import UIKit
+import AppConnect
+
+/// Plaintext that can be read at arbitrary offsets.
+protocol SecureRandomAccessSource: AnyObject {
+    func plaintextLength() throws -> UInt64
+
+    /// Reads up to `buffer.count` bytes at `offset`; returns fewer only at the end of the file.
+    func read(into buffer: UnsafeMutableRawBufferPointer, at offset: UInt64) throws -> Int
+}
+
+extension SecureChunkedFile: SecureRandomAccessSource {
+    func plaintextLength() throws -> UInt64 {
+        return length
+    }
+}
+
+extension ACSecureFileSource: SecureRandomAccessSource {
+    func plaintextLength() throws -> UInt64 {
+        return try length()
+    }
+}
+
+/// Read-only view of a secure file that decrypts a page only the first time it is touched.
+///
+/// This is what NSDataReadingMappedIfSafe means for ciphertext: opening a large file costs nothing, and reading a few
+/// bytes decrypts just the page that holds them. At most `residentBudget` bytes of decrypted pages stay resident; the
+/// least recently used page is dropped to make room for a new one, and `purge()`, which runs on every memory warning,
+/// drops them all. A dropped page is wiped and returned to `SecureArena` once no caller still holds it, and is
+/// decrypted again on the next touch.
+final class SecureMappedView {
+    static let defaultPageSize = SecureChunkedFile.defaultChunkSize
+    static let defaultResidentBudget = 64 * defaultPageSize
+    /// Largest range `withUnsafeBytes(in:_:)` assembles when it spans pages; use `enumerateBytes(in:_:)` beyond it.
+    static let maximumAssembledRange = 256 * 1024
+
+    struct Statistics {
+        /// Pages decrypted, including pages decrypted again after being dropped.
+        var faults = 0
+        var hits = 0
+        var evictions = 0
+    }
+
+    private final class Entry {
+        let index: Int
+        let page: SecureBuffer
+        var newer: Entry?
+        weak var older: Entry?
+
+        init(index: Int, page: SecureBuffer) {
+            self.index = index
+            self.page = page
+        }
+    }
+
+    let count: Int
+    let pageSize: Int
+    let residentBudget: Int
+
+    private let source: SecureRandomAccessSource
+    /// Resident pages, linked from least to most recently used.
+    private var pages: [Int: Entry] = [:]
+    private var oldest: Entry?
+    private weak var newest: Entry?
+    private var residentBytes = 0
+    private let lock = NSLock()
+    private var stats = Statistics()
+    private var memoryWarningObserver: NSObjectProtocol?
+
+    /// Maps `source`. Use the chunk size as `pageSize` for a `SecureChunkedFile` so that a fault decrypts one chunk.
+    /// At most about `residentBudget` bytes of plaintext stay resident.
+    init(source: SecureRandomAccessSource, pageSize: Int = SecureMappedView.defaultPageSize,
+         residentBudget: Int = SecureMappedView.defaultResidentBudget) throws {
+        guard pageSize > 0, residentBudget >= 0 else {
+            throw SecureFileError.invalidArgument
+        }
+        let length = try source.plaintextLength()
+        guard length <= UInt64(Int.max) else {
+            throw SecureFileError.appConnect(ACErrorFileTooBig)
+        }
+        self.source = source
+        self.pageSize = pageSize
+        self.residentBudget = residentBudget
+        count = Int(length)
+        memoryWarningObserver = NotificationCenter.default.addObserver(
+            forName: UIApplication.didReceiveMemoryWarningNotification, object: nil, queue: nil) { [weak self] _ in
+            self?.purge()
+        }
+    }
+
+    deinit {
+        if let observer = memoryWarningObserver {
+            NotificationCenter.default.removeObserver(observer)
+        }
+    }
+
+    var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// Calls `body` with the plaintext in `range`. A range within one page is passed without copying; a range that
+    /// spans pages is assembled in a temporary buffer that is wiped afterwards, and may be at most
+    /// `maximumAssembledRange` bytes long.
+    func withUnsafeBytes<R>(in range: Range<Int>, _ body: (UnsafeRawBufferPointer) throws -> R) throws -> R {
+        guard range.lowerBound >= 0, range.upperBound <= count else {
+            throw SecureFileError.invalidArgument
+        }
+        guard !range.isEmpty else {
+            return try body(UnsafeRawBufferPointer(start: nil, count: 0))
+        }
+        let first = range.lowerBound / pageSize
+        if (range.upperBound - 1) / pageSize == first {
+            let page = try self.page(first)
+            let start = range.lowerBound - first * pageSize
+            return try body(UnsafeRawBufferPointer(rebasing: page.bytes[start..<(start + range.count)]))
+        }
+        guard range.count <= SecureMappedView.maximumAssembledRange else {
+            throw SecureFileError.invalidArgument
+        }
+        let buffer = try SecureBuffer(count: range.count)
+        defer { buffer.wipe() }
+        _ = try copyBytes(to: buffer.bytes, from: range.lowerBound)
+        return try body(UnsafeRawBufferPointer(buffer.bytes))
+    }
+
+    /// Calls `body` with the plaintext of `range` one page at a time, with the offset of each run, like
+    /// -[NSData enumerateByteRangesUsingBlock:]. Nothing is copied, so any range length is fine.
+    func enumerateBytes(in range: Range<Int>, _ body: (UnsafeRawBufferPointer, Int) throws -> Void) throws {
+        guard range.lowerBound >= 0, range.upperBound <= count else {
+            throw SecureFileError.invalidArgument
+        }
+        var position = range.lowerBound
+        while position < range.upperBound {
+            let page = try self.page(position / pageSize)
+            let within = position % pageSize
+            let span = min(page.count - within, range.upperBound - position)
+            try body(UnsafeRawBufferPointer(rebasing: page.bytes[within..<(within + span)]), position)
+            position += span
+        }
+    }
+
+    /// Copies up to `destination.count` bytes at `offset`; returns the number copied, short only at the end.
+    func copyBytes(to destination: UnsafeMutableRawBufferPointer, from offset: Int) throws -> Int {
+        guard offset >= 0 else {
+            throw SecureFileError.invalidArgument
+        }
+        let total = max(0, min(destination.count, count - offset))
+        var done = 0
+        while done < total {
+            let position = offset + done
+            let page = try self.page(position / pageSize)
+            let within = position % pageSize
+            let span = min(page.count - within, total - done)
+            UnsafeMutableRawBufferPointer(rebasing: destination[done..<(done + span)])
+                .copyMemory(from: UnsafeRawBufferPointer(rebasing: page.bytes[within..<(within + span)]))
+            done += span
+        }
+        return total
+    }
+
+    func subdata(in range: Range<Int>) throws -> Data {
+        var data = Data(capacity: range.count)
+        try enumerateBytes(in: range) { bytes, _ in data.append(contentsOf: bytes) }
+        return data
+    }
+
+    /// Drops every resident page. Runs on every memory warning.
+    func purge() {
+        lock.lock()
+        defer { lock.unlock() }
+        pages.removeAll()
+        oldest = nil
+        newest = nil
+        residentBytes = 0
+    }
+
+    /// Returns page `index`, decrypting it if it is not resident. The caller's reference keeps the page alive even if
+    /// it is dropped meanwhile.
+    private func page(_ index: Int) throws -> SecureBuffer {
+        lock.lock()
+        defer { lock.unlock() }
+        if let entry = pages[index] {
+            moveToNewest(entry)
+            stats.hits += 1
+            return entry.page
+        }
+
+        let start = index * pageSize
+        let page = try SecureBuffer(count: min(pageSize, count - start))
+        var filled = 0
+        while filled < page.count {
+            let read = try source.read(into: UnsafeMutableRawBufferPointer(rebasing: page.bytes[filled...]),
+                                       at: UInt64(start + filled))
+            guard read > 0 else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            filled += read
+        }
+        stats.faults += 1
+        while residentBytes + page.count > residentBudget, let victim = oldest {
+            unlink(victim)
+            pages[victim.index] = nil
+            residentBytes -= victim.page.count
+            stats.evictions += 1
+        }
+        if page.count <= residentBudget {
+            let entry = Entry(index: index, page: page)
+            pages[index] = entry
+            link(entry)
+            residentBytes += page.count
+        }
+        return page
+    }
+
+    // MARK: Recency list
+
+    private func link(_ entry: Entry) {
+        entry.older = newest
+        entry.newer = nil
+        newest?.newer = entry
+        newest = entry
+        if oldest == nil {
+            oldest = entry
+        }
+    }
+
+    private func unlink(_ entry: Entry) {
+        let older = entry.older
+        let newer = entry.newer
+        older?.newer = newer
+        newer?.older = older
+        if oldest === entry {
+            oldest = newer
+        }
+        if newest === entry {
+            newest = older
+        }
+        entry.newer = nil
+        entry.older = nil
+    }
+
+    private func moveToNewest(_ entry: Entry) {
+        guard newest !== entry else { return }
+        unlink(entry)
+        link(entry)
+    }
+}
+
+extension FileManager {
+    /// Lazily decrypting counterpart of +dataWithContentsOfSecureFile:options:error: with NSDataReadingMappedIfSafe.
+    func mappedSecureContents(atPath path: String, encryptionGroupId: String? = nil,
+                              pageSize: Int = SecureMappedView.defaultPageSize) throws -> SecureMappedView {
+        let source = try ACSecureFileSource(path: path, encryptionGroupId: encryptionGroupId)
+        return try SecureMappedView(source: source, pageSize: pageSize)
+    }
+}
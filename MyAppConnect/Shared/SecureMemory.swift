@@ -0,0 +1,84 @@
+//
+//  SecureMemory.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import AppConnect
+
+/// Wiping and comparing sensitive memory.
+enum SecureMemory {
+    /// Zeroes `bytes` with memset_s, which the compiler may not drop as a dead store and which runs on the vectorized
+    /// libc memset.
+    static func wipe(_ bytes: UnsafeMutableRawBufferPointer) {
+        guard let base = bytes.baseAddress, bytes.count > 0 else { return }
+        _ = memset_s(base, bytes.count, 0, bytes.count)
+    }
+
+    /// Compares two buffers in time that depends only on their length, never on where they differ. Works on 64 bytes
+    /// at a time in four 16 byte vectors, which the compiler maps to NEON or SSE2 registers.
+    static func constantTimeEqual(_ lhs: UnsafeRawBufferPointer, _ rhs: UnsafeRawBufferPointer) -> Bool {
+        guard lhs.count == rhs.count else { return false }
+        let count = lhs.count
+        var difference0 = SIMD16<UInt8>()
+        var difference1 = SIMD16<UInt8>()
+        var difference2 = SIMD16<UInt8>()
+        var difference3 = SIMD16<UInt8>()
+        var offset = 0
+        while offset + 64 <= count {
+            difference0 |= vector(lhs, offset) ^ vector(rhs, offset)
+            difference1 |= vector(lhs, offset + 16) ^ vector(rhs, offset + 16)
+            difference2 |= vector(lhs, offset + 32) ^ vector(rhs, offset + 32)
+            difference3 |= vector(lhs, offset + 48) ^ vector(rhs, offset + 48)
+            offset += 64
+        }
+        while offset + 16 <= count {
+            difference0 |= vector(lhs, offset) ^ vector(rhs, offset)
+            offset += 16
+        }
+        var tail: UInt8 = 0
+        while offset < count {
+            tail |= lhs[offset] ^ rhs[offset]
+            offset += 1
+        }
+        return ((difference0 | difference1 | difference2 | difference3).max() | tail) == 0
+    }
+
+    static func constantTimeEqual(_ lhs: Data, _ rhs: Data) -> Bool {
+        return lhs.withUnsafeBytes { left in rhs.withUnsafeBytes { right in constantTimeEqual(left, right) } }
+    }
+
+    /// Unaligned 16 byte load.
+    private static func vector(_ bytes: UnsafeRawBufferPointer, _ offset: Int) -> SIMD16<UInt8> {
+        var result = SIMD16<UInt8>()
+        withUnsafeMutableBytes(of: &result) {
+            $0.copyMemory(from: UnsafeRawBufferPointer(rebasing: bytes[offset..<(offset + 16)]))
+        }
+        return result
+    }
+}
+
+extension ACSensitiveData {
+    /// Constant-time equality of the contents, for keys, tokens and MACs.
+    func isEqualInConstantTime(to other: ACSensitiveData) -> Bool {
+        return SecureMemory.constantTimeEqual(UnsafeRawBufferPointer(start: bytes, count: length),
+                                              UnsafeRawBufferPointer(start: other.bytes, count: other.length))
+    }
+}
+
+extension ACSensitiveMutableData {
+    func wipe() {
+        SecureMemory.wipe(UnsafeMutableRawBufferPointer(start: mutableBytes, count: length))
+    }
+
+    /// Changes the length, wiping the bytes that a shrink drops before they leave the logical contents.
+    func setLengthWiping(_ newLength: Int) {
+        if newLength < length {
+            SecureMemory.wipe(UnsafeMutableRawBufferPointer(start: mutableBytes + newLength, count: length - newLength))
+        }
+        length = newLength
+    }
+}
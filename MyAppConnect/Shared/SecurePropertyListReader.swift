@@ -0,0 +1,645 @@
+//
+//  SecurePropertyListReader.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import AppConnect
+
+/// Loads property list dictionaries from AppConnect secure files without holding the whole plaintext in memory.
+///
+/// +dictionaryWithContentsOfSecureFile:error: decrypts the entire file, then parses it, so the plaintext and the parsed
+/// objects are alive at the same time and decryption and parsing run one after the other. Here an XML property list
+/// is decrypted on a background thread into two `SecureBuffer`s that XMLParser consumes as they fill. A binary property
+/// list is read in place through `SecureBinaryPropertyList`, decrypting only the parts of the file that objects live
+/// in, and can also be opened lazily, so that only the top-level keys are read until a value is asked for.
+enum SecurePropertyListReader {
+    static let defaultBufferSize = 64 * 1024
+
+    /// Streaming counterpart of +dictionaryWithContentsOfSecureFile:error:, for XML and binary property lists.
+    static func dictionary(contentsOfSecureFile path: String, encryptionGroupId: String? = nil,
+                           bufferSize: Int = SecurePropertyListReader.defaultBufferSize) throws -> NSDictionary {
+        let source = try ACSecureFileSource(path: path, encryptionGroupId: encryptionGroupId)
+        defer { source.close() }
+        let root: Any
+        if try SecureBinaryPropertyList.isBinary(source) {
+            root = try SecureBinaryPropertyList(source: source).rootObject()
+        } else {
+            root = try parseXML(from: source, bufferSize: bufferSize)
+        }
+        guard let dictionary = root as? NSDictionary else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        return dictionary
+    }
+
+    /// Opens the dictionary reading only its top-level keys. Values of a binary property list are decoded when first
+    /// asked for, and the file stays open until the returned dictionary is released. An XML property list has no
+    /// index to seek by, so it is streamed in full as by `dictionary(contentsOfSecureFile:)`.
+    static func lazyDictionary(contentsOfSecureFile path: String,
+                               encryptionGroupId: String? = nil) throws -> SecureLazyDictionary {
+        let source = try ACSecureFileSource(path: path, encryptionGroupId: encryptionGroupId)
+        guard try SecureBinaryPropertyList.isBinary(source) else {
+            defer { source.close() }
+            guard let dictionary = try parseXML(from: source, bufferSize: defaultBufferSize) as? NSDictionary else {
+                throw CocoaError(.propertyListReadCorrupt)
+            }
+            return SecureLazyDictionary(dictionary: dictionary)
+        }
+        return try SecureLazyDictionary(list: SecureBinaryPropertyList(source: source))
+    }
+
+    /// Parses an XML property list on the calling thread while a background thread decrypts into buffers of
+    /// `bufferSize` bytes.
+    static func parseXML(from source: SecureByteSource, bufferSize: Int) throws -> Any {
+        let stream = try SecureDecryptingInputStream(source: source, bufferSize: bufferSize)
+        let builder = XMLPropertyListBuilder()
+        let parser = XMLParser(stream: stream)
+        parser.delegate = builder
+        let parsed = parser.parse()
+        // Stops the producer when the parser gave up before the end of the file, and wipes the buffers.
+        stream.close()
+
+        if let error = stream.failure {
+            throw error
+        }
+        guard parsed, let root = builder.root else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        return root
+    }
+}
+
+/// Dictionary whose values are decoded from a binary property list the first time they are read.
+final class SecureLazyDictionary {
+    let keys: [String]
+
+    private let list: SecureBinaryPropertyList?
+    private let references: [String: Int]
+    private var values: [String: Any]
+    private let lock = NSLock()
+
+    init(list: SecureBinaryPropertyList) throws {
+        let references = try list.rootDictionaryReferences()
+        self.list = list
+        self.references = references
+        keys = Array(references.keys)
+        values = [:]
+    }
+
+    init(dictionary: NSDictionary) {
+        var values: [String: Any] = [:]
+        for (key, value) in dictionary {
+            values[String(describing: key)] = value
+        }
+        list = nil
+        references = [:]
+        keys = Array(values.keys)
+        self.values = values
+    }
+
+    var count: Int {
+        return keys.count
+    }
+
+    func value(forKey key: String) throws -> Any? {
+        lock.lock()
+        defer { lock.unlock() }
+        if let value = values[key] {
+            return value
+        }
+        guard let list = list, let reference = references[key] else { return nil }
+        let value = try list.object(reference)
+        values[key] = value
+        return value
+    }
+
+    /// Decodes every value that has not been read yet.
+    func materialize() throws -> NSDictionary {
+        let dictionary = NSMutableDictionary(capacity: keys.count)
+        for key in keys {
+            dictionary[key] = try value(forKey: key)
+        }
+        return dictionary
+    }
+}
+
+/// Random-access reader for the bplist00 format.
+///
+/// The trailer at the end of the file locates the offset table, which in turn locates every object, so any object can
+/// be decoded without reading the ones around it. Reads go through a single window of plaintext in a `SecureBuffer`,
+/// which keeps the small, mostly sequential reads of object headers from decrypting the same chunk over and over.
+final class SecureBinaryPropertyList {
+    static let windowSize = 16 * 1024
+    static let maxDepth = 512
+    private static let magic = Array("bplist00".utf8)
+    private static let trailerSize = 32
+
+    private let source: SecureRandomAccessSource
+    private let length: UInt64
+    private let offsetSize: Int
+    private let referenceSize: Int
+    private let objectCount: Int
+    private let rootReference: Int
+    private let offsetTableOffset: UInt64
+    private let window: SecureBuffer
+    private var windowOffset: UInt64 = 0
+    private var windowCount = 0
+    private let lock = NSLock()
+
+    static func isBinary(_ source: SecureRandomAccessSource) throws -> Bool {
+        var header = [UInt8](repeating: 0, count: magic.count)
+        let count = try header.withUnsafeMutableBytes { try source.read(into: $0, at: 0) }
+        return count == magic.count && header == magic
+    }
+
+    init(source: SecureRandomAccessSource) throws {
+        let length = try source.plaintextLength()
+        guard length >= UInt64(SecureBinaryPropertyList.magic.count + SecureBinaryPropertyList.trailerSize) else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        var trailer = [UInt8](repeating: 0, count: SecureBinaryPropertyList.trailerSize)
+        let count = try trailer.withUnsafeMutableBytes {
+            try source.read(into: $0, at: length - UInt64(SecureBinaryPropertyList.trailerSize))
+        }
+        guard count == trailer.count else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        let offsetSize = Int(trailer[6])
+        let referenceSize = Int(trailer[7])
+        let objectCount = SecureBinaryPropertyList.integer(trailer[8..<16])
+        let rootReference = SecureBinaryPropertyList.integer(trailer[16..<24])
+        let offsetTableOffset = SecureBinaryPropertyList.integer(trailer[24..<32])
+        guard (1...8).contains(offsetSize), (1...8).contains(referenceSize), rootReference < objectCount,
+            objectCount <= length, offsetTableOffset < length,
+            offsetTableOffset + objectCount * UInt64(offsetSize) <= length else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        self.source = source
+        self.length = length
+        self.offsetSize = offsetSize
+        self.referenceSize = referenceSize
+        self.objectCount = Int(objectCount)
+        self.rootReference = Int(rootReference)
+        self.offsetTableOffset = offsetTableOffset
+        window = try SecureBuffer(count: Int(min(UInt64(SecureBinaryPropertyList.windowSize), length)))
+    }
+
+    func rootObject() throws -> Any {
+        return try object(rootReference)
+    }
+
+    /// Decodes object `reference` and everything it contains.
+    func object(_ reference: Int) throws -> Any {
+        lock.lock()
+        defer { lock.unlock() }
+        return try decode(reference, depth: 0)
+    }
+
+    /// Keys of the root dictionary, with the references of their values.
+    func rootDictionaryReferences() throws -> [String: Int] {
+        lock.lock()
+        defer { lock.unlock() }
+        let offset = try objectOffset(rootReference)
+        let marker = try bytes(at: offset, count: 1)[0]
+        guard marker >> 4 == 0xD else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        let (count, start) = try containerCount(marker, at: offset)
+        let keys = try references(at: start, count: count)
+        let values = try references(at: start + UInt64(count * referenceSize), count: count)
+        var result: [String: Int] = [:]
+        for (key, value) in zip(keys, values) {
+            guard let name = try decode(key, depth: 1) as? String else {
+                throw CocoaError(.propertyListReadCorrupt)
+            }
+            result[name] = value
+        }
+        return result
+    }
+
+    // MARK: Decoding
+
+    private func decode(_ reference: Int, depth: Int) throws -> Any {
+        guard depth < SecureBinaryPropertyList.maxDepth else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        let offset = try objectOffset(reference)
+        let marker = try bytes(at: offset, count: 1)[0]
+        let low = Int(marker & 0x0F)
+
+        switch marker >> 4 {
+        case 0x0:
+            switch marker {
+            case 0x08:
+                return false
+            case 0x09:
+                return true
+            default:
+                // Null and fill markers never appear in a property list written by CoreFoundation.
+                throw SecureFileError.badKeyOrCorruptData
+            }
+        case 0x1:
+            guard low != 4 else {
+                // CoreFoundation writes values above Int64.max as 16 byte integers whose high half is zero.
+                let raw = try bytes(at: offset + 1, count: 16)
+                guard !raw.prefix(8).contains(where: { $0 != 0 }) else {
+                    throw CocoaError(.propertyListReadCorrupt)
+                }
+                return NSNumber(value: SecureBinaryPropertyList.integer(raw.suffix(8)))
+            }
+            return try NSNumber(value: signedInteger(at: offset + 1, size: 1 << low))
+        case 0x2:
+            let raw = try bytes(at: offset + 1, count: 1 << low)
+            switch low {
+            case 2:
+                return NSNumber(value: Float(bitPattern: UInt32(SecureBinaryPropertyList.integer(raw))))
+            case 3:
+                return NSNumber(value: Double(bitPattern: SecureBinaryPropertyList.integer(raw)))
+            default:
+                throw CocoaError(.propertyListReadCorrupt)
+            }
+        case 0x3:
+            guard marker == 0x33 else {
+                throw CocoaError(.propertyListReadCorrupt)
+            }
+            let raw = try bytes(at: offset + 1, count: 8)
+            return Date(timeIntervalSinceReferenceDate: Double(bitPattern: SecureBinaryPropertyList.integer(raw)))
+        case 0x4:
+            let (count, start) = try containerCount(marker, at: offset)
+            return try bytes(at: start, count: count)
+        case 0x5:
+            let (count, start) = try containerCount(marker, at: offset)
+            guard let string = String(data: try bytes(at: start, count: count), encoding: .ascii) else {
+                throw CocoaError(.propertyListReadCorrupt)
+            }
+            return string
+        case 0x6:
+            let (count, start) = try containerCount(marker, at: offset)
+            guard let string = String(data: try bytes(at: start, count: count * 2), encoding: .utf16BigEndian) else {
+                throw CocoaError(.propertyListReadCorrupt)
+            }
+            return string
+        case 0x8:
+            // Keyed archive UIDs, shown the way PropertyListSerialization shows them.
+            let uid = try unsignedInteger(at: offset + 1, size: low + 1)
+            return ["CF$UID": NSNumber(value: uid)]
+        case 0xA, 0xC:
+            let (count, start) = try containerCount(marker, at: offset)
+            let elements = try references(at: start, count: count).map { try decode($0, depth: depth + 1) }
+            return marker >> 4 == 0xA ? NSArray(array: elements) : NSSet(array: elements)
+        case 0xD:
+            let (count, start) = try containerCount(marker, at: offset)
+            let keys = try references(at: start, count: count)
+            let values = try references(at: start + UInt64(count * referenceSize), count: count)
+            let dictionary = NSMutableDictionary(capacity: count)
+            for (key, value) in zip(keys, values) {
+                guard let name = try decode(key, depth: depth + 1) as? NSCopying else {
+                    throw CocoaError(.propertyListReadCorrupt)
+                }
+                dictionary.setObject(try decode(value, depth: depth + 1), forKey: name)
+            }
+            return dictionary
+        default:
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+    }
+
+    /// Element count of a data, string or container object, and the offset its contents start at.
+    private func containerCount(_ marker: UInt8, at offset: UInt64) throws -> (Int, UInt64) {
+        let low = Int(marker & 0x0F)
+        guard low == 0x0F else {
+            return (low, offset + 1)
+        }
+        let sizeMarker = try bytes(at: offset + 1, count: 1)[0]
+        guard sizeMarker >> 4 == 0x1, sizeMarker & 0x0F <= 3 else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        let size = 1 << Int(sizeMarker & 0x0F)
+        let count = try unsignedInteger(at: offset + 2, size: size)
+        guard count <= length else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        return (Int(count), offset + 2 + UInt64(size))
+    }
+
+    private func references(at offset: UInt64, count: Int) throws -> [Int] {
+        let raw = try bytes(at: offset, count: count * referenceSize)
+        return stride(from: 0, to: raw.count, by: referenceSize).map {
+            Int(SecureBinaryPropertyList.integer(raw[$0..<($0 + referenceSize)]))
+        }
+    }
+
+    private func objectOffset(_ reference: Int) throws -> UInt64 {
+        guard reference >= 0, reference < objectCount else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        let offset = try unsignedInteger(at: offsetTableOffset + UInt64(reference * offsetSize), size: offsetSize)
+        guard offset < offsetTableOffset else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        return offset
+    }
+
+    private func unsignedInteger(at offset: UInt64, size: Int) throws -> UInt64 {
+        let raw = try bytes(at: offset, count: size)
+        // 16 byte integers only ever hold 64 bit values; keep the low half.
+        return SecureBinaryPropertyList.integer(raw.suffix(8))
+    }
+
+    private func signedInteger(at offset: UInt64, size: Int) throws -> Int64 {
+        guard size <= 8 else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        return Int64(bitPattern: try unsignedInteger(at: offset, size: size))
+    }
+
+    /// `count` bytes at `offset`, indexed from zero, served from the window when they fit in one.
+    private func bytes(at offset: UInt64, count: Int) throws -> Data {
+        guard count >= 0, offset + UInt64(count) <= length else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        if count > SecureBinaryPropertyList.windowSize {
+            return try read(at: offset, count: count)
+        }
+        if offset < windowOffset || offset + UInt64(count) > windowOffset + UInt64(windowCount) {
+            let fill = Int(min(UInt64(window.count), length - offset))
+            windowCount = 0
+            let target = UnsafeMutableRawBufferPointer(rebasing: window.bytes[0..<fill])
+            let read = try source.read(into: target, at: offset)
+            guard read == fill else {
+                throw CocoaError(.propertyListReadCorrupt)
+            }
+            windowOffset = offset
+            windowCount = fill
+        }
+        let start = Int(offset - windowOffset)
+        return Data(UnsafeRawBufferPointer(rebasing: window.bytes[start..<(start + count)]))
+    }
+
+    private func read(at offset: UInt64, count: Int) throws -> Data {
+        var data = Data(count: count)
+        let read = try data.withUnsafeMutableBytes { try source.read(into: $0, at: offset) }
+        guard read == count else {
+            throw CocoaError(.propertyListReadCorrupt)
+        }
+        return data
+    }
+
+    /// Big-endian unsigned integer of up to 8 bytes.
+    private static func integer<C: Collection>(_ bytes: C) -> UInt64 where C.Element == UInt8 {
+        return bytes.reduce(0) { $0 << 8 | UInt64($1) }
+    }
+}
+
+/// Builds property list objects from XMLParser events.
+private final class XMLPropertyListBuilder: NSObject, XMLParserDelegate {
+    private(set) var root: Any?
+    private var containers: [AnyObject] = []
+    private var keys: [String?] = []
+    private var text = ""
+    private let dateFormatter = ISO8601DateFormatter()
+
+    func parser(_ parser: XMLParser, didStartElement elementName: String, namespaceURI: String?,
+                qualifiedName: String?, attributes: [String: String] = [:]) {
+        switch elementName {
+        case "dict":
+            containers.append(NSMutableDictionary())
+            keys.append(nil)
+        case "array":
+            containers.append(NSMutableArray())
+            keys.append(nil)
+        case "plist", "true", "false":
+            break
+        case "key", "string", "integer", "real", "date", "data":
+            text = ""
+        default:
+            parser.abortParsing()
+        }
+    }
+
+    func parser(_ parser: XMLParser, foundCharacters string: String) {
+        text += string
+    }
+
+    func parser(_ parser: XMLParser, didEndElement elementName: String, namespaceURI: String?,
+                qualifiedName: String?) {
+        let value: Any?
+        switch elementName {
+        case "plist":
+            return
+        case "dict", "array":
+            // A key without a value.
+            guard keys.removeLast() == nil else {
+                parser.abortParsing()
+                return
+            }
+            value = containers.popLast()
+        case "key":
+            // Keys must alternate with values.
+            guard containers.last is NSMutableDictionary, keys[keys.count - 1] == nil else {
+                parser.abortParsing()
+                return
+            }
+            keys[keys.count - 1] = text
+            return
+        case "string":
+            value = text
+        case "integer":
+            let trimmed = text.trimmingCharacters(in: .whitespacesAndNewlines)
+            value = Int64(trimmed).map { NSNumber(value: $0) } ?? UInt64(trimmed).map { NSNumber(value: $0) }
+        case "real":
+            value = Double(text.trimmingCharacters(in: .whitespacesAndNewlines)).map { NSNumber(value: $0) }
+        case "true":
+            value = true
+        case "false":
+            value = false
+        case "date":
+            value = dateFormatter.date(from: text.trimmingCharacters(in: .whitespacesAndNewlines))
+        case "data":
+            value = Data(base64Encoded: text, options: .ignoreUnknownCharacters)
+        default:
+            value = nil
+        }
+        guard let object = value, add(object) else {
+            parser.abortParsing()
+            return
+        }
+    }
+
+    /// Adds `object` to the innermost container, or makes it the root.
+    private func add(_ object: Any) -> Bool {
+        guard let container = containers.last else {
+            guard root == nil else { return false }
+            root = object
+            return true
+        }
+        if let array = container as? NSMutableArray {
+            array.add(object)
+            return true
+        }
+        guard let dictionary = container as? NSMutableDictionary, let key = keys[keys.count - 1] else {
+            return false
+        }
+        dictionary[key] = object
+        keys[keys.count - 1] = nil
+        return true
+    }
+}
+
+/// InputStream that a background thread fills with decrypted bytes through two `SecureBuffer`s: while XMLParser reads
+/// one, the next is decrypted into the other. A buffer is wiped as soon as it has been read, and both are wiped by
+/// `close()`, which also stops the producer. Only the blocking `read(_:maxLength:)` is supported, which is all
+/// XMLParser uses; the stream cannot be scheduled on a run loop.
+private final class SecureDecryptingInputStream: InputStream {
+    /// The error that stopped the producer, if any.
+    private(set) var failure: Error?
+
+    private let source: SecureByteSource
+    private let buffers: [SecureBuffer]
+    /// Bytes waiting in each buffer; zero while the producer owns it.
+    private var filled = [0, 0]
+    private var readIndex = 0
+    private var readOffset = 0
+    private var isFinished = false
+    private var isCancelled = false
+    private var status = Stream.Status.notOpen
+    private let condition = NSCondition()
+    private let producer = DispatchGroup()
+
+    init(source: SecureByteSource, bufferSize: Int) throws {
+        self.source = source
+        buffers = try [SecureBuffer(count: max(bufferSize, 1)), SecureBuffer(count: max(bufferSize, 1))]
+        super.init(data: Data())
+    }
+
+    override var streamStatus: Stream.Status {
+        condition.lock()
+        defer { condition.unlock() }
+        return status
+    }
+
+    override var streamError: Error? {
+        condition.lock()
+        defer { condition.unlock() }
+        return failure
+    }
+
+    override var hasBytesAvailable: Bool {
+        condition.lock()
+        defer { condition.unlock() }
+        return status == .open
+    }
+
+    override func open() {
+        condition.lock()
+        defer { condition.unlock() }
+        guard status == .notOpen else { return }
+        status = .open
+        DispatchQueue.global(qos: .userInitiated).async(group: producer) {
+            self.produce()
+        }
+    }
+
+    override func close() {
+        condition.lock()
+        isCancelled = true
+        condition.broadcast()
+        condition.unlock()
+        producer.wait()
+
+        condition.lock()
+        defer { condition.unlock() }
+        buffers.forEach { $0.wipe() }
+        filled = [0, 0]
+        status = .closed
+    }
+
+    override func read(_ buffer: UnsafeMutablePointer<UInt8>, maxLength length: Int) -> Int {
+        condition.lock()
+        defer { condition.unlock() }
+        while status == .open && filled[readIndex] == 0 && !isFinished && failure == nil {
+            condition.wait()
+        }
+        guard status == .open else {
+            return status == .atEnd ? 0 : -1
+        }
+        guard filled[readIndex] > 0 else {
+            status = failure == nil ? .atEnd : .error
+            return failure == nil ? 0 : -1
+        }
+        let block = buffers[readIndex]
+        let count = min(length, filled[readIndex] - readOffset)
+        UnsafeMutableRawPointer(buffer).copyMemory(from: block.pointer + readOffset, byteCount: count)
+        readOffset += count
+        if readOffset == filled[readIndex] {
+            SecureBuffer.wipe(UnsafeMutableRawBufferPointer(rebasing: block.bytes[0..<readOffset]))
+            filled[readIndex] = 0
+            readIndex ^= 1
+            readOffset = 0
+            condition.broadcast()
+        }
+        return count
+    }
+
+    override func getBuffer(_ buffer: UnsafeMutablePointer<UnsafeMutablePointer<UInt8>?>,
+                            length len: UnsafeMutablePointer<Int>) -> Bool {
+        return false
+    }
+
+    override func property(forKey key: Stream.PropertyKey) -> Any? {
+        return nil
+    }
+
+    override func setProperty(_ property: Any?, forKey key: Stream.PropertyKey) -> Bool {
+        return false
+    }
+
+    override func schedule(in aRunLoop: RunLoop, forMode mode: RunLoop.Mode) {}
+
+    override func remove(from aRunLoop: RunLoop, forMode mode: RunLoop.Mode) {}
+
+    /// Fills the buffers in turn until the file ends, a read fails or the stream is closed.
+    private func produce() {
+        var index = 0
+        while true {
+            condition.lock()
+            while filled[index] > 0 && !isCancelled {
+                condition.wait()
+            }
+            let isCancelled = self.isCancelled
+            condition.unlock()
+            guard !isCancelled else { return }
+
+            let buffer = buffers[index]
+            var count = 0
+            var error: Error?
+            do {
+                while count < buffer.count {
+                    let read = try source.read(into: UnsafeMutableRawBufferPointer(rebasing: buffer.bytes[count...]))
+                    if read == 0 { break }
+                    count += read
+                }
+            } catch let thrown {
+                error = thrown
+            }
+
+            condition.lock()
+            defer { condition.unlock() }
+            condition.broadcast()
+            if let error = error {
+                failure = error
+                return
+            }
+            guard count > 0 else {
+                isFinished = true
+                return
+            }
+            filled[index] = count
+            index ^= 1
+        }
+    }
+}
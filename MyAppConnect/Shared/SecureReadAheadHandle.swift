@@ -0,0 +1,264 @@
+//
+//  SecureReadAheadHandle.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import AppConnect
+
+/// Sequential reader over an ACFileHandle or ACWrappedFileReadHandle that decrypts ahead of the consumer.
+///
+/// Once `sequentialThreshold` reads in a row have continued where the previous one stopped, a background worker keeps
+/// a bounded ring of decrypted blocks filled, so `readData(ofLength:)` usually returns data that is already
+/// decrypted. The ring starts shallow and doubles, up to `maxDepth` blocks, whenever the consumer has to wait. A seek
+/// discards the ring and falls back to direct reads until sequential access is seen again. Decrypted blocks wait in
+/// `SecureBuffer`s and are wiped as soon as they are consumed or discarded.
+///
+/// The wrapped handle must not be used directly while this reader owns it.
+final class SecureReadAheadHandle {
+    static let defaultBlockSize = 64 * 1024
+    static let defaultMaxDepth = 8
+    static let sequentialThreshold = 2
+
+    struct Statistics {
+        var bytesRead: UInt64 = 0
+        /// Reads that found all their data already decrypted.
+        var hits = 0
+        /// Times a read had to wait for the worker.
+        var stalls = 0
+        var depth = 1
+    }
+
+    let blockSize: Int
+    let maxDepth: Int
+
+    private let handle: ACFileHandle
+    /// Serializes every call on `handle`.
+    private let queue = DispatchQueue(label: "SecureReadAheadHandle", qos: .userInitiated)
+    private let condition = NSCondition()
+    private var ring: [SecureBuffer] = []
+    private var headOffset = 0
+    private var isAtEnd = false
+    private var failure: Error?
+    private var generation = 0
+    private var isFilling = false
+    private var sequentialReads = 0
+    private var position: UInt64
+    private var stats = Statistics()
+
+    init(handle: ACFileHandle, blockSize: Int = SecureReadAheadHandle.defaultBlockSize,
+         maxDepth: Int = SecureReadAheadHandle.defaultMaxDepth) {
+        self.handle = handle
+        self.blockSize = max(blockSize, 1)
+        self.maxDepth = max(maxDepth, 1)
+        position = handle.offsetInFile
+    }
+
+    deinit {
+        condition.lock()
+        generation += 1
+        wipeRingLocked()
+        condition.unlock()
+    }
+
+    var statistics: Statistics {
+        condition.lock()
+        defer { condition.unlock() }
+        return stats
+    }
+
+    var offsetInFile: UInt64 {
+        condition.lock()
+        defer { condition.unlock() }
+        return position
+    }
+
+    /// Reads up to `length` bytes, fewer only at the end of the file or when a read fails after some bytes were read.
+    /// Those bytes are returned and count towards `offsetInFile`; the next call throws the error.
+    func readData(ofLength length: Int) throws -> Data {
+        condition.lock()
+        defer { condition.unlock() }
+        var result = Data(capacity: length)
+        var waited = false
+        let readingAhead = sequentialReads >= SecureReadAheadHandle.sequentialThreshold
+
+        while result.count < length {
+            if let head = ring.first {
+                let count = min(length - result.count, head.count - headOffset)
+                let run = head.bytes[headOffset..<(headOffset + count)]
+                result.append(contentsOf: UnsafeRawBufferPointer(rebasing: run))
+                headOffset += count
+                if headOffset == head.count {
+                    ring.removeFirst().wipe()
+                    headOffset = 0
+                }
+                continue
+            }
+            if let error = failure {
+                guard result.isEmpty else { break }
+                failure = nil
+                throw error
+            }
+            if isAtEnd {
+                break
+            }
+            if !readingAhead {
+                var block: Data
+                do {
+                    block = try readDirectly(length - result.count)
+                } catch {
+                    guard result.isEmpty else {
+                        failure = error
+                        break
+                    }
+                    throw error
+                }
+                if block.isEmpty {
+                    break
+                }
+                result.append(block)
+                SecureBuffer.wipe(&block)
+                continue
+            }
+            if !waited {
+                waited = true
+                stats.stalls += 1
+                stats.depth = min(stats.depth * 2, maxDepth)
+            }
+            startFilling()
+            condition.wait()
+        }
+
+        if readingAhead && !waited {
+            stats.hits += 1
+        }
+        sequentialReads += 1
+        if sequentialReads >= SecureReadAheadHandle.sequentialThreshold {
+            startFilling()
+        }
+        position += UInt64(result.count)
+        stats.bytesRead += UInt64(result.count)
+        return result
+    }
+
+    /// Moves the read position, discarding anything decrypted ahead.
+    func seek(toFileOffset offset: UInt64) {
+        condition.lock()
+        resetLocked()
+        condition.unlock()
+        let handle = self.handle
+        queue.sync {
+            handle.seek(toFileOffset: offset)
+        }
+        condition.lock()
+        position = offset
+        condition.unlock()
+    }
+
+    func close() {
+        condition.lock()
+        resetLocked()
+        isAtEnd = true
+        condition.unlock()
+        let handle = self.handle
+        queue.sync {
+            handle.closeFile()
+        }
+    }
+
+    // MARK: Worker
+
+    private func resetLocked() {
+        generation += 1
+        wipeRingLocked()
+        headOffset = 0
+        isAtEnd = false
+        failure = nil
+        isFilling = false
+        sequentialReads = 0
+        stats.depth = 1
+    }
+
+    private func wipeRingLocked() {
+        for block in ring {
+            block.wipe()
+        }
+        ring.removeAll()
+    }
+
+    /// Called with `condition` locked. Drops the lock while waiting for `queue`, where a worker of a generation made
+    /// stale by a seek may still need it to finish.
+    private func readDirectly(_ length: Int) throws -> Data {
+        let handle = self.handle
+        var error: NSError?
+        condition.unlock()
+        let data = queue.sync { handle.readData(ofLength: length, error: &error) }
+        condition.lock()
+        guard let block = data else {
+            throw error ?? SecureFileError.badKeyOrCorruptData
+        }
+        if block.isEmpty {
+            isAtEnd = true
+        }
+        return block
+    }
+
+    private func startFilling() {
+        guard !isFilling, !isAtEnd, failure == nil, ring.count < stats.depth else { return }
+        isFilling = true
+        let generation = self.generation
+        queue.async { [weak self] in
+            self?.fill(generation)
+        }
+    }
+
+    /// Decrypts blocks until the ring holds `depth` of them, the file ends, or a seek makes this generation stale.
+    private func fill(_ generation: Int) {
+        while true {
+            condition.lock()
+            guard generation == self.generation, ring.count < stats.depth, !isAtEnd, failure == nil else {
+                if generation == self.generation {
+                    isFilling = false
+                }
+                condition.unlock()
+                return
+            }
+            condition.unlock()
+
+            var error: NSError?
+            let data = handle.readData(ofLength: blockSize, error: &error)
+            var block: SecureBuffer?
+            var allocationError: Error?
+            if var data = data, !data.isEmpty {
+                do {
+                    let buffer = try SecureBuffer(count: data.count)
+                    _ = data.copyBytes(to: buffer.bytes)
+                    block = buffer
+                } catch let thrown {
+                    allocationError = thrown
+                }
+                SecureBuffer.wipe(&data)
+            }
+
+            condition.lock()
+            if generation == self.generation {
+                if let block = block {
+                    ring.append(block)
+                } else if let thrown = allocationError {
+                    failure = thrown
+                } else if data != nil {
+                    isAtEnd = true
+                } else {
+                    failure = error ?? SecureFileError.badKeyOrCorruptData
+                }
+                condition.broadcast()
+            } else {
+                block?.wipe()
+            }
+            condition.unlock()
+        }
+    }
+}
@@ -0,0 +1,362 @@
+//
+//  SecureSQLiteVFS.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+import AppConnect
+
+/// SQLite VFS that keeps databases, journals and temporary files in secure chunked files.
+///
+/// The main database file uses chunks of `pageSize` bytes, so with a matching `PRAGMA page_size` every page read or
+/// write decrypts or encrypts exactly one authenticated chunk. Journals and temporary files use the default chunk
+/// size, and since their writes do not line up with chunks, only the main database claims powersafe overwrite. SQLite
+/// keeps its own page cache, so the files are opened without a chunk cache.
+///
+/// Open files live in `SecureFileDescriptorTable.shared`, so connections on different threads never share a lock for
+/// I/O. Everything except opening files, such as deleting them, time and randomness, is passed to the default VFS.
+/// Locks are kept in process: the same database must not be opened from another process, such as an app extension,
+/// at the same time. Only rollback journal modes are supported, because the VFS does not provide shared memory for WAL.
+///
+///     SecureSQLiteVFS.register()
+///     sqlite3_open_v2(path, &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, SecureSQLiteVFS.defaultName)
+enum SecureSQLiteVFS {
+    static let defaultName = "secure-chunked"
+    static let defaultPageSize = 4096
+
+    private final class Configuration {
+        let domain: SecureFileKeyDomain
+        let keyProvider: SecureFileKeyProvider
+        let pageSize: Int
+
+        init(domain: SecureFileKeyDomain, keyProvider: SecureFileKeyProvider, pageSize: Int) {
+            self.domain = domain
+            self.keyProvider = keyProvider
+            self.pageSize = pageSize
+        }
+    }
+
+    /// State behind one sqlite3_file.
+    private final class Connection {
+        /// Descriptor in `SecureFileDescriptorTable.shared`.
+        let descriptor: Int32
+        let path: String
+        let chunkSize: Int
+        let isMainDatabase: Bool
+        let deleteOnClose: Bool
+        var lockLevel = SQLITE_LOCK_NONE
+
+        init(descriptor: Int32, path: String, chunkSize: Int, isMainDatabase: Bool, deleteOnClose: Bool) {
+            self.descriptor = descriptor
+            self.path = path
+            self.chunkSize = chunkSize
+            self.isMainDatabase = isMainDatabase
+            self.deleteOnClose = deleteOnClose
+        }
+    }
+
+    private static let descriptors = SecureFileDescriptorTable.shared
+
+    /// SQLite's lock levels for one database path, shared by every connection of the process.
+    private struct LockState {
+        var openCount = 0
+        var sharedCount = 0
+        var hasReserved = false
+        var hasPending = false
+        var hasExclusive = false
+    }
+
+    private static let registryLock = NSLock()
+    private static var locks: [String: LockState] = [:]
+
+    // Extended result codes, which Swift does not import from sqlite3.h.
+    private static let ioErrorRead = SQLITE_IOERR | (1 << 8)
+    private static let ioErrorShortRead = SQLITE_IOERR | (2 << 8)
+    private static let ioErrorWrite = SQLITE_IOERR | (3 << 8)
+    private static let ioErrorFsync = SQLITE_IOERR | (4 << 8)
+    private static let ioErrorTruncate = SQLITE_IOERR | (6 << 8)
+    private static let ioErrorFstat = SQLITE_IOERR | (7 << 8)
+    private static let ioErrorAuth = SQLITE_IOERR | (28 << 8)
+
+    /// Registers the VFS as `name`, encrypting with the key-encryption key of `domain`. Registering a name that is
+    /// already registered does nothing. Returns an SQLite result code.
+    @discardableResult
+    static func register(name: String = SecureSQLiteVFS.defaultName, domain: SecureFileKeyDomain = .app,
+                         keyProvider: SecureFileKeyProvider = AppConnectKeyProvider.shared,
+                         pageSize: Int = SecureSQLiteVFS.defaultPageSize, makeDefault: Bool = false) -> Int32 {
+        guard pageSize >= 512, pageSize <= 65536, pageSize & (pageSize - 1) == 0 else {
+            return SQLITE_MISUSE
+        }
+        registryLock.lock()
+        defer { registryLock.unlock() }
+        guard sqlite3_vfs_find(name) == nil else { return SQLITE_OK }
+        guard let base = sqlite3_vfs_find(nil) else { return SQLITE_ERROR }
+
+        // Start from a copy of the default VFS, which ignores its own vfs argument outside xOpen.
+        let vfs = UnsafeMutablePointer<sqlite3_vfs>.allocate(capacity: 1)
+        vfs.initialize(to: base.pointee)
+        vfs.pointee.iVersion = min(base.pointee.iVersion, 2)
+        vfs.pointee.szOsFile = Int32(MemoryLayout<sqlite3_file>.stride + MemoryLayout<UnsafeMutableRawPointer>.stride)
+        vfs.pointee.pNext = nil
+        vfs.pointee.zName = UnsafePointer(strdup(name))
+        vfs.pointee.pAppData = Unmanaged.passRetained(
+            Configuration(domain: domain, keyProvider: keyProvider, pageSize: pageSize)).toOpaque()
+        vfs.pointee.xOpen = { vfs, path, file, flags, outFlags in
+            return SecureSQLiteVFS.open(vfs!, path, file!, flags, outFlags)
+        }
+        return sqlite3_vfs_register(vfs, makeDefault ? 1 : 0)
+    }
+
+    // MARK: Files
+
+    private static let methods: UnsafeMutablePointer<sqlite3_io_methods> = {
+        let methods = UnsafeMutablePointer<sqlite3_io_methods>.allocate(capacity: 1)
+        methods.initialize(to: sqlite3_io_methods())
+        methods.pointee.iVersion = 1
+        methods.pointee.xClose = { file in
+            return SecureSQLiteVFS.close(file!)
+        }
+        methods.pointee.xRead = { file, buffer, amount, offset in
+            let connection = SecureSQLiteVFS.connection(file!)
+            let buffer = UnsafeMutableRawBufferPointer(start: buffer, count: Int(amount))
+            var count = 0
+            while count < buffer.count {
+                let read = SecureSQLiteVFS.descriptors.pread(connection.descriptor,
+                                                             UnsafeMutableRawBufferPointer(rebasing: buffer[count...]),
+                                                             offset + off_t(count))
+                guard read >= 0 else {
+                    return SecureSQLiteVFS.resultCode(for: SecureSQLiteVFS.lastError(connection),
+                                                      otherwise: SecureSQLiteVFS.ioErrorRead)
+                }
+                guard read > 0 else { break }
+                count += read
+            }
+            guard count == buffer.count else {
+                SecureBuffer.wipe(UnsafeMutableRawBufferPointer(rebasing: buffer[count...]))
+                return SecureSQLiteVFS.ioErrorShortRead
+            }
+            return SQLITE_OK
+        }
+        methods.pointee.xWrite = { file, buffer, amount, offset in
+            let connection = SecureSQLiteVFS.connection(file!)
+            let buffer = UnsafeRawBufferPointer(start: buffer, count: Int(amount))
+            guard SecureSQLiteVFS.descriptors.pwrite(connection.descriptor, buffer, offset) >= 0 else {
+                return SecureSQLiteVFS.resultCode(for: SecureSQLiteVFS.lastError(connection),
+                                                  otherwise: SecureSQLiteVFS.ioErrorWrite)
+            }
+            return SQLITE_OK
+        }
+        methods.pointee.xTruncate = { file, size in
+            let connection = SecureSQLiteVFS.connection(file!)
+            guard SecureSQLiteVFS.descriptors.ftruncate(connection.descriptor, size) == 0 else {
+                return SecureSQLiteVFS.resultCode(for: SecureSQLiteVFS.lastError(connection),
+                                                  otherwise: SecureSQLiteVFS.ioErrorTruncate)
+            }
+            return SQLITE_OK
+        }
+        methods.pointee.xSync = { file, _ in
+            let connection = SecureSQLiteVFS.connection(file!)
+            guard SecureSQLiteVFS.descriptors.fsync(connection.descriptor) == 0 else {
+                return SecureSQLiteVFS.resultCode(for: SecureSQLiteVFS.lastError(connection),
+                                                  otherwise: SecureSQLiteVFS.ioErrorFsync)
+            }
+            return SQLITE_OK
+        }
+        methods.pointee.xFileSize = { file, size in
+            let length = SecureSQLiteVFS.descriptors.size(SecureSQLiteVFS.connection(file!).descriptor)
+            guard length >= 0 else {
+                return SecureSQLiteVFS.ioErrorFstat
+            }
+            size!.pointee = sqlite3_int64(length)
+            return SQLITE_OK
+        }
+        methods.pointee.xLock = { file, level in
+            return SecureSQLiteVFS.lock(SecureSQLiteVFS.connection(file!), to: level)
+        }
+        methods.pointee.xUnlock = { file, level in
+            SecureSQLiteVFS.unlock(SecureSQLiteVFS.connection(file!), to: level)
+            return SQLITE_OK
+        }
+        methods.pointee.xCheckReservedLock = { file, result in
+            let connection = SecureSQLiteVFS.connection(file!)
+            SecureSQLiteVFS.registryLock.lock()
+            let state = SecureSQLiteVFS.locks[connection.path] ?? LockState()
+            SecureSQLiteVFS.registryLock.unlock()
+            result!.pointee = state.hasReserved || state.hasPending || state.hasExclusive ? 1 : 0
+            return SQLITE_OK
+        }
+        methods.pointee.xFileControl = { _, _, _ in
+            return SQLITE_NOTFOUND
+        }
+        methods.pointee.xSectorSize = { file in
+            return Int32(SecureSQLiteVFS.connection(file!).chunkSize)
+        }
+        methods.pointee.xDeviceCharacteristics = { file in
+            // A write re-encrypts every chunk it overlaps, so a torn write can damage the bytes around it in those
+            // chunks. Only main database pages fill whole chunks; journal records straddle them.
+            return SecureSQLiteVFS.connection(file!).isMainDatabase ? SQLITE_IOCAP_POWERSAFE_OVERWRITE : 0
+        }
+        return methods
+    }()
+
+    private static func open(_ vfs: UnsafeMutablePointer<sqlite3_vfs>, _ name: UnsafePointer<Int8>?,
+                             _ file: UnsafeMutablePointer<sqlite3_file>, _ flags: Int32,
+                             _ outFlags: UnsafeMutablePointer<Int32>?) -> Int32 {
+        file.pointee.pMethods = nil
+        let configuration = Unmanaged<Configuration>.fromOpaque(vfs.pointee.pAppData).takeUnretainedValue()
+        let path = name.map { String(cString: $0) }
+            ?? (NSTemporaryDirectory() as NSString).appendingPathComponent("sqlite-\(UUID().uuidString)")
+
+        var openFlags = flags & SQLITE_OPEN_READWRITE != 0 ? O_RDWR : O_RDONLY
+        if flags & SQLITE_OPEN_CREATE != 0 {
+            openFlags |= O_CREAT
+        }
+        if flags & SQLITE_OPEN_EXCLUSIVE != 0 {
+            openFlags |= O_EXCL
+        }
+        let isMainDatabase = flags & SQLITE_OPEN_MAIN_DB != 0
+        let chunkSize = isMainDatabase ? configuration.pageSize : SecureChunkedFile.defaultChunkSize
+
+        let secureFile: SecureChunkedFile
+        do {
+            secureFile = try SecureChunkedFile(path: path, flags: openFlags, domain: configuration.domain,
+                                               keyProvider: configuration.keyProvider, chunkSize: chunkSize,
+                                               cacheBudget: 0)
+        } catch {
+            return resultCode(for: error, otherwise: SQLITE_CANTOPEN)
+        }
+        let descriptor = descriptors.insert(secureFile)
+        guard descriptor >= 0 else {
+            return SQLITE_CANTOPEN
+        }
+        let connection = Connection(descriptor: descriptor, path: path, chunkSize: secureFile.chunkSize,
+                                    isMainDatabase: isMainDatabase,
+                                    deleteOnClose: name == nil || flags & SQLITE_OPEN_DELETEONCLOSE != 0)
+
+        registryLock.lock()
+        locks[path, default: LockState()].openCount += 1
+        registryLock.unlock()
+
+        slot(file).pointee = Unmanaged.passRetained(connection).toOpaque()
+        file.pointee.pMethods = UnsafePointer(methods)
+        outFlags?.pointee = flags
+        return SQLITE_OK
+    }
+
+    private static func close(_ file: UnsafeMutablePointer<sqlite3_file>) -> Int32 {
+        let connection = Unmanaged<Connection>.fromOpaque(slot(file).pointee).takeRetainedValue()
+        unlock(connection, to: SQLITE_LOCK_NONE)
+        registryLock.lock()
+        locks[connection.path]?.openCount -= 1
+        if locks[connection.path]?.openCount == 0 {
+            locks[connection.path] = nil
+        }
+        registryLock.unlock()
+
+        _ = descriptors.close(connection.descriptor)
+        if connection.deleteOnClose {
+            Darwin.unlink(connection.path)
+        }
+        file.pointee.pMethods = nil
+        return SQLITE_OK
+    }
+
+    /// The Connection pointer stored right after the sqlite3_file base.
+    private static func slot(_ file: UnsafeMutablePointer<sqlite3_file>)
+        -> UnsafeMutablePointer<UnsafeMutableRawPointer> {
+        return UnsafeMutableRawPointer(file).advanced(by: MemoryLayout<sqlite3_file>.stride)
+            .assumingMemoryBound(to: UnsafeMutableRawPointer.self)
+    }
+
+    private static func connection(_ file: UnsafeMutablePointer<sqlite3_file>) -> Connection {
+        return Unmanaged<Connection>.fromOpaque(slot(file).pointee).takeUnretainedValue()
+    }
+
+    /// The error behind the last failed descriptor call of `connection`.
+    private static func lastError(_ connection: Connection) -> NSError {
+        let code = errno
+        let appConnectCode = descriptors.lastError(connection.descriptor)
+        return appConnectCode != 0 ? SecureFileError.appConnect(Int(appConnectCode)) : SecureFileError.posix(code)
+    }
+
+    /// Maps missing keys to SQLITE_AUTH, failed authentication to SQLITE_IOERR_AUTH and anything else to `otherwise`.
+    private static func resultCode(for error: Error, otherwise: Int32) -> Int32 {
+        let error = error as NSError
+        if error.domain == NSPOSIXErrorDomain && error.code == Int(ENOSPC) {
+            return SQLITE_FULL
+        }
+        guard error.domain == ACErrorDomain else { return otherwise }
+        switch error.code {
+        case ACErrorNoKeys:
+            return SQLITE_AUTH
+        case ACErrorBadKeyOrCorruptData:
+            return ioErrorAuth
+        default:
+            return otherwise
+        }
+    }
+
+    // MARK: Locking
+
+    /// Moves `connection` up to `level`, following the lock transitions of os_unix.c. A connection that wants
+    /// EXCLUSIVE while other readers remain keeps PENDING, which stops new readers, and gets SQLITE_BUSY until the
+    /// readers are gone.
+    private static func lock(_ connection: Connection, to level: Int32) -> Int32 {
+        guard connection.lockLevel < level else { return SQLITE_OK }
+        registryLock.lock()
+        defer { registryLock.unlock() }
+        var state = locks[connection.path] ?? LockState()
+        defer { locks[connection.path] = state }
+
+        switch level {
+        case SQLITE_LOCK_SHARED:
+            guard !state.hasPending, !state.hasExclusive else { return SQLITE_BUSY }
+            state.sharedCount += 1
+        case SQLITE_LOCK_RESERVED:
+            guard !state.hasReserved else { return SQLITE_BUSY }
+            state.hasReserved = true
+        case SQLITE_LOCK_EXCLUSIVE:
+            // Take RESERVED on the way, as every holder of PENDING or EXCLUSIVE is expected to hold it too.
+            if connection.lockLevel < SQLITE_LOCK_RESERVED {
+                guard !state.hasReserved else { return SQLITE_BUSY }
+                state.hasReserved = true
+                connection.lockLevel = SQLITE_LOCK_RESERVED
+            }
+            if connection.lockLevel < SQLITE_LOCK_PENDING {
+                guard !state.hasPending else { return SQLITE_BUSY }
+                state.hasPending = true
+                connection.lockLevel = SQLITE_LOCK_PENDING
+            }
+            guard state.sharedCount == 1 else { return SQLITE_BUSY }
+            state.hasExclusive = true
+        default:
+            return SQLITE_MISUSE
+        }
+        connection.lockLevel = level
+        return SQLITE_OK
+    }
+
+    /// Moves `connection` down to `level`, which is SHARED or NONE.
+    private static func unlock(_ connection: Connection, to level: Int32) {
+        guard connection.lockLevel > level else { return }
+        registryLock.lock()
+        defer { registryLock.unlock() }
+        var state = locks[connection.path] ?? LockState()
+        if connection.lockLevel >= SQLITE_LOCK_RESERVED {
+            state.hasReserved = false
+        }
+        if connection.lockLevel >= SQLITE_LOCK_PENDING {
+            state.hasPending = false
+            state.hasExclusive = false
+        }
+        if level == SQLITE_LOCK_NONE {
+            state.sharedCount -= 1
+        }
+        locks[connection.path] = state
+        connection.lockLevel = level
+    }
+}
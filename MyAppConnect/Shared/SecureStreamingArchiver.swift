@@ -0,0 +1,412 @@
+//
+//  SecureStreamingArchiver.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import AppConnect
+
+/// Value tags of the streaming archive format shared by `SecureStreamingArchiver` and `SecureStreamingUnarchiver`.
+enum SecureArchiveTag: UInt8 {
+    case null = 0
+    /// An object or collection written earlier, by its 32 bit position in write order.
+    case reference
+    case string
+    case data
+    case integer
+    case unsignedInteger
+    case double
+    case bool
+    case date
+    case nsNull
+    case array
+    case dictionary
+    case set
+    /// A keyed-coded object: its class name, then key and value pairs up to `SecureArchiveTag.endOfObject`.
+    case object
+
+    static let magic: UInt32 = 0x4153_4341
+    static let version: UInt32 = 1
+    /// Key length that ends the fields of an object.
+    static let endOfObject = UInt16.max
+}
+
+/// Keyed archiver that streams its output into an AppConnect secure file.
+///
+/// NSKeyedArchiver +archiveRootObject:toSecureFile:atomically:error: builds the whole archive in memory before
+/// encrypting it. This coder writes each value as soon as it is encoded, in a compact format of tagged values,
+/// through a `bufferSize` buffer that is handed to ACSecureFileWritev whenever it fills, together with any large data
+/// value so the value is never copied. Memory use is the buffer plus one reference per archived object, which keeps
+/// repeated references and the identities of objects that are still being encoded unique.
+///
+/// Strings, numbers, data, dates, NSNull, arrays, dictionaries and sets are written natively; any other object must
+/// adopt NSCoding and use keyed coding. Because nothing already written can be revised, object references differ from
+/// NSKeyedArchiver in two ways:
+/// - a conditional object is written only when it was already archived unconditionally before that point, and is
+///   decoded as nil when it is archived unconditionally only later;
+/// - no reference, conditional or not, may point at an ancestor that is still being encoded, such as a child's
+///   back-pointer to its parent, because the unarchiver creates an object only after all of its fields. Archiving such
+///   a graph fails with an invalid argument error instead of writing an archive that cannot be read.
+///
+/// The output is not an NSKeyedArchiver archive; read it back with `SecureStreamingUnarchiver`.
+final class SecureStreamingArchiver: NSCoder {
+    static let defaultBufferSize = 64 * 1024
+    /// Data values at least this large bypass the buffer.
+    static let directWriteThreshold = 16 * 1024
+
+    private let fd: Int32
+    private let buffer: SecureBuffer
+    private var used = 0
+    private var objectIdentifiers: [ObjectIdentifier: UInt32] = [:]
+    private var nextIdentifier: UInt32 = 0
+    /// Keeps every registered object alive, so that no identifier can be reused by a new object while archiving.
+    private var objects: [AnyObject] = []
+    /// Identifiers of the collections and objects whose contents are being written.
+    private var encoding: Set<UInt32> = []
+    private var failure: Error?
+
+    private init(fd: Int32, bufferSize: Int) throws {
+        self.fd = fd
+        buffer = try SecureBuffer(count: max(bufferSize, SecureStreamingArchiver.directWriteThreshold))
+        super.init()
+    }
+
+    /// Archives `rootObject` into the AppConnect secure file at `path`. When `atomically` is set the archive is written
+    /// to a temporary file that `SecureGroupCommit` makes durable and renames over `path` with ACSecureFileRename once
+    /// it is complete. NSKeyedUnarchiver +unarchiveObjectWithSecureFile:error: cannot read the result;
+    /// `SecureStreamingUnarchiver` can.
+    static func archiveRootObject(_ rootObject: Any?, toSecureFile path: String, atomically: Bool = true,
+                                  encryptionGroupId: String? = nil,
+                                  bufferSize: Int = SecureStreamingArchiver.defaultBufferSize) throws {
+        let destination = atomically ? SecureGroupCommit.temporaryPath(for: path) : path
+        let flags = O_WRONLY | O_CREAT | (atomically ? O_EXCL : O_TRUNC)
+        let fd: Int32
+        if let groupId = encryptionGroupId {
+            fd = SharedSecureFileOpen(destination, groupId, flags, 0o600)
+        } else {
+            fd = SecureFileOpen(destination, flags, 0o600)
+        }
+        guard fd >= 0 else {
+            throw ACSecureFileSource.error(errno)
+        }
+
+        let archiver: SecureStreamingArchiver
+        do {
+            archiver = try SecureStreamingArchiver(fd: fd, bufferSize: bufferSize)
+        } catch {
+            _ = ACSecureFileClose(fd)
+            Darwin.unlink(destination)
+            throw error
+        }
+        archiver.writeInteger(SecureArchiveTag.magic)
+        archiver.writeInteger(SecureArchiveTag.version)
+        archiver.writeValue(rootObject)
+        archiver.flush()
+        archiver.buffer.wipe()
+        var failure = archiver.failure
+        if ACSecureFileClose(fd) != 0 && failure == nil {
+            failure = ACSecureFileSource.error(errno)
+        }
+        if let failure = failure {
+            Darwin.unlink(destination)
+            throw failure
+        }
+        if atomically {
+            try SecureGroupCommit.shared.commitTemporaryFile(atPath: destination, toPath: path,
+                                                             format: .appConnect(encryptionGroupId: encryptionGroupId))
+        }
+    }
+
+    override var allowsKeyedCoding: Bool {
+        return true
+    }
+
+    // MARK: Keyed coding
+
+    override func encode(_ object: Any?, forKey key: String) {
+        writeKey(key)
+        writeValue(object)
+    }
+
+    /// Writes a reference when `object` was archived before, and nil otherwise, even if it is archived later.
+    override func encodeConditionalObject(_ object: Any?, forKey key: String) {
+        writeKey(key)
+        if let object = object, let identifier = objectIdentifiers[ObjectIdentifier(object as AnyObject)] {
+            writeReference(identifier)
+        } else {
+            writeTag(.null)
+        }
+    }
+
+    override func encode(_ value: Bool, forKey key: String) {
+        writeKey(key)
+        writeTag(.bool)
+        writeInteger(UInt8(value ? 1 : 0))
+    }
+
+    override func encode(_ value: Int, forKey key: String) {
+        encode(Int64(value), forKey: key)
+    }
+
+    override func encode(_ value: Int32, forKey key: String) {
+        encode(Int64(value), forKey: key)
+    }
+
+    override func encode(_ value: Int64, forKey key: String) {
+        writeKey(key)
+        writeTag(.integer)
+        writeInteger(value)
+    }
+
+    override func encode(_ value: Float, forKey key: String) {
+        encode(Double(value), forKey: key)
+    }
+
+    override func encode(_ value: Double, forKey key: String) {
+        writeKey(key)
+        writeTag(.double)
+        writeInteger(value.bitPattern)
+    }
+
+    override func encodeBytes(_ bytes: UnsafePointer<UInt8>?, length: Int, forKey key: String) {
+        writeKey(key)
+        writeData(UnsafeRawBufferPointer(start: bytes, count: bytes == nil ? 0 : length))
+    }
+
+    // Unkeyed coding has no keys to stream by.
+
+    override func encodeValue(ofObjCType type: UnsafePointer<Int8>, at addr: UnsafeRawPointer) {
+        fail(SecureFileError.invalidArgument)
+    }
+
+    override func encode(_ object: Any?) {
+        fail(SecureFileError.invalidArgument)
+    }
+
+    override func encode(_ data: Data) {
+        fail(SecureFileError.invalidArgument)
+    }
+
+    // MARK: Values
+
+    private func writeValue(_ value: Any?) {
+        guard failure == nil else { return }
+        guard let value = value else {
+            writeTag(.null)
+            return
+        }
+        let object = value as AnyObject
+        if let identifier = objectIdentifiers[ObjectIdentifier(object)] {
+            writeReference(identifier)
+            return
+        }
+
+        switch object {
+        case let string as NSString:
+            var text = string as String
+            writeTag(.string)
+            writeInteger(UInt32(text.utf8.count))
+            text.withUTF8 { write(UnsafeRawBufferPointer($0)) }
+        case let number as NSNumber where !(number is NSDecimalNumber):
+            writeNumber(number)
+        case let data as NSData:
+            writeData(UnsafeRawBufferPointer(start: data.bytes, count: data.length))
+        case let date as NSDate:
+            writeTag(.date)
+            writeInteger(date.timeIntervalSinceReferenceDate.bitPattern)
+        case is NSNull:
+            writeTag(.nsNull)
+        case let array as NSArray:
+            let identifier = register(array)
+            writeTag(.array)
+            writeInteger(UInt8(array.isKind(of: NSMutableArray.self) ? 1 : 0))
+            writeInteger(UInt32(array.count))
+            for element in array {
+                writeValue(element)
+            }
+            encoding.remove(identifier)
+        case let dictionary as NSDictionary:
+            let identifier = register(dictionary)
+            writeTag(.dictionary)
+            writeInteger(UInt8(dictionary.isKind(of: NSMutableDictionary.self) ? 1 : 0))
+            writeInteger(UInt32(dictionary.count))
+            for (key, element) in dictionary {
+                writeValue(key)
+                writeValue(element)
+            }
+            encoding.remove(identifier)
+        case let set as NSSet:
+            let identifier = register(set)
+            writeTag(.set)
+            writeInteger(UInt8(set.isKind(of: NSMutableSet.self) ? 1 : 0))
+            writeInteger(UInt32(set.count))
+            for element in set {
+                writeValue(element)
+            }
+            encoding.remove(identifier)
+        default:
+            writeObject(object)
+        }
+    }
+
+    private func writeNumber(_ number: NSNumber) {
+        if CFGetTypeID(number) == CFBooleanGetTypeID() {
+            writeTag(.bool)
+            writeInteger(UInt8(number.boolValue ? 1 : 0))
+        } else if CFNumberIsFloatType(number) {
+            writeTag(.double)
+            writeInteger(number.doubleValue.bitPattern)
+        } else if String(cString: number.objCType) == "Q" && number.uint64Value > UInt64(Int64.max) {
+            writeTag(.unsignedInteger)
+            writeInteger(number.uint64Value)
+        } else {
+            writeTag(.integer)
+            writeInteger(number.int64Value)
+        }
+    }
+
+    /// Writes an NSCoding object: its class, then whatever its -encodeWithCoder: encodes.
+    private func writeObject(_ object: AnyObject) {
+        var replacement: Any? = object
+        if let object = object as? NSObject {
+            replacement = object.replacementObject(for: self)
+        }
+        guard let substitute = replacement else {
+            writeTag(.null)
+            return
+        }
+        guard let coding = substitute as? NSObject & NSCoding else {
+            fail(SecureFileError.invalidArgument)
+            return
+        }
+        if let identifier = objectIdentifiers[ObjectIdentifier(coding)] {
+            objectIdentifiers[ObjectIdentifier(object)] = identifier
+            objects.append(object)
+            writeReference(identifier)
+            return
+        }
+        // Registered before its fields, so that a reference back to it is recognized and rejected.
+        let identifier = register(coding, alias: object)
+        writeTag(.object)
+        writeKey(NSStringFromClass(coding.classForKeyedArchiver ?? type(of: coding)))
+        coding.encode(with: self)
+        writeInteger(SecureArchiveTag.endOfObject)
+        encoding.remove(identifier)
+    }
+
+    /// Gives `object`, and the object it replaced if any, the next identifier, and marks it as being encoded until the
+    /// caller removes it from `encoding`. The unarchiver numbers objects in the same order.
+    private func register(_ object: AnyObject, alias: AnyObject? = nil) -> UInt32 {
+        let identifier = nextIdentifier
+        objectIdentifiers[ObjectIdentifier(object)] = identifier
+        objects.append(object)
+        if let alias = alias, alias !== object {
+            objectIdentifiers[ObjectIdentifier(alias)] = identifier
+            objects.append(alias)
+        }
+        encoding.insert(identifier)
+        nextIdentifier += 1
+        return identifier
+    }
+
+    /// Writes a reference to an object written earlier. The unarchiver creates an object only once its fields are
+    /// decoded, so a reference to one that is still being encoded could never be resolved and fails the archive.
+    private func writeReference(_ identifier: UInt32) {
+        guard !encoding.contains(identifier) else {
+            fail(SecureFileError.invalidArgument)
+            return
+        }
+        writeTag(.reference)
+        writeInteger(identifier)
+    }
+
+    // MARK: Output
+
+    private func writeTag(_ tag: SecureArchiveTag) {
+        writeInteger(tag.rawValue)
+    }
+
+    private func writeKey(_ key: String) {
+        var key = key
+        guard key.utf8.count < Int(SecureArchiveTag.endOfObject) else {
+            fail(SecureFileError.invalidArgument)
+            return
+        }
+        writeInteger(UInt16(key.utf8.count))
+        key.withUTF8 { write(UnsafeRawBufferPointer($0)) }
+    }
+
+    private func writeData(_ bytes: UnsafeRawBufferPointer) {
+        writeTag(.data)
+        writeInteger(UInt64(bytes.count))
+        write(bytes)
+    }
+
+    private func writeInteger<T: FixedWidthInteger>(_ value: T) {
+        withUnsafeBytes(of: value.littleEndian) { write($0) }
+    }
+
+    /// Buffers `bytes`, or hands large runs to ACSecureFileWritev together with the buffer instead of copying them.
+    private func write(_ bytes: UnsafeRawBufferPointer) {
+        guard failure == nil, bytes.count > 0 else { return }
+        if bytes.count >= SecureStreamingArchiver.directWriteThreshold {
+            writeVectors([UnsafeRawBufferPointer(start: buffer.pointer, count: used), bytes])
+            used = 0
+            return
+        }
+        if used + bytes.count > buffer.count {
+            flush()
+        }
+        UnsafeMutableRawBufferPointer(rebasing: buffer.bytes[used..<(used + bytes.count)]).copyMemory(from: bytes)
+        used += bytes.count
+    }
+
+    private func flush() {
+        guard used > 0 else { return }
+        writeVectors([UnsafeRawBufferPointer(start: buffer.pointer, count: used)])
+        used = 0
+    }
+
+    private func writeVectors(_ parts: [UnsafeRawBufferPointer]) {
+        guard failure == nil else { return }
+        let parts = parts.filter { $0.count > 0 }
+        let vectors = parts.map {
+            iovec(iov_base: UnsafeMutableRawPointer(mutating: $0.baseAddress), iov_len: $0.count)
+        }
+        var written: Int
+        repeat {
+            written = ACSecureFileWritev(fd, vectors, Int32(vectors.count))
+        } while written < 0 && errno == EINTR
+        guard written >= 0 else {
+            fail(ACSecureFileSource.error(errno))
+            return
+        }
+        // Finish a short write one part at a time.
+        for part in parts {
+            guard written < part.count else {
+                written -= part.count
+                continue
+            }
+            var done = written
+            written = 0
+            while done < part.count {
+                let count = ACSecureFileWrite(fd, part.baseAddress! + done, part.count - done)
+                if count < 0 {
+                    if errno == EINTR { continue }
+                    fail(ACSecureFileSource.error(errno))
+                    return
+                }
+                done += count
+            }
+        }
+    }
+
+    private func fail(_ error: Error) {
+        if failure == nil {
+            failure = error
+        }
+    }
+}
@@ -0,0 +1,371 @@
+//
+//  SecureStreamingUnarchiver.swift
+//  MyAppConnect
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import Foundation
+import AppConnect
+
+/// Reads archives written by `SecureStreamingArchiver` back from an AppConnect secure file.
+///
+/// The file is decrypted through one `bufferSize` buffer rather than loaded whole. Each object's fields are decoded
+/// before the object itself is created with -initWithCoder:, so a field may refer to any object that was complete by
+/// then; the archiver refuses to write references to unfinished ancestors.
+///
+/// Decoding always requires secure coding, as with +unarchivedObjectOfClasses:fromData:error:. An object is created
+/// only when its class supports NSSecureCoding and is one of the allowed classes or a subclass of one. Strings,
+/// numbers, data, dates, NSNull and collections are archived natively and always allowed inside the root object.
+final class SecureStreamingUnarchiver: NSCoder {
+    /// Deepest nesting of collections and objects accepted, so a corrupt archive cannot exhaust the stack.
+    static let maxDepth = 512
+    /// First bytes of a binary property list, which is what NSKeyedArchiver writes.
+    private static let keyedArchiveMagic = Data("bplist00".utf8)
+
+    private let source: ACSecureFileSource
+    private let buffer: SecureBuffer
+    private let allowedClasses: [AnyClass]
+    private var start = 0
+    private var end = 0
+    /// Decoded objects and collections by identifier; nil while one is still being decoded.
+    private var objects: [AnyObject?] = []
+    /// Fields of the objects whose -initWithCoder: is running, innermost last.
+    private var fields: [[String: Any?]] = []
+    private var depth = 0
+    private var failure: Error?
+
+    private init(source: ACSecureFileSource, bufferSize: Int, allowedClasses: [AnyClass]) throws {
+        self.source = source
+        self.allowedClasses = allowedClasses
+        buffer = try SecureBuffer(count: max(bufferSize, 64))
+        super.init()
+    }
+
+    /// Returns the root object of the archive at `path`, which must be nil or an instance of one of `classes`.
+    ///
+    /// Archives written by NSKeyedArchiver +archiveRootObject:toSecureFile:error: are recognized by their bplist00
+    /// header and passed to NSKeyedUnarchiver with the same classes. That format has to be decrypted whole, so such
+    /// archives are not streamed.
+    static func unarchivedObject(ofClasses classes: [AnyClass], withSecureFile path: String,
+                                 encryptionGroupId: String? = nil,
+                                 bufferSize: Int = SecureStreamingArchiver.defaultBufferSize) throws -> Any? {
+        let source = try ACSecureFileSource(path: path, encryptionGroupId: encryptionGroupId)
+        let unarchiver = try SecureStreamingUnarchiver(source: source, bufferSize: bufferSize, allowedClasses: classes)
+        defer {
+            unarchiver.buffer.wipe()
+            source.close()
+        }
+        var expected = Data()
+        withUnsafeBytes(of: SecureArchiveTag.magic.littleEndian) { expected.append(contentsOf: $0) }
+        withUnsafeBytes(of: SecureArchiveTag.version.littleEndian) { expected.append(contentsOf: $0) }
+        let header = try unarchiver.readBytes(count: expected.count)
+
+        let root: Any?
+        if header == keyedArchiveMagic {
+            root = try unarchiver.unarchiveKeyedArchive(header: header)
+        } else {
+            guard header == expected else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            root = try unarchiver.readValue()
+        }
+        if let root = root {
+            let object = root as AnyObject
+            guard classes.contains(where: { object.isKind(of: $0) }) else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+        }
+        return root
+    }
+
+    /// Returns the root object of the archive at `path`, which must be nil or an instance of `type`.
+    static func unarchivedObject<T: NSObject>(ofClass type: T.Type, withSecureFile path: String,
+                                              encryptionGroupId: String? = nil,
+                                              bufferSize: Int = SecureStreamingArchiver.defaultBufferSize)
+        throws -> T? {
+        return try unarchivedObject(ofClasses: [type], withSecureFile: path, encryptionGroupId: encryptionGroupId,
+                                    bufferSize: bufferSize) as? T
+    }
+
+    override var allowsKeyedCoding: Bool {
+        return true
+    }
+
+    override var requiresSecureCoding: Bool {
+        return true
+    }
+
+    // MARK: Keyed coding
+
+    override func containsValue(forKey key: String) -> Bool {
+        guard let current = fields.last else { return false }
+        return current[key] != nil
+    }
+
+    override func decodeObject(forKey key: String) -> Any? {
+        return field(key)
+    }
+
+    override func decodeObject(of classes: [AnyClass]?, forKey key: String) -> Any? {
+        guard let value = field(key) else { return nil }
+        guard let classes = classes else { return value }
+        let object = value as AnyObject
+        return classes.contains { object.isKind(of: $0) } ? value : nil
+    }
+
+    override func decodeBool(forKey key: String) -> Bool {
+        return (field(key) as? NSNumber)?.boolValue ?? false
+    }
+
+    override func decodeInteger(forKey key: String) -> Int {
+        return (field(key) as? NSNumber)?.intValue ?? 0
+    }
+
+    override func decodeInt32(forKey key: String) -> Int32 {
+        return (field(key) as? NSNumber)?.int32Value ?? 0
+    }
+
+    override func decodeInt64(forKey key: String) -> Int64 {
+        return (field(key) as? NSNumber)?.int64Value ?? 0
+    }
+
+    override func decodeFloat(forKey key: String) -> Float {
+        return (field(key) as? NSNumber)?.floatValue ?? 0
+    }
+
+    override func decodeDouble(forKey key: String) -> Double {
+        return (field(key) as? NSNumber)?.doubleValue ?? 0
+    }
+
+    /// The bytes stay valid until the -initWithCoder: that asked for them returns.
+    override func decodeBytes(forKey key: String, returnedLength lengthp: UnsafeMutablePointer<Int>?)
+        -> UnsafePointer<UInt8>? {
+        guard let data = field(key) as? NSData else {
+            lengthp?.pointee = 0
+            return nil
+        }
+        lengthp?.pointee = data.length
+        return data.bytes.assumingMemoryBound(to: UInt8.self)
+    }
+
+    // Unkeyed coding has no keys to stream by.
+
+    override func decodeValue(ofObjCType type: UnsafePointer<Int8>, at data: UnsafeMutableRawPointer) {
+        fail(SecureFileError.invalidArgument)
+    }
+
+    override func decodeObject() -> Any? {
+        fail(SecureFileError.invalidArgument)
+        return nil
+    }
+
+    override func decodeData() -> Data? {
+        fail(SecureFileError.invalidArgument)
+        return nil
+    }
+
+    private func field(_ key: String) -> Any? {
+        guard let current = fields.last, let value = current[key] else { return nil }
+        return value
+    }
+
+    // MARK: Values
+
+    private func readValue() throws -> Any? {
+        guard let tag = SecureArchiveTag(rawValue: try readInteger(UInt8.self)) else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        switch tag {
+        case .null:
+            return nil
+        case .reference:
+            let identifier = Int(try readInteger(UInt32.self))
+            // A missing object is an ancestor that is still being decoded.
+            guard identifier < objects.count, let object = objects[identifier] else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            return object
+        case .string:
+            let bytes = try readBytes(count: Int(try readInteger(UInt32.self)))
+            guard let string = NSString(data: bytes, encoding: String.Encoding.utf8.rawValue) else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            return string
+        case .data:
+            let count = try readInteger(UInt64.self)
+            guard count <= UInt64(Int.max) else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            return NSData(data: try readBytes(count: Int(count)))
+        case .integer:
+            return NSNumber(value: try readInteger(Int64.self))
+        case .unsignedInteger:
+            return NSNumber(value: try readInteger(UInt64.self))
+        case .double:
+            return NSNumber(value: Double(bitPattern: try readInteger(UInt64.self)))
+        case .bool:
+            return NSNumber(value: try readInteger(UInt8.self) != 0)
+        case .date:
+            return NSDate(timeIntervalSinceReferenceDate: Double(bitPattern: try readInteger(UInt64.self)))
+        case .nsNull:
+            return NSNull()
+        case .array, .dictionary, .set, .object:
+            guard depth < SecureStreamingUnarchiver.maxDepth else {
+                throw SecureFileError.badKeyOrCorruptData
+            }
+            depth += 1
+            defer { depth -= 1 }
+            return try tag == .object ? readObject() : readCollection(tag)
+        }
+    }
+
+    private func readCollection(_ tag: SecureArchiveTag) throws -> AnyObject {
+        let identifier = reserveIdentifier()
+        let mutable = try readInteger(UInt8.self) != 0
+        let count = Int(try readInteger(UInt32.self))
+        let collection: AnyObject
+        switch tag {
+        case .array:
+            let array = NSMutableArray()
+            for _ in 0..<count {
+                array.add(try readElement())
+            }
+            collection = mutable ? array : array.copy() as AnyObject
+        case .dictionary:
+            let dictionary = NSMutableDictionary()
+            for _ in 0..<count {
+                guard let key = try readElement() as? NSCopying else {
+                    throw SecureFileError.badKeyOrCorruptData
+                }
+                dictionary.setObject(try readElement(), forKey: key)
+            }
+            collection = mutable ? dictionary : dictionary.copy() as AnyObject
+        default:
+            let set = NSMutableSet()
+            for _ in 0..<count {
+                set.add(try readElement())
+            }
+            collection = mutable ? set : set.copy() as AnyObject
+        }
+        objects[identifier] = collection
+        return collection
+    }
+
+    /// Collections cannot hold nil.
+    private func readElement() throws -> Any {
+        guard let element = try readValue() else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        return element
+    }
+
+    /// Reads the fields of an object, then creates it with -initWithCoder: and -awakeAfterUsingCoder:.
+    private func readObject() throws -> AnyObject {
+        let identifier = reserveIdentifier()
+        let className = try readKey()
+        var current: [String: Any?] = [:]
+        while true {
+            let length = try readInteger(UInt16.self)
+            if length == SecureArchiveTag.endOfObject {
+                break
+            }
+            let key = try readString(count: Int(length))
+            current.updateValue(try readValue(), forKey: key)
+        }
+        // Checked before any code of the class runs, as NSKeyedUnarchiver does when it requires secure coding.
+        guard let type = className.flatMap(NSClassFromString) as? (NSObject & NSSecureCoding).Type,
+            type.supportsSecureCoding, allowedClasses.contains(where: { type.isSubclass(of: $0) }) else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+
+        fields.append(current)
+        let decoded = type.init(coder: self)
+        fields.removeLast()
+        if let failure = failure {
+            throw failure
+        }
+        guard let object = decoded as? NSObject else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        let awakened = (object.awakeAfter(using: self) ?? object) as AnyObject
+        objects[identifier] = awakened
+        return awakened
+    }
+
+    private func reserveIdentifier() -> Int {
+        objects.append(nil)
+        return objects.count - 1
+    }
+
+    /// Reads the rest of the file after `header` and decodes it with NSKeyedUnarchiver.
+    private func unarchiveKeyedArchive(header: Data) throws -> Any? {
+        var archive = header
+        defer { SecureBuffer.wipe(&archive) }
+        archive.append(contentsOf: UnsafeRawBufferPointer(rebasing: buffer.bytes[start..<end]))
+        start = end
+        try SecureFileStreamReader(source: source, bufferSize: buffer.count).forEach { archive.append(contentsOf: $0) }
+        return try NSKeyedUnarchiver.unarchivedObject(ofClasses: allowedClasses, from: archive)
+    }
+
+    // MARK: Input
+
+    private func readKey() throws -> String? {
+        let length = try readInteger(UInt16.self)
+        guard length != SecureArchiveTag.endOfObject else { return nil }
+        return try readString(count: Int(length))
+    }
+
+    private func readString(count: Int) throws -> String {
+        guard let string = String(data: try readBytes(count: count), encoding: .utf8) else {
+            throw SecureFileError.badKeyOrCorruptData
+        }
+        return string
+    }
+
+    private func readInteger<T: FixedWidthInteger>(_ type: T.Type) throws -> T {
+        var value = T.zero
+        try withUnsafeMutableBytes(of: &value) { try read(into: $0) }
+        return T(littleEndian: value)
+    }
+
+    private func readBytes(count: Int) throws -> Data {
+        var data = Data(count: count)
+        try data.withUnsafeMutableBytes { try read(into: $0) }
+        return data
+    }
+
+    /// Fills `destination` from the buffer, reading large runs straight from the file. A short file is corrupt.
+    private func read(into destination: UnsafeMutableRawBufferPointer) throws {
+        var done = 0
+        while done < destination.count {
+            if start == end {
+                if destination.count - done >= buffer.count {
+                    let count = try source.read(into: UnsafeMutableRawBufferPointer(rebasing: destination[done...]))
+                    guard count > 0 else {
+                        throw SecureFileError.badKeyOrCorruptData
+                    }
+                    done += count
+                    continue
+                }
+                end = try source.read(into: buffer.bytes)
+                start = 0
+                guard end > 0 else {
+                    throw SecureFileError.badKeyOrCorruptData
+                }
+            }
+            let count = min(end - start, destination.count - done)
+            UnsafeMutableRawBufferPointer(rebasing: destination[done..<(done + count)])
+                .copyMemory(from: UnsafeRawBufferPointer(rebasing: buffer.bytes[start..<(start + count)]))
+            start += count
+            done += count
+        }
+    }
+
+    private func fail(_ error: Error) {
+        if failure == nil {
+            failure = error
+        }
+    }
+}
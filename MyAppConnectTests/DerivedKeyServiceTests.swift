@@ -0,0 +1,185 @@
+//
+//  DerivedKeyServiceTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import CryptoKit
+import AppConnect
+@testable import MyAppConnect
+
+/// Derives a 32-byte key filled with the identifier's length, and counts derivations.
+private final class StubKeySource: DerivedKeySource {
+    var isAvailable = true
+    var derivations: [DerivedKeyService.Identifier] = []
+    /// Runs during each derivation, as if another thread acted while the KDF runs.
+    var whileDeriving: (() -> Void)?
+
+    func derivedKey(for identifier: DerivedKeyService.Identifier) throws -> ACSensitiveData {
+        derivations.append(identifier)
+        whileDeriving?()
+        let name: String
+        switch identifier {
+        case .app(let value), .shared(let value):
+            name = value
+        }
+        guard !name.isEmpty, let key = ACSensitiveMutableData(length: 32) else {
+            throw SecureFileError.noKeys
+        }
+        memset(key.mutableBytes, Int32(name.utf8.count), key.length)
+        return key
+    }
+}
+
+class DerivedKeyServiceTests: XCTestCase {
+    private let source = StubKeySource()
+
+    private func bytes(_ key: SymmetricKey) -> Data {
+        return key.withUnsafeBytes { Data($0) }
+    }
+
+    func testKeysAreDerivedOnce() throws {
+        let service = DerivedKeyService(capacity: 4, source: source)
+        let first = try service.derivedAppKey(withIdentifier: "abc")
+        let second = try service.derivedAppKey(withIdentifier: "abc")
+        XCTAssertEqual(first as Data, Data(repeating: 3, count: 32))
+        XCTAssertEqual(second as Data, first as Data)
+        XCTAssertEqual(source.derivations, [.app("abc")])
+        XCTAssertEqual(service.statistics.hits, 1)
+        XCTAssertEqual(service.statistics.misses, 1)
+        XCTAssertEqual(service.statistics.hitRate, 0.5)
+    }
+
+    func testAppAndSharedKeysAreCachedSeparately() throws {
+        let service = DerivedKeyService(capacity: 4, source: source)
+        _ = try service.derivedAppKey(withIdentifier: "a")
+        _ = try service.derivedSharedKey(withIdentifier: "a")
+        XCTAssertEqual(source.derivations, [.app("a"), .shared("a")])
+    }
+
+    func testLeastRecentlyUsedKeyIsEvicted() throws {
+        let service = DerivedKeyService(capacity: 2, source: source)
+        _ = try service.derivedAppKey(withIdentifier: "a")
+        _ = try service.derivedAppKey(withIdentifier: "b")
+        _ = try service.derivedAppKey(withIdentifier: "a")
+        _ = try service.derivedAppKey(withIdentifier: "c")
+        XCTAssertEqual(service.statistics.evictions, 1)
+
+        _ = try service.derivedAppKey(withIdentifier: "a")
+        XCTAssertEqual(source.derivations.count, 3)
+        _ = try service.derivedAppKey(withIdentifier: "b")
+        XCTAssertEqual(source.derivations.count, 4)
+        XCTAssertEqual(service.statistics.evictions, 2)
+    }
+
+    func testBatchLookupDerivesOnlyMissingKeys() throws {
+        let service = DerivedKeyService(capacity: 4, source: source)
+        _ = try service.derivedAppKey(withIdentifier: "a")
+        let keys = try service.derivedKeys(for: [.app("a"), .shared("bb"), .shared("bb")])
+        XCTAssertEqual(keys.count, 2)
+        XCTAssertEqual(keys[.shared("bb")].map { $0 as Data }, Data(repeating: 2, count: 32))
+        XCTAssertEqual(source.derivations, [.app("a"), .shared("bb")])
+        XCTAssertEqual(service.statistics.hits, 1)
+    }
+
+    func testUnavailableServicesFlushAndFail() throws {
+        let service = DerivedKeyService(capacity: 4, source: source)
+        _ = try service.derivedAppKey(withIdentifier: "a")
+        source.isAvailable = false
+        XCTAssertThrowsError(try service.derivedAppKey(withIdentifier: "a")) { error in
+            XCTAssertEqual(error as NSError, SecureFileError.noKeys)
+        }
+        XCTAssertEqual(service.statistics.flushes, 1)
+
+        source.isAvailable = true
+        _ = try service.derivedAppKey(withIdentifier: "a")
+        XCTAssertEqual(source.derivations.count, 2)
+    }
+
+    func testFailedDerivationCachesNothing() throws {
+        let service = DerivedKeyService(capacity: 4, source: source)
+        XCTAssertThrowsError(try service.derivedAppKey(withIdentifier: ""))
+        XCTAssertThrowsError(try service.derivedAppKey(withIdentifier: ""))
+        XCTAssertEqual(source.derivations.count, 2)
+        XCTAssertEqual(service.statistics.misses, 2)
+    }
+
+    func testFlushOfEmptyCacheIsNotCounted() throws {
+        let service = DerivedKeyService(capacity: 4, source: source)
+        service.flush()
+        _ = try service.derivedAppKey(withIdentifier: "a")
+        service.flush()
+        service.flush()
+        XCTAssertEqual(service.statistics.flushes, 1)
+    }
+
+    func testFlushWhileDerivingKeepsTheKeyOutOfTheCache() throws {
+        let service = DerivedKeyService(capacity: 4, source: source)
+        source.whileDeriving = { service.flush() }
+        XCTAssertEqual(try service.derivedAppKey(withIdentifier: "a") as Data, Data(repeating: 1, count: 32))
+        source.whileDeriving = nil
+        _ = try service.derivedAppKey(withIdentifier: "a")
+        _ = try service.derivedAppKey(withIdentifier: "a")
+        XCTAssertEqual(source.derivations.count, 2)
+    }
+
+    func testServicesLostWhileDerivingFailTheCall() throws {
+        let service = DerivedKeyService(capacity: 4, source: source)
+        source.whileDeriving = { self.source.isAvailable = false }
+        XCTAssertThrowsError(try service.derivedAppKey(withIdentifier: "a")) { error in
+            XCTAssertEqual(error as NSError, SecureFileError.noKeys)
+        }
+        source.whileDeriving = nil
+        source.isAvailable = true
+        _ = try service.derivedAppKey(withIdentifier: "a")
+        XCTAssertEqual(source.derivations.count, 2)
+    }
+
+    func testKeyEncryptionKeysAreCachedUntilTheServiceFlushes() throws {
+        let service = DerivedKeyService(capacity: 4, source: source)
+        let provider = AppConnectKeyProvider(keys: service)
+        let first = bytes(try provider.keyEncryptionKey(for: .app))
+        XCTAssertEqual(bytes(try provider.keyEncryptionKey(for: .app)), first)
+        XCTAssertEqual(provider.cacheStatistics.hits, 1)
+        XCTAssertEqual(source.derivations.count, 1)
+
+        service.flush()
+        XCTAssertEqual(bytes(try provider.keyEncryptionKey(for: .app)), first)
+        XCTAssertEqual(provider.cacheStatistics.misses, 2)
+        XCTAssertEqual(source.derivations.count, 2)
+
+        source.isAvailable = false
+        XCTAssertThrowsError(try provider.keyEncryptionKey(for: .app)) { error in
+            XCTAssertEqual(error as NSError, SecureFileError.noKeys)
+        }
+    }
+
+    func testCachedKeyEncryptionKeyPerformance() throws {
+        let provider = AppConnectKeyProvider(keys: DerivedKeyService(capacity: 4, source: source))
+        _ = try provider.keyEncryptionKey(for: .app)
+        measure {
+            for _ in 0..<10_000 {
+                XCTAssertNoThrow(try provider.keyEncryptionKey(for: .app))
+            }
+        }
+    }
+
+    /// Per-call HKDF baseline for `testCachedKeyEncryptionKeyPerformance`, as every file open paid it before the
+    /// key-encryption keys were cached.
+    func testUncachedKeyEncryptionKeyPerformance() throws {
+        let service = DerivedKeyService(capacity: 4, source: source)
+        let identifier = AppConnectKeyProvider.keyIdentifier
+        measure {
+            for _ in 0..<10_000 {
+                guard let master = try? service.derivedAppKey(withIdentifier: identifier) else {
+                    return XCTFail()
+                }
+                let bytes = UnsafeRawBufferPointer(start: master.bytes, count: master.length)
+                _ = SecureKeyDerivation.deriveKey(from: bytes, salt: Data(), info: "key-encryption")
+            }
+        }
+    }
+}
@@ -0,0 +1,129 @@
+//
+//  SecureArenaTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import AppConnect
+@testable import MyAppConnect
+
+class SecureArenaTests: SecureFileTestCase {
+    private let arena = SecureArena.shared
+
+    func testBlocksAreZeroedWhenReused() throws {
+        for count in [24, 4000, 200 * 1024] {
+            let first = try arena.allocate(count)
+            memset(first, 0xA5, count)
+            arena.deallocate(first, count: count)
+            let second = try arena.allocate(count)
+            XCTAssertFalse(UnsafeRawBufferPointer(start: second, count: count).contains { $0 != 0 }, "\(count)")
+            arena.deallocate(second, count: count)
+        }
+    }
+
+    func testLargeBlocksComeFromThePool() throws {
+        let count = SecureChunkedFile.defaultCompareBufferSize
+        let warm = try arena.allocate(count)
+        arena.deallocate(warm, count: count)
+        let before = arena.statistics
+
+        for _ in 0..<10 {
+            let block = try arena.allocate(count)
+            arena.deallocate(block, count: count)
+        }
+        let after = arena.statistics
+        XCTAssertEqual(after.largeAllocations, before.largeAllocations)
+        XCTAssertEqual(after.largePoolHits - before.largePoolHits, 10)
+        XCTAssertLessThanOrEqual(after.largePoolBytes, SecureArena.largePoolBudget)
+    }
+
+    func testEmptySlabsAreReleased() throws {
+        // 32 KB blocks fill a slab with 8 blocks, so 64 of them need several slabs of their own.
+        let count = 32 * 1024
+        var blocks: [UnsafeMutableRawPointer] = []
+        for _ in 0..<64 {
+            blocks.append(try arena.allocate(count))
+        }
+        let peak = arena.statistics
+        for block in blocks {
+            arena.deallocate(block, count: count)
+        }
+        let after = arena.statistics
+        XCTAssertGreaterThan(after.releasedSlabs, peak.releasedSlabs)
+        XCTAssertLessThan(after.slabs, peak.slabs)
+    }
+
+    func testFailedMappingThrowsLowMemory() {
+        assertThrows(SecureFileError.appConnect(ACErrorLowMemory)) {
+            _ = try self.arena.allocate(Int.max / 4)
+        }
+        assertThrows(SecureFileError.appConnect(ACErrorLowMemory)) {
+            _ = try SecureBuffer(count: Int.max / 4)
+        }
+    }
+
+    func testRepeatedLargeAllocationPerformance() {
+        measure {
+            for _ in 0..<1000 {
+                let buffer = try? SecureBuffer(count: SecureChunkedFile.defaultCompareBufferSize)
+                XCTAssertNotNil(buffer)
+            }
+        }
+    }
+
+    /// Key-sized buffers allocated and freed in bursts, as the key cache and chunk headers do.
+    func testSmallBlockChurnPerformance() {
+        measure {
+            for _ in 0..<100 {
+                var buffers: [SecureBuffer] = []
+                buffers.reserveCapacity(100)
+                for index in 0..<100 {
+                    guard let buffer = try? SecureBuffer(count: 16 << (index % 3)) else {
+                        return XCTFail("allocation failed")
+                    }
+                    buffers.append(buffer)
+                }
+            }
+        }
+    }
+
+    /// Small-block churn on every core at once; the per-thread magazines keep the threads off the shared lock.
+    func testConcurrentSmallBlockChurnPerformance() {
+        measure {
+            DispatchQueue.concurrentPerform(iterations: ProcessInfo.processInfo.activeProcessorCount) { _ in
+                for _ in 0..<10_000 {
+                    guard let block = try? self.arena.allocate(32) else {
+                        return XCTFail("allocation failed")
+                    }
+                    self.arena.deallocate(block, count: 32)
+                }
+            }
+        }
+    }
+
+    /// Heap blocks locked, wiped and unlocked one at a time, as buffers were before the arena: the baseline for
+    /// `testSmallBlockChurnPerformance`.
+    func testSmallBlockChurnOnTheHeapPerformance() {
+        measure {
+            for _ in 0..<100 {
+                var blocks: [(UnsafeMutableRawPointer, Int)] = []
+                blocks.reserveCapacity(100)
+                for index in 0..<100 {
+                    let count = 16 << (index % 3)
+                    let block = UnsafeMutableRawPointer.allocate(byteCount: count, alignment: 16)
+                    block.initializeMemory(as: UInt8.self, repeating: 0, count: count)
+                    mlock(block, count)
+                    blocks.append((block, count))
+                }
+                for (block, count) in blocks {
+                    SecureBuffer.wipe(UnsafeMutableRawBufferPointer(start: block, count: count))
+                    munlock(block, count)
+                    block.deallocate()
+                }
+            }
+        }
+    }
+}
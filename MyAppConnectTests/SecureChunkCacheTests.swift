@@ -0,0 +1,95 @@
+//
+//  SecureChunkCacheTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureChunkCacheTests: SecureFileTestCase {
+    private func chunk(_ value: UInt8, count: Int = 16) -> [UInt8] {
+        return [UInt8](repeating: value, count: count)
+    }
+
+    func testEvictsLeastRecentlyUsed() {
+        let cache = SecureChunkCache(chunkSize: 16, byteBudget: 32)
+        chunk(1).withUnsafeBytes { cache.insert(1, plaintext: $0) }
+        chunk(2).withUnsafeBytes { cache.insert(2, plaintext: $0) }
+        XCTAssertNotNil(cache.lookup(1))
+        chunk(3).withUnsafeBytes { cache.insert(3, plaintext: $0) }
+
+        XCTAssertNil(cache.lookup(2))
+        XCTAssertEqual(cache.lookup(1).map(Array.init), chunk(1))
+        XCTAssertEqual(cache.lookup(3).map(Array.init), chunk(3))
+        XCTAssertEqual(cache.statistics.evictions, 1)
+        XCTAssertEqual(cache.statistics.hits, 3)
+        XCTAssertEqual(cache.statistics.misses, 1)
+    }
+
+    func testRemoveFromDropsTail() {
+        let cache = SecureChunkCache(chunkSize: 16, byteBudget: 64)
+        for index in 0..<4 {
+            chunk(UInt8(index)).withUnsafeBytes { cache.insert(UInt64(index), plaintext: $0) }
+        }
+        cache.remove(from: 2)
+        XCTAssertNotNil(cache.lookup(1))
+        XCTAssertNil(cache.lookup(2))
+        XCTAssertNil(cache.lookup(3))
+    }
+
+    func testZeroBudgetCachesNothing() {
+        let cache = SecureChunkCache(chunkSize: 16, byteBudget: 0)
+        chunk(1).withUnsafeBytes { cache.insert(1, plaintext: $0) }
+        XCTAssertNil(cache.lookup(1))
+    }
+
+    func testRepeatedReadsHitTheCache() throws {
+        let file = try makeFile("cached", cacheBudget: 4 * 4096)
+        try file.write(pattern(count: 4096 * 2), at: 0)
+        _ = try file.read(length: 4096 * 2, at: 0)
+        let before = file.cacheStatistics
+        XCTAssertEqual(try file.read(length: 4096 * 2, at: 0), pattern(count: 4096 * 2))
+        XCTAssertEqual(file.cacheStatistics.hits - before.hits, 2)
+    }
+
+    func testCacheFollowsWritesAndTruncation() throws {
+        let file = try makeFile("coherent", cacheBudget: 4 * 4096)
+        try file.write(pattern(count: 4096 * 2), at: 0)
+        _ = try file.read(length: 4096 * 2, at: 0)
+
+        try file.write(Data([0xAA]), at: 5000)
+        XCTAssertEqual(try file.read(length: 1, at: 5000), Data([0xAA]))
+        try file.truncate(to: 4096)
+        try file.truncate(to: 4096 * 2)
+        XCTAssertEqual(try file.read(length: 4096, at: 4096), Data(count: 4096))
+    }
+
+    /// Replays a parser-like trace over a 1 MB file: 256-byte reads that skip ahead 512 bytes, with a 1 KB seek back
+    /// every fourth read.
+    private func replayTrace(cacheBudget: Int) throws {
+        let length = 1024 * 1024
+        let file = try makeFile("trace", cacheBudget: cacheBudget)
+        defer { file.close() }
+        try file.write(pattern(count: length), at: 0)
+        var buffer = [UInt8](repeating: 0, count: 256)
+        measure {
+            var position = 0
+            for step in 0..<20_000 {
+                position = step % 4 == 3 ? max(0, position - 1024) : (position + 512) % (length - 256)
+                _ = buffer.withUnsafeMutableBytes { try? file.read(into: $0, at: UInt64(position)) }
+            }
+        }
+    }
+
+    func testTraceReplayPerformance() throws {
+        try replayTrace(cacheBudget: SecureChunkedFile.defaultCacheBudget)
+    }
+
+    /// The same trace with the cache off: the baseline for `testTraceReplayPerformance`.
+    func testTraceReplayWithoutCachePerformance() throws {
+        try replayTrace(cacheBudget: 0)
+    }
+}
@@ -0,0 +1,71 @@
+//
+//  SecureChunkCipherTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import CryptoKit
+@testable import MyAppConnect
+
+class SecureChunkCipherTests: XCTestCase {
+    private let suites: [SecureChunkCipherSuite] = [.aesGCM, .chaChaPoly]
+
+    func testKnownAnswers() {
+        for suite in suites {
+            XCTAssertTrue(suite.passesKnownAnswerTest(), "\(suite)")
+        }
+        XCTAssertEqual(SecureChunkCipherSuite.verifiedSuites, Set(suites))
+        XCTAssertNotNil(SecureChunkCipherSuite.preferred)
+    }
+
+    func testRoundTrip() throws {
+        for suite in suites {
+            let cipher = try suite.makeCipher(key: SymmetricKey(size: .bits256))
+            let plaintext = [UInt8]((0..<256).map { UInt8($0) })
+            let slot = try seal(plaintext, with: cipher, associatedData: Data([1, 2, 3]))
+            XCTAssertEqual(try open(slot, with: cipher, associatedData: Data([1, 2, 3])), plaintext, "\(suite)")
+        }
+    }
+
+    func testEverySealUsesAFreshNonce() throws {
+        for suite in suites {
+            let cipher = try suite.makeCipher(key: SymmetricKey(size: .bits256))
+            let plaintext = [UInt8](repeating: 0, count: 64)
+            let first = try seal(plaintext, with: cipher, associatedData: Data())
+            let second = try seal(plaintext, with: cipher, associatedData: Data())
+            XCTAssertNotEqual(first.prefix(SecureChunkedFile.nonceSize), second.prefix(SecureChunkedFile.nonceSize))
+            XCTAssertNotEqual(first, second)
+        }
+    }
+
+    func testTamperingIsDetected() throws {
+        for suite in suites {
+            let cipher = try suite.makeCipher(key: SymmetricKey(size: .bits256))
+            var slot = try seal([UInt8](repeating: 7, count: 32), with: cipher, associatedData: Data([9]))
+            XCTAssertThrowsError(try open(slot, with: cipher, associatedData: Data([8])), "\(suite)")
+            slot[SecureChunkedFile.nonceSize] ^= 1
+            XCTAssertThrowsError(try open(slot, with: cipher, associatedData: Data([9])), "\(suite)")
+        }
+    }
+
+    private let overhead = SecureChunkedFile.nonceSize + SecureChunkedFile.tagSize
+
+    private func seal(_ plaintext: [UInt8], with cipher: SecureChunkCipher, associatedData: Data) throws -> [UInt8] {
+        var slot = [UInt8](repeating: 0, count: plaintext.count + overhead)
+        try plaintext.withUnsafeBytes { input in
+            try slot.withUnsafeMutableBytes { try cipher.seal(input, authenticating: associatedData, into: $0) }
+        }
+        return slot
+    }
+
+    private func open(_ slot: [UInt8], with cipher: SecureChunkCipher, associatedData: Data) throws -> [UInt8] {
+        var plaintext = [UInt8](repeating: 0, count: slot.count - overhead)
+        try slot.withUnsafeBytes { input in
+            try plaintext.withUnsafeMutableBytes { try cipher.open(input, authenticating: associatedData, into: $0) }
+        }
+        return plaintext
+    }
+}
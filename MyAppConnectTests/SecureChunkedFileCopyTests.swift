@@ -0,0 +1,101 @@
+//
+//  SecureChunkedFileCopyTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureChunkedFileCopyTests: SecureFileTestCase {
+    private let contents = Data((0..<(4096 * 3 + 11)).map { UInt8(truncatingIfNeeded: $0 * 7) })
+
+    private func makeSource() throws {
+        let file = try makeFile("source")
+        try file.write(contents, at: 0)
+        file.close()
+    }
+
+    private func readAll(_ name: String, domain: SecureFileKeyDomain = .app) throws -> Data {
+        let file = try SecureChunkedFile(path: path(name), flags: O_RDONLY, domain: domain, keyProvider: keyProvider)
+        defer { file.close() }
+        return try file.read(length: Int(file.length), at: 0)
+    }
+
+    private func raw(_ name: String) -> Data {
+        return FileManager.default.contents(atPath: path(name)) ?? Data()
+    }
+
+    func testCopyWithinDomainGetsItsOwnKey() throws {
+        try makeSource()
+        try SecureChunkedFile.copy(atPath: path("source"), toPath: path("copy"), keyProvider: keyProvider)
+        XCTAssertEqual(try readAll("copy"), contents)
+
+        let source = raw("source")
+        let copy = raw("copy")
+        XCTAssertEqual(source.count, copy.count)
+        // The file identifier and every slot differ.
+        XCTAssertNotEqual(source[24..<40], copy[24..<40])
+        XCTAssertNotEqual(source.dropFirst(SecureChunkedFileHeader.size).prefix(4096),
+                          copy.dropFirst(SecureChunkedFileHeader.size).prefix(4096))
+    }
+
+    func testSlotsCannotBeSwappedBetweenSourceAndCopy() throws {
+        try makeSource()
+        try SecureChunkedFile.copy(atPath: path("source"), toPath: path("copy"), keyProvider: keyProvider)
+        let copy = raw("copy")
+        let slot = copy[SecureChunkedFileHeader.size..<(SecureChunkedFileHeader.size + 4096 + 28)]
+        let fd = Darwin.open(path("source"), O_RDWR)
+        let written = slot.withUnsafeBytes {
+            Darwin.pwrite(fd, $0.baseAddress, $0.count, off_t(SecureChunkedFileHeader.size))
+        }
+        XCTAssertEqual(written, slot.count)
+        Darwin.close(fd)
+
+        assertThrows(SecureFileError.badKeyOrCorruptData) { _ = try self.readAll("source") }
+    }
+
+    func testCopyToGroupIsSealedForTheGroupOnly() throws {
+        try makeSource()
+        let group = SecureFileKeyDomain.group("group.test")
+        try SecureChunkedFile.copy(atPath: path("source"), toPath: path("copy"), to: group, keyProvider: keyProvider)
+        XCTAssertEqual(try readAll("copy", domain: group), contents)
+        assertThrows(SecureFileError.badKeyOrCorruptData) { _ = try self.readAll("copy") }
+        XCTAssertEqual(try readAll("source"), contents)
+    }
+
+    func testCopyKeepsHoles() throws {
+        let file = try makeFile("source")
+        try file.write(Data([1]), at: 4096 * 1000)
+        file.close()
+
+        try SecureChunkedFile.copy(atPath: path("source"), toPath: path("copy"), keyProvider: keyProvider)
+        let copy = try makeFile("copy", flags: O_RDONLY)
+        XCTAssertEqual(copy.length, 4096 * 1000 + 1)
+        XCTAssertEqual(try copy.read(length: 2, at: 4096 * 1000 - 1), Data([0, 1]))
+        var info = stat()
+        XCTAssertEqual(stat(path("copy"), &info), 0)
+        XCTAssertLessThan(Int(info.st_blocks) * 512, 4096 * 100)
+    }
+
+    func testWrongDomainLeavesNoDestination() throws {
+        try makeSource()
+        assertThrows(SecureFileError.badKeyOrCorruptData) {
+            try SecureChunkedFile.copy(atPath: self.path("source"), toPath: self.path("copy"),
+                                       from: .group("other"), keyProvider: self.keyProvider)
+        }
+        XCTAssertFalse(FileManager.default.fileExists(atPath: path("copy")))
+    }
+
+    func testExistingDestinationIsNotReplaced() throws {
+        try makeSource()
+        XCTAssertTrue(FileManager.default.createFile(atPath: path("copy"), contents: Data([1])))
+        assertThrows(SecureFileError.posix(EEXIST)) {
+            try SecureChunkedFile.copy(atPath: self.path("source"), toPath: self.path("copy"),
+                                       keyProvider: self.keyProvider)
+        }
+        XCTAssertEqual(FileManager.default.contents(atPath: path("copy")), Data([1]))
+    }
+}
@@ -0,0 +1,112 @@
+//
+//  SecureChunkedFileEqualityTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureChunkedFileEqualityTests: SecureFileTestCase {
+    private let benchmarkLength = 64 * 1024 * 1024
+
+    private func write(_ data: Data, to name: String) throws {
+        try SecureChunkedFile.write(data, toPath: path(name), keyProvider: keyProvider)
+    }
+
+    private func equal(_ name1: String, _ name2: String, bufferSize: Int = 4096) throws -> Bool {
+        return try SecureChunkedFile.contentsEqual(atPath: path(name1), andPath: path(name2),
+                                                   keyProvider: keyProvider, bufferSize: bufferSize)
+    }
+
+    func testWholeFileWritesRecordEqualDigests() throws {
+        let contents = pattern(count: 10_000)
+        try write(contents, to: "a")
+        try write(contents, to: "b")
+        let first = try makeFile("a", flags: O_RDONLY)
+        let second = try makeFile("b", flags: O_RDONLY)
+        XCTAssertNotNil(first.storedContentDigest)
+        XCTAssertEqual(first.storedContentDigest, second.storedContentDigest)
+        XCTAssertEqual(try first.contentDigest(), first.storedContentDigest)
+        XCTAssertTrue(try equal("a", "b"))
+    }
+
+    func testWritesClearTheDigestAndContentDigestRestoresIt() throws {
+        let contents = pattern(count: 10_000)
+        try write(contents, to: "a")
+        let file = try makeFile("a")
+        let recorded = file.storedContentDigest
+        try file.write(Data([0]), at: 5)
+        XCTAssertNil(file.storedContentDigest)
+        try file.write(contents.subdata(in: 5..<6), at: 5)
+        XCTAssertEqual(try file.contentDigest(), recorded)
+        XCTAssertEqual(file.storedContentDigest, recorded)
+        try file.truncate(to: 100)
+        XCTAssertNil(file.storedContentDigest)
+    }
+
+    func testStreamingComparisonFindsDifferences() throws {
+        let contents = pattern(count: 4096 * 5)
+        for name in ["a", "b", "c"] {
+            let file = try makeFile(name)
+            try file.write(contents, at: 0)
+            file.close()
+        }
+        let changed = try makeFile("c")
+        try changed.write(Data([~contents[4096 * 4 + 1]]), at: 4096 * 4 + 1)
+        changed.close()
+
+        XCTAssertNil(try makeFile("a", flags: O_RDONLY).storedContentDigest)
+        XCTAssertTrue(try equal("a", "b"))
+        XCTAssertFalse(try equal("a", "c"))
+        XCTAssertTrue(try equal("a", "b", bufferSize: 1000))
+    }
+
+    func testDifferentLengthsAreUnequal() throws {
+        try write(pattern(count: 100), to: "a")
+        try write(pattern(count: 101), to: "b")
+        XCTAssertFalse(try equal("a", "b"))
+        assertThrows(SecureFileError.invalidArgument) { _ = try self.equal("a", "b", bufferSize: 0) }
+    }
+
+    /// Two equal 64 MB files written through `write(_:at:)`, which records no content digest.
+    private func writeUndigestedPair() throws {
+        let contents = pattern(count: benchmarkLength)
+        for name in ["a", "b"] {
+            let file = try makeFile(name)
+            try file.write(contents, at: 0)
+            file.close()
+        }
+    }
+
+    func testEqualityFromStoredDigestsPerformance() throws {
+        let contents = pattern(count: benchmarkLength)
+        try write(contents, to: "a")
+        try write(contents, to: "b")
+        measure {
+            XCTAssertTrue(try equal("a", "b"))
+        }
+    }
+
+    func testStreamingEqualityPerformance() throws {
+        try writeUndigestedPair()
+        measure {
+            XCTAssertTrue(try equal("a", "b", bufferSize: SecureChunkedFile.defaultCompareBufferSize))
+        }
+    }
+
+    /// Both files read whole and compared in memory: the baseline for `testStreamingEqualityPerformance`.
+    func testEqualityByReadingBothFilesPerformance() throws {
+        try writeUndigestedPair()
+        let length = benchmarkLength
+        measure {
+            let first = try? makeFile("a", flags: O_RDONLY)
+            let second = try? makeFile("b", flags: O_RDONLY)
+            XCTAssertEqual(try first?.read(length: length, at: 0), try second?.read(length: length, at: 0))
+            first?.close()
+            second?.close()
+        }
+    }
+}
@@ -0,0 +1,173 @@
+//
+//  SecureChunkedFileTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureChunkedFileTests: SecureFileTestCase {
+    private let chunkSize = 4096
+
+    private func slotOffset(_ file: SecureChunkedFile, _ index: Int) -> off_t {
+        return off_t(SecureChunkedFileHeader.size + index * file.slotSize)
+    }
+
+    func testRoundTripAcrossChunks() throws {
+        let contents = pattern(count: chunkSize * 3 + 123)
+        let file = try makeFile("round-trip")
+        try file.write(contents, at: 100)
+        file.close()
+
+        let reopened = try makeFile("round-trip", flags: O_RDONLY)
+        XCTAssertEqual(reopened.length, UInt64(contents.count + 100))
+        XCTAssertEqual(try reopened.read(length: 100, at: 0), Data(count: 100))
+        XCTAssertEqual(try reopened.read(length: contents.count, at: 100), contents)
+        XCTAssertEqual(try reopened.read(length: 10, at: reopened.length), Data())
+    }
+
+    func testPartialOverwriteKeepsNeighbours() throws {
+        var contents = pattern(count: chunkSize * 2)
+        let file = try makeFile("overwrite")
+        try file.write(contents, at: 0)
+        let patch = pattern(count: 200, seed: 7)
+        try file.write(patch, at: UInt64(chunkSize - 100))
+        contents.replaceSubrange((chunkSize - 100)..<(chunkSize + 100), with: patch)
+        file.close()
+
+        XCTAssertEqual(try makeFile("overwrite").read(length: contents.count, at: 0), contents)
+    }
+
+    func testTamperedCiphertextIsRejected() throws {
+        let file = try makeFile("tampered")
+        try file.write(pattern(count: chunkSize * 2), at: 0)
+        let offset = slotOffset(file, 1) + off_t(SecureChunkedFile.nonceSize) + 10
+        file.close()
+        flipBytes(of: path("tampered"), at: offset)
+
+        let reopened = try makeFile("tampered")
+        XCTAssertEqual(try reopened.read(length: chunkSize, at: 0), pattern(count: chunkSize))
+        assertThrows(SecureFileError.badKeyOrCorruptData) { _ = try reopened.read(length: 1, at: UInt64(chunkSize)) }
+    }
+
+    func testTamperedTagIsRejected() throws {
+        let file = try makeFile("tag")
+        try file.write(pattern(count: chunkSize), at: 0)
+        let offset = slotOffset(file, 1) - 1
+        file.close()
+        flipBytes(of: path("tag"), at: offset)
+
+        assertThrows(SecureFileError.badKeyOrCorruptData) { _ = try self.makeFile("tag").read(length: 1, at: 0) }
+    }
+
+    func testSwappedSlotsAreRejected() throws {
+        let file = try makeFile("swapped")
+        try file.write(pattern(count: chunkSize * 2), at: 0)
+        let first = slotOffset(file, 0)
+        let slotSize = file.slotSize
+        file.close()
+
+        let fd = Darwin.open(path("swapped"), O_RDWR)
+        var slots = [UInt8](repeating: 0, count: slotSize * 2)
+        XCTAssertEqual(Darwin.pread(fd, &slots, slots.count, first), slots.count)
+        let swapped = Array(slots[slotSize...] + slots[..<slotSize])
+        XCTAssertEqual(Darwin.pwrite(fd, swapped, swapped.count, first), swapped.count)
+        Darwin.close(fd)
+
+        assertThrows(SecureFileError.badKeyOrCorruptData) { _ = try self.makeFile("swapped").read(length: 1, at: 0) }
+    }
+
+    func testTamperedHeaderIsRejected() throws {
+        let file = try makeFile("header")
+        try file.write(pattern(count: 100), at: 0)
+        file.close()
+        // The length field; any header byte is covered by the header MAC.
+        flipBytes(of: path("header"), at: 16)
+
+        XCTAssertThrowsError(try makeFile("header"))
+    }
+
+    func testWrongKeyIsRejected() throws {
+        let file = try makeFile("key")
+        try file.write(pattern(count: 100), at: 0)
+        file.close()
+
+        assertThrows(SecureFileError.badKeyOrCorruptData) {
+            _ = try SecureChunkedFile(path: self.path("key"), keyProvider: FixedKeyProvider())
+        }
+    }
+
+    func testTruncatedCiphertextIsRejected() throws {
+        let file = try makeFile("cut")
+        try file.write(pattern(count: chunkSize * 3), at: 0)
+        let end = slotOffset(file, 2)
+        file.close()
+        XCTAssertEqual(Darwin.truncate(path("cut"), end), 0)
+
+        let reopened = try makeFile("cut")
+        XCTAssertEqual(try reopened.read(length: chunkSize, at: UInt64(chunkSize)), pattern(count: chunkSize * 2)
+            .subdata(in: chunkSize..<(chunkSize * 2)))
+        assertThrows(SecureFileError.badKeyOrCorruptData) {
+            _ = try reopened.read(length: 1, at: UInt64(self.chunkSize * 2))
+        }
+    }
+
+    func testSeekRejectsOverflowingOffsets() throws {
+        let file = try makeFile("seek")
+        try file.write(pattern(count: 100), at: 0)
+        XCTAssertEqual(try file.seek(to: -10, whence: SEEK_END), 90)
+        XCTAssertEqual(try file.seek(to: 5, whence: SEEK_CUR), 95)
+
+        assertThrows(SecureFileError.posix(EOVERFLOW)) { try file.seek(to: .max, whence: SEEK_END) }
+        assertThrows(SecureFileError.posix(EOVERFLOW)) { try file.seek(to: .max, whence: SEEK_CUR) }
+        assertThrows(SecureFileError.posix(EINVAL)) { try file.seek(to: .min, whence: SEEK_CUR) }
+        assertThrows(SecureFileError.posix(EINVAL)) { try file.seek(to: -101, whence: SEEK_END) }
+        XCTAssertEqual(try file.seek(to: .max), UInt64(Int64.max))
+        assertThrows(SecureFileError.posix(EOVERFLOW)) { try file.seek(to: 1, whence: SEEK_CUR) }
+        assertThrows(SecureFileError.posix(EFBIG)) { try Data([1]).withUnsafeBytes { try file.write($0) } }
+        assertThrows(SecureFileError.posix(EFBIG)) { try file.truncate(to: .max) }
+        XCTAssertEqual(file.length, 100)
+    }
+
+    func testShrinkThenGrowReadsZeros() throws {
+        let file = try makeFile("shrink")
+        try file.write(pattern(count: chunkSize * 3), at: 0)
+        try file.truncate(to: UInt64(chunkSize + 10))
+        try file.truncate(to: UInt64(chunkSize * 3))
+
+        let contents = try file.read(length: chunkSize * 3, at: 0)
+        XCTAssertEqual(contents.prefix(chunkSize + 10), pattern(count: chunkSize + 10))
+        XCTAssertEqual(contents.suffix(from: chunkSize + 10), Data(count: chunkSize * 2 - 10))
+    }
+
+    /// A crash after a shrunk header is written but before the slots past it are cut off leaves the old slots on
+    /// disk; they must never resurface.
+    func testSlotsLeftByInterruptedShrinkStayHidden() throws {
+        let file = try makeFile("interrupted")
+        try file.write(pattern(count: chunkSize * 3), at: 0)
+        let start = slotOffset(file, 1)
+        let end = slotOffset(file, 3)
+        file.close()
+
+        let fd = Darwin.open(path("interrupted"), O_RDWR)
+        var stale = [UInt8](repeating: 0, count: Int(end - start))
+        XCTAssertEqual(Darwin.pread(fd, &stale, stale.count, start), stale.count)
+        Darwin.close(fd)
+
+        let shrunk = try makeFile("interrupted")
+        try shrunk.truncate(to: UInt64(chunkSize))
+        shrunk.close()
+        XCTAssertEqual(rawSize(of: path("interrupted")), start)
+        let restore = Darwin.open(path("interrupted"), O_RDWR)
+        XCTAssertEqual(Darwin.pwrite(restore, stale, stale.count, start), stale.count)
+        Darwin.close(restore)
+
+        let reopened = try makeFile("interrupted")
+        XCTAssertEqual(reopened.length, UInt64(chunkSize))
+        try reopened.write(Data([1]), at: UInt64(chunkSize * 3))
+        XCTAssertEqual(try reopened.read(length: chunkSize * 2, at: UInt64(chunkSize)), Data(count: chunkSize * 2))
+    }
+}
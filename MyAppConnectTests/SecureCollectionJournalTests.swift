@@ -0,0 +1,200 @@
+//
+//  SecureCollectionJournalTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureCollectionJournalTests: SecureFileTestCase {
+    /// Opens a journal for `name` and returns it with the operations it replayed.
+    private func openJournal(_ name: String) throws -> (SecureCollectionJournal, [String]) {
+        let journal = SecureCollectionJournal(basePath: path(name))
+        var replayed: [String] = []
+        try journal.open(base: SecureCollectionJournal.readBase(atPath: path(name))) { operation in
+            replayed.append(operation as? String ?? "?")
+        }
+        return (journal, replayed)
+    }
+
+    private func baseContents(_ elements: [String]) throws -> Data {
+        return try PropertyListSerialization.data(fromPropertyList: elements, format: .binary, options: 0)
+    }
+
+    func testBatchesReplayInOrder() throws {
+        try requireAppConnect()
+        let (journal, replayed) = try openJournal("list")
+        XCTAssertEqual(replayed, [])
+        try journal.append(["a", "b"])
+        try journal.append(["c"])
+        try journal.append(["d", "e"])
+        journal.close()
+        assertThrows(SecureFileError.posix(EBADF)) { try journal.append(["late"]) }
+
+        let (reopened, again) = try openJournal("list")
+        defer { reopened.close() }
+        XCTAssertEqual(again, ["a", "b", "c", "d", "e"])
+        // Every batch after the first starts on a chunk boundary.
+        XCTAssertEqual(reopened.length, UInt64(3 * SecureCollectionJournal.chunkSize))
+    }
+
+    func testReplacingTheBaseDiscardsTheJournal() throws {
+        try requireAppConnect()
+        let (journal, _) = try openJournal("list")
+        try journal.append(["a"])
+        try journal.replaceBase(with: baseContents(["a"]))
+        try journal.append(["b"])
+        journal.close()
+
+        let (reopened, replayed) = try openJournal("list")
+        defer { reopened.close() }
+        XCTAssertEqual(replayed, ["b"])
+    }
+
+    func testJournalOfAnotherBaseIsIgnored() throws {
+        try requireAppConnect()
+        let (journal, _) = try openJournal("list")
+        try journal.append(["stale"])
+        journal.close()
+        // The base appears after the journal was written, as after a crash between the two.
+        try SecureGroupCommit.shared.write(baseContents([]), toPath: path("list"))
+
+        let (reopened, replayed) = try openJournal("list")
+        defer { reopened.close() }
+        XCTAssertEqual(replayed, [])
+    }
+
+    func testCopiedBaseAndJournalStillMatch() throws {
+        try requireAppConnect()
+        let (journal, _) = try openJournal("list")
+        try journal.replaceBase(with: baseContents(["base"]))
+        try journal.append(["a"])
+        journal.close()
+        // A copy or a restore from backup gives both files new inodes.
+        try FileManager.default.copyItem(atPath: path("list"), toPath: path("copy"))
+        try FileManager.default.copyItem(atPath: path("list.journal"), toPath: path("copy.journal"))
+
+        let (copy, replayed) = try openJournal("copy")
+        defer { copy.close() }
+        XCTAssertEqual(replayed, ["a"])
+    }
+
+    func testCorruptBatchBeforeTheLastFailsTheOpen() throws {
+        try requireAppConnect()
+        let (journal, _) = try openJournal("list")
+        for batch in ["a", "b", "c"] {
+            try journal.append([batch])
+        }
+        journal.close()
+
+        // The second batch starts the second chunk.
+        let file = try SecureChunkedFile(path: path("list.journal"), flags: O_RDONLY, cacheBudget: 0)
+        let slotSize = file.slotSize
+        file.close()
+        flipBytes(of: path("list.journal"), at: off_t(SecureChunkedFileHeader.size + slotSize + 20))
+        assertThrows(SecureFileError.badKeyOrCorruptData) {
+            _ = try self.openJournal("list")
+        }
+    }
+
+    func testTornBatchIsDropped() throws {
+        try requireAppConnect()
+        let (journal, _) = try openJournal("list")
+        try journal.append(["kept"])
+        let end = journal.length
+        journal.close()
+
+        let file = try SecureChunkedFile(path: path("list.journal"), flags: O_RDWR, cacheBudget: 0)
+        let chunkSize = UInt64(SecureCollectionJournal.chunkSize)
+        var torn = Data()
+        SecureKeyValueCodec.append(UInt32(10_000), to: &torn)
+        torn.append(try baseContents(["lost"]))
+        try file.write(torn, at: (end + chunkSize - 1) / chunkSize * chunkSize)
+        file.close()
+
+        let (reopened, replayed) = try openJournal("list")
+        XCTAssertEqual(replayed, ["kept"])
+        try reopened.append(["after"])
+        reopened.close()
+
+        let (again, all) = try openJournal("list")
+        defer { again.close() }
+        XCTAssertEqual(all, ["kept", "after"])
+    }
+
+    func testAppendStartsJournalThatCouldNotBeStarted() throws {
+        try requireAppConnect()
+        let (journal, _) = try openJournal("list")
+        try journal.append(["old"])
+        // A directory in the journal's place makes starting a new journal fail.
+        XCTAssertEqual(Darwin.unlink(path("list.journal")), 0)
+        try FileManager.default.createDirectory(atPath: path("list.journal"), withIntermediateDirectories: false)
+
+        try journal.replaceBase(with: baseContents(["old"]))
+        XCTAssertThrowsError(try journal.append(["lost"]))
+
+        try FileManager.default.removeItem(atPath: path("list.journal"))
+        try journal.append(["new"])
+        journal.close()
+
+        let (reopened, replayed) = try openJournal("list")
+        defer { reopened.close() }
+        XCTAssertEqual(replayed, ["new"])
+    }
+
+    // MARK: Performance
+
+    /// Creates a journaled array `name` whose base holds `count` entries.
+    private func makeArray(_ name: String, count: Int) throws -> SecureJournaledArray {
+        try requireAppConnect()
+        try SecureGroupCommit.shared.write(baseContents((0..<count).map { "entry \($0)" }), toPath: path(name))
+        return try SecureJournaledArray(contentsOfSecureFile: path(name))
+    }
+
+    /// Saving one appended entry costs one journal append, whatever the size of the array.
+    private func measureAppendingOne(toArrayOf count: Int) throws {
+        let array = try makeArray("array", count: count)
+        measure {
+            array.append("appended")
+            XCTAssertNoThrow(try array.save())
+        }
+    }
+
+    private func measureLoading(arrayOf count: Int) throws {
+        let array = try makeArray("array", count: count)
+        for index in 0..<100 {
+            array.append("appended \(index)")
+            try array.save()
+        }
+        measure {
+            XCTAssertEqual(try SecureJournaledArray(contentsOfSecureFile: path("array")).count, count + 100)
+        }
+    }
+
+    func testAppendingOneTo10kPerformance() throws {
+        try measureAppendingOne(toArrayOf: 10_000)
+    }
+
+    func testAppendingOneTo100kPerformance() throws {
+        try measureAppendingOne(toArrayOf: 100_000)
+    }
+
+    func testAppendingOneTo1MPerformance() throws {
+        try measureAppendingOne(toArrayOf: 1_000_000)
+    }
+
+    func testLoading10kPerformance() throws {
+        try measureLoading(arrayOf: 10_000)
+    }
+
+    func testLoading100kPerformance() throws {
+        try measureLoading(arrayOf: 100_000)
+    }
+
+    func testLoading1MPerformance() throws {
+        try measureLoading(arrayOf: 1_000_000)
+    }
+}
@@ -0,0 +1,112 @@
+//
+//  SecureFileAttributesTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureFileAttributesTests: SecureFileTestCase {
+    private func attributes(_ name: String) throws -> SecureFileAttributes {
+        return try SecureChunkedFile.attributes(atPath: path(name), keyProvider: keyProvider)
+    }
+
+    func testAttributesComeFromTheHeader() throws {
+        let before = Date()
+        let file = try makeFile("file")
+        try file.write(pattern(count: 5000), at: 0)
+        try file.write(Data([1]), at: 10)
+        file.close()
+
+        let attributes = try self.attributes("file")
+        XCTAssertEqual(attributes.size, 5000)
+        XCTAssertEqual(attributes.chunkSize, 4096)
+        XCTAssertGreaterThanOrEqual(attributes.modificationDate.timeIntervalSince(before), -1)
+        XCTAssertEqual(attributes.fileAttributes[.size] as? NSNumber, 5000)
+        XCTAssertEqual(attributes.fileAttributes[.type] as? FileAttributeType, .typeRegular)
+    }
+
+    func testOverwritesReachTheHeaderOnClose() throws {
+        let file = try makeFile("file")
+        try file.write(pattern(count: 100), at: 0)
+        try file.synchronize()
+        let written = try attributes("file").modificationDate
+        Thread.sleep(forTimeInterval: 0.01)
+        try file.write(Data([1]), at: 0)
+        file.close()
+        XCTAssertGreaterThan(try attributes("file").modificationDate, written)
+    }
+
+    func testTamperedSizeIsCorruptData() throws {
+        try makeFile("file").write(pattern(count: 100), at: 0)
+        flipBytes(of: path("file"), at: 16)
+        assertThrows(SecureFileError.badKeyOrCorruptData) { _ = try self.attributes("file") }
+    }
+
+    func testSymbolicLinksAreNotFollowed() throws {
+        try makeFile("file").write(pattern(count: 100), at: 0)
+        try FileManager.default.createSymbolicLink(atPath: path("link"), withDestinationPath: path("file"))
+        assertThrows(SecureFileError.regularFileOnly) { _ = try self.attributes("link") }
+    }
+
+    func testBatchResultsAreInOrder() throws {
+        var paths: [String] = []
+        for index in 0..<20 {
+            let file = try makeFile("file\(index)")
+            try file.write(pattern(count: index * 100), at: 0)
+            file.close()
+            paths.append(path("file\(index)"))
+        }
+        paths.insert(path("missing"), at: 7)
+        let requestsBefore = keyProvider.requests
+
+        let results = try SecureChunkedFile.attributes(atPaths: paths, keyProvider: keyProvider, maxConcurrency: 4)
+        XCTAssertEqual(keyProvider.requests - requestsBefore, 1)
+        XCTAssertEqual(results.count, 21)
+        XCTAssertThrowsError(try results[7].get())
+        let sizes = results.enumerated().filter { $0.offset != 7 }.map { try? $0.element.get().size }
+        XCTAssertEqual(sizes, (0..<20).map { Optional(UInt64($0 * 100)) })
+    }
+
+    /// 1000 small files, the paths of a directory listing.
+    private func makeListing() throws -> [String] {
+        return try (0..<1000).map { index in
+            let file = try makeFile("listed\(index)")
+            try file.write(pattern(count: 100 + index), at: 0)
+            file.close()
+            return path("listed\(index)")
+        }
+    }
+
+    func testAttributesPerformance() throws {
+        let paths = try makeListing()
+        measure {
+            for path in paths {
+                XCTAssertNoThrow(try SecureChunkedFile.attributes(atPath: path, keyProvider: keyProvider))
+            }
+        }
+    }
+
+    func testBatchAttributesPerformance() throws {
+        let paths = try makeListing()
+        measure {
+            let results = try? SecureChunkedFile.attributes(atPaths: paths, keyProvider: keyProvider)
+            XCTAssertEqual(results?.count, paths.count)
+        }
+    }
+
+    /// Each file opened to read its length, as sizes were found before: the baseline for `testAttributesPerformance`.
+    func testOpeningEachFilePerformance() throws {
+        let paths = try makeListing()
+        measure {
+            for path in paths {
+                let file = try? SecureChunkedFile(path: path, flags: O_RDONLY, keyProvider: keyProvider)
+                XCTAssertNotNil(file?.length)
+                file?.close()
+            }
+        }
+    }
+}
@@ -0,0 +1,119 @@
+//
+//  SecureFileDescriptorTableTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import AppConnect
+@testable import MyAppConnect
+
+class SecureFileDescriptorTableTests: SecureFileTestCase {
+    private func open(_ table: SecureFileDescriptorTable, _ name: String) throws -> Int32 {
+        let fd = try table.insert(makeFile(name))
+        XCTAssertGreaterThanOrEqual(fd, 0)
+        return fd
+    }
+
+    func testReadWriteTruncateAndClose() throws {
+        let table = SecureFileDescriptorTable(capacity: 4)
+        let fd = try open(table, "file")
+        let contents = [UInt8](pattern(count: 6000))
+        XCTAssertEqual(contents.withUnsafeBytes { table.pwrite(fd, $0, 100) }, 6000)
+        XCTAssertEqual(table.size(fd), 6100)
+
+        var readBack = [UInt8](repeating: 0, count: 6000)
+        XCTAssertEqual(readBack.withUnsafeMutableBytes { table.pread(fd, $0, 100) }, 6000)
+        XCTAssertEqual(readBack, contents)
+
+        XCTAssertEqual(table.ftruncate(fd, 50), 0)
+        XCTAssertEqual(table.fsync(fd), 0)
+        XCTAssertEqual(table.size(fd), 50)
+        XCTAssertEqual(table.close(fd), 0)
+        XCTAssertEqual(table.close(fd), -1)
+        XCTAssertEqual(errno, EBADF)
+    }
+
+    func testNegativeOffsetsAndLengthsAreInvalid() throws {
+        let table = SecureFileDescriptorTable(capacity: 4)
+        let fd = try open(table, "file")
+        var byte: UInt8 = 0
+        XCTAssertEqual(withUnsafeMutableBytes(of: &byte) { table.pread(fd, $0, -1) }, -1)
+        XCTAssertEqual(errno, EINVAL)
+        XCTAssertEqual(withUnsafeBytes(of: byte) { table.pwrite(fd, $0, -1) }, -1)
+        XCTAssertEqual(errno, EINVAL)
+        XCTAssertEqual(table.ftruncate(fd, -1), -1)
+        XCTAssertEqual(errno, EINVAL)
+        XCTAssertEqual(table.size(fd), 0)
+    }
+
+    func testDescriptorsAreReusedLowestFirst() throws {
+        let table = SecureFileDescriptorTable(capacity: 2)
+        XCTAssertEqual(try open(table, "a"), 0)
+        XCTAssertEqual(try open(table, "b"), 1)
+        XCTAssertEqual(try table.insert(makeFile("c")), -1)
+        XCTAssertEqual(errno, EMFILE)
+        XCTAssertEqual(table.close(0), 0)
+        XCTAssertEqual(try open(table, "c"), 0)
+        XCTAssertEqual(table.pread(7, UnsafeMutableRawBufferPointer(start: nil, count: 0), 0), -1)
+        XCTAssertEqual(errno, EBADF)
+    }
+
+    func testLastErrorReportsCorruptData() throws {
+        let file = try makeFile("corrupt")
+        try file.write(pattern(count: 4096), at: 0)
+        file.close()
+        flipBytes(of: path("corrupt"), at: off_t(SecureChunkedFileHeader.size + 20))
+
+        let table = SecureFileDescriptorTable(capacity: 4)
+        let fd = try open(table, "corrupt")
+        XCTAssertEqual(table.lastError(fd), 0)
+        var buffer = [UInt8](repeating: 0, count: 16)
+        XCTAssertEqual(buffer.withUnsafeMutableBytes { table.pread(fd, $0, 0) }, -1)
+        XCTAssertEqual(errno, EIO)
+        XCTAssertEqual(table.lastError(fd), Int32(ACErrorBadKeyOrCorruptData))
+    }
+
+    /// Reads 64 KB from each of `threads` descriptors, one thread per descriptor. With `sharedLock`, every call also
+    /// takes one lock, as a table guarded by a single mutex would.
+    private func measureConcurrentReads(threads: Int, sharedLock: NSLock? = nil) throws {
+        let table = SecureFileDescriptorTable(capacity: 16)
+        let contents = pattern(count: 64 * 1024)
+        var descriptors: [Int32] = []
+        for index in 0..<threads {
+            let file = try makeFile("file\(index)")
+            try file.write(contents, at: 0)
+            descriptors.append(table.insert(file))
+        }
+        measure {
+            DispatchQueue.concurrentPerform(iterations: descriptors.count) { index in
+                var buffer = [UInt8](repeating: 0, count: 4096)
+                for offset in stride(from: 0, to: contents.count, by: buffer.count) {
+                    sharedLock?.lock()
+                    let count = buffer.withUnsafeMutableBytes { table.pread(descriptors[index], $0, off_t(offset)) }
+                    sharedLock?.unlock()
+                    XCTAssertEqual(count, buffer.count)
+                }
+            }
+        }
+    }
+
+    func testReadsOnOneDescriptorPerformance() throws {
+        try measureConcurrentReads(threads: 1)
+    }
+
+    func testConcurrentReadsOnFourDescriptorsPerformance() throws {
+        try measureConcurrentReads(threads: 4)
+    }
+
+    func testConcurrentReadsOnSeparateDescriptors() throws {
+        try measureConcurrentReads(threads: 8)
+    }
+
+    /// Eight readers behind one table-wide lock: the baseline for `testConcurrentReadsOnSeparateDescriptors`.
+    func testConcurrentReadsBehindASharedLockPerformance() throws {
+        try measureConcurrentReads(threads: 8, sharedLock: NSLock())
+    }
+}
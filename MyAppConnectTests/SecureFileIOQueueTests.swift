@@ -0,0 +1,123 @@
+//
+//  SecureFileIOQueueTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureFileIOQueueTests: SecureFileTestCase {
+    /// Reaps `count` completions in the order they were delivered.
+    private func reapInOrder(_ queue: SecureFileIOQueue, count: Int) -> [SecureFileIOQueue.Completion] {
+        var completions: [SecureFileIOQueue.Completion] = []
+        while completions.count < count {
+            let reaped = queue.reap(minimum: count - completions.count, deadline: Date(timeIntervalSinceNow: 10))
+            XCTAssertFalse(reaped.isEmpty)
+            guard !reaped.isEmpty else { break }
+            completions += reaped
+        }
+        return completions
+    }
+
+    private func reapAll(_ queue: SecureFileIOQueue, count: Int) -> [Int: SecureFileIOQueue.Completion] {
+        return Dictionary(reapInOrder(queue, count: count).map { ($0.tag, $0) }) { first, _ in first }
+    }
+
+    func testOperationsOnOneFileCompleteInOrder() throws {
+        let file = try makeFile("ordered")
+        let queue = SecureFileIOQueue(maxConcurrency: 4)
+        var requests: [SecureFileIOQueue.Request] = []
+        for index in 0..<20 {
+            let data = Data(repeating: UInt8(index), count: 5000)
+            requests.append(.init(tag: index, operation: .write(file, offset: 0, data: data)))
+        }
+        requests.append(.init(tag: 100, operation: .synchronize(file)))
+        requests.append(.init(tag: 101, operation: .read(file, offset: 0, length: 5000)))
+        queue.submit(requests)
+
+        let completions = reapInOrder(queue, count: requests.count)
+        XCTAssertEqual(queue.inFlight, 0)
+        XCTAssertEqual(completions.map { $0.tag }, requests.map { $0.tag })
+        XCTAssertEqual(try completions.last?.result.get(), Data(repeating: 19, count: 5000))
+    }
+
+    func testReleasingTheQueueFinishesSubmittedWrites() throws {
+        let files = try (0..<4).map { try makeFile("released\($0)") }
+        var queue: SecureFileIOQueue? = SecureFileIOQueue(maxConcurrency: 2)
+        for (index, file) in files.enumerated() {
+            queue?.submit((0..<8).map { chunk in
+                .init(tag: index * 8 + chunk,
+                      operation: .write(file, offset: UInt64(chunk * 8192), data: pattern(count: 8192, seed: 3)))
+            })
+        }
+        queue = nil
+
+        for file in files {
+            XCTAssertEqual(file.length, 8 * 8192)
+            XCTAssertEqual(try file.read(length: 8192, at: 7 * 8192), pattern(count: 8192, seed: 3))
+        }
+    }
+
+    func testFilesRunIndependently() throws {
+        let queue = SecureFileIOQueue(maxConcurrency: 4)
+        let files = try (0..<4).map { try makeFile("file\($0)") }
+        queue.submit(files.enumerated().map {
+            .init(tag: $0.offset, operation: .write($0.element, offset: 0, data: pattern(count: 10_000, seed: 1)))
+        })
+        XCTAssertEqual(reapAll(queue, count: files.count).count, files.count)
+        for file in files {
+            XCTAssertEqual(try file.read(length: 10_000, at: 0), pattern(count: 10_000, seed: 1))
+        }
+    }
+
+    func testFailuresAreReportedPerRequest() throws {
+        let file = try makeFile("closed")
+        file.close()
+        let queue = SecureFileIOQueue()
+        queue.submit([.init(tag: 1, operation: .read(file, offset: 0, length: 1))])
+        let completion = reapAll(queue, count: 1)[1]
+        XCTAssertThrowsError(try completion?.result.get())
+    }
+
+    func testReapHonoursDeadline() {
+        let queue = SecureFileIOQueue()
+        XCTAssertTrue(queue.reap(minimum: 1, deadline: Date()).isEmpty)
+    }
+
+    /// Reads 8 files of 1 MB in 64 KB requests with at most `depth` requests running at once.
+    private func measureReads(depth: Int) throws {
+        let request = 64 * 1024
+        let length = 1024 * 1024
+        let files = try (0..<8).map { try makeFile("depth\($0)") }
+        defer { files.forEach { $0.close() } }
+        for file in files {
+            try file.write(pattern(count: length), at: 0)
+        }
+        let requests = files.enumerated().flatMap { index, file in
+            (0..<(length / request)).map {
+                SecureFileIOQueue.Request(tag: index * length + $0,
+                                          operation: .read(file, offset: UInt64($0 * request), length: request))
+            }
+        }
+        let queue = SecureFileIOQueue(maxConcurrency: depth)
+        measure {
+            queue.submit(requests)
+            XCTAssertEqual(reapInOrder(queue, count: requests.count).count, requests.count)
+        }
+    }
+
+    func testQueueDepthOnePerformance() throws {
+        try measureReads(depth: 1)
+    }
+
+    func testQueueDepthFourPerformance() throws {
+        try measureReads(depth: 4)
+    }
+
+    func testQueueDepthSixteenPerformance() throws {
+        try measureReads(depth: 16)
+    }
+}
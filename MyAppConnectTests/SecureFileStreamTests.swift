@@ -0,0 +1,49 @@
+//
+//  SecureFileStreamTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import AppConnect
+@testable import MyAppConnect
+
+class SecureFileStreamTests: SecureFileTestCase {
+    func testReaderNeverHoldsMoreThanItsBuffer() throws {
+        let contents = pattern(count: 100_000)
+        let file = try makeFile("stream")
+        try file.write(contents, at: 0)
+        try file.seek(to: 0)
+
+        var streamed = Data()
+        var runs = 0
+        try SecureFileStreamReader(source: file, bufferSize: 4096).forEach { run in
+            XCTAssertLessThanOrEqual(run.count, 4096)
+            streamed.append(contentsOf: run)
+            runs += 1
+        }
+        XCTAssertEqual(streamed, contents)
+        XCTAssertEqual(runs, (contents.count + 4095) / 4096)
+    }
+
+    func testEmptySourceYieldsNothing() throws {
+        let file = try makeFile("empty")
+        let reader = try SecureFileStreamReader(source: file, bufferSize: 64)
+        XCTAssertNil(try reader.next())
+    }
+
+    func testStreamSecureContents() throws {
+        try requireAppConnect()
+        let contents = pattern(count: 200_000)
+        try FileManager.default.createSecureFile(atPath: path("secure"), contents: contents, attributes: nil)
+
+        var streamed = Data()
+        try FileManager.default.streamSecureContents(atPath: path("secure"), bufferSize: 8192) {
+            XCTAssertLessThanOrEqual($0.count, 8192)
+            streamed.append(contentsOf: $0)
+        }
+        XCTAssertEqual(streamed, contents)
+    }
+}
@@ -0,0 +1,94 @@
+//
+//  SecureFileTestCase.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import CryptoKit
+import AppConnect
+@testable import MyAppConnect
+
+/// Key provider with random in-memory keys, so secure chunked files can be exercised without AppConnect.
+final class FixedKeyProvider: SecureFileKeyProvider {
+    private var keys: [SecureFileKeyDomain: SymmetricKey] = [:]
+    private(set) var requests = 0
+
+    func keyEncryptionKey(for domain: SecureFileKeyDomain) throws -> SymmetricKey {
+        requests += 1
+        if let key = keys[domain] {
+            return key
+        }
+        let key = SymmetricKey(size: .bits256)
+        keys[domain] = key
+        return key
+    }
+}
+
+/// Base class for tests that work on files: each test gets an empty scratch directory and its own keys.
+class SecureFileTestCase: XCTestCase {
+    var directory: String!
+    var keyProvider: FixedKeyProvider!
+
+    override func setUp() {
+        super.setUp()
+        directory = (NSTemporaryDirectory() as NSString).appendingPathComponent(UUID().uuidString)
+        keyProvider = FixedKeyProvider()
+        XCTAssertNoThrow(try FileManager.default.createDirectory(atPath: directory,
+                                                                 withIntermediateDirectories: true))
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(atPath: directory)
+        super.tearDown()
+    }
+
+    func path(_ name: String) -> String {
+        return (directory as NSString).appendingPathComponent(name)
+    }
+
+    func makeFile(_ name: String, flags: Int32 = O_RDWR | O_CREAT, chunkSize: Int = 4096,
+                  cacheBudget: Int = 0) throws -> SecureChunkedFile {
+        return try SecureChunkedFile(path: path(name), flags: flags, keyProvider: keyProvider, chunkSize: chunkSize,
+                                     cacheBudget: cacheBudget)
+    }
+
+    /// Deterministic bytes that differ from chunk to chunk, so misplaced chunks are noticed.
+    func pattern(count: Int, seed: UInt8 = 0) -> Data {
+        return Data((0..<count).map { UInt8(truncatingIfNeeded: $0 &* 31 &+ $0 / 4096 &+ Int(seed)) })
+    }
+
+    /// Overwrites `count` raw bytes of `path` at `offset` with their complement.
+    func flipBytes(of path: String, at offset: off_t, count: Int = 1) {
+        let fd = Darwin.open(path, O_RDWR)
+        XCTAssertGreaterThanOrEqual(fd, 0)
+        defer { Darwin.close(fd) }
+        var bytes = [UInt8](repeating: 0, count: count)
+        XCTAssertEqual(Darwin.pread(fd, &bytes, count, offset), count)
+        bytes = bytes.map { ~$0 }
+        XCTAssertEqual(Darwin.pwrite(fd, bytes, count, offset), count)
+    }
+
+    func rawSize(of path: String) -> off_t {
+        var info = stat()
+        XCTAssertEqual(stat(path, &info), 0)
+        return info.st_size
+    }
+
+    func assertThrows(_ expected: NSError, file: StaticString = #file, line: UInt = #line,
+                      _ body: () throws -> Void) {
+        XCTAssertThrowsError(try body(), file: file, line: line) { error in
+            XCTAssertEqual(error as NSError, expected, file: file, line: line)
+        }
+    }
+
+    /// Skips tests that need AppConnect secure services, which are only available on an enrolled device.
+    func requireAppConnect() throws {
+        guard let appConnect = AppConnect.sharedInstance(), appConnect.isReady,
+            appConnect.secureServicesAvailability == .available else {
+            throw XCTSkip("AppConnect secure services are not available")
+        }
+    }
+}
@@ -0,0 +1,134 @@
+//
+//  SecureGroupCommitTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureGroupCommitTests: SecureFileTestCase {
+    private var groupCommit: SecureGroupCommit!
+
+    override func setUp() {
+        super.setUp()
+        groupCommit = SecureGroupCommit(keyProvider: keyProvider)
+    }
+
+    private func write(_ data: Data, to name: String) throws {
+        try groupCommit.write(data, toPath: path(name), format: .chunked(.app))
+    }
+
+    private func contents(_ name: String) throws -> Data {
+        let file = try makeFile(name, flags: O_RDONLY)
+        defer { file.close() }
+        return try file.read(length: Int(file.length), at: 0)
+    }
+
+    private func temporaryFiles() throws -> [String] {
+        return try FileManager.default.contentsOfDirectory(atPath: directory).filter { $0.hasSuffix(".tmp") }
+    }
+
+    func testWriteReplacesTheFile() throws {
+        try write(pattern(count: 10_000, seed: 1), to: "document")
+        try write(pattern(count: 500, seed: 2), to: "document")
+        XCTAssertEqual(try contents("document"), pattern(count: 500, seed: 2))
+        XCTAssertEqual(try temporaryFiles(), [])
+        XCTAssertEqual(groupCommit.statistics.files, 2)
+    }
+
+    func testConcurrentWritersAllCommit() throws {
+        let count = 16
+        var failures = 0
+        let lock = NSLock()
+        DispatchQueue.concurrentPerform(iterations: count) { index in
+            do {
+                try write(pattern(count: 3000, seed: UInt8(index)), to: "file\(index)")
+            } catch {
+                lock.lock()
+                failures += 1
+                lock.unlock()
+            }
+        }
+        XCTAssertEqual(failures, 0)
+        XCTAssertEqual(groupCommit.statistics.files, count)
+        XCTAssertLessThanOrEqual(groupCommit.statistics.commits, count)
+        for index in 0..<count {
+            XCTAssertEqual(try contents("file\(index)"), pattern(count: 3000, seed: UInt8(index)))
+        }
+    }
+
+    func testCrashBeforeRenameKeepsTheOldContents() throws {
+        try write(pattern(count: 5000, seed: 1), to: "document")
+        let crashing = SecureGroupCommit(keyProvider: keyProvider, crashPoint: .synced)
+        assertThrows(SecureFileError.posix(ECANCELED)) {
+            try crashing.write(self.pattern(count: 7000, seed: 2), toPath: self.path("document"),
+                               format: .chunked(.app))
+        }
+        XCTAssertEqual(try contents("document"), pattern(count: 5000, seed: 1))
+
+        // The new contents are complete and durable in the temporary file a crash would leave behind.
+        let leftovers = try temporaryFiles()
+        XCTAssertEqual(leftovers.count, 1)
+        XCTAssertEqual(try contents(leftovers[0]), pattern(count: 7000, seed: 2))
+    }
+
+    func testCrashAfterRenameHasTheNewContents() throws {
+        try write(pattern(count: 5000, seed: 1), to: "document")
+        let crashing = SecureGroupCommit(keyProvider: keyProvider, crashPoint: .renamed)
+        assertThrows(SecureFileError.posix(ECANCELED)) {
+            try crashing.write(self.pattern(count: 7000, seed: 2), toPath: self.path("document"),
+                               format: .chunked(.app))
+        }
+        XCTAssertEqual(try contents("document"), pattern(count: 7000, seed: 2))
+        XCTAssertEqual(try temporaryFiles(), [])
+    }
+
+    func testTemporaryFilesOfAnEarlierRunAreRemoved() throws {
+        let orphan = ".document.\(UUID().uuidString).tmp"
+        let recent = ".other.\(UUID().uuidString).tmp"
+        for name in [orphan, recent, "keep.tmp"] {
+            XCTAssertTrue(FileManager.default.createFile(atPath: path(name), contents: Data([1])))
+        }
+        // Only the orphan predates this run.
+        var times = [timeval(tv_sec: 1000, tv_usec: 0), timeval(tv_sec: 1000, tv_usec: 0)]
+        XCTAssertEqual(utimes(path(orphan), &times), 0)
+
+        try write(pattern(count: 100), to: "document")
+        XCTAssertEqual(Set(try temporaryFiles()), [recent, "keep.tmp"])
+        XCTAssertFalse(SecureGroupCommit.isTemporaryName("keep.tmp"))
+        XCTAssertTrue(SecureGroupCommit.isTemporaryName(orphan))
+    }
+
+    func testFailedTemporaryWriteLeavesTheDestination() throws {
+        try write(pattern(count: 100), to: "document")
+        XCTAssertThrowsError(try groupCommit.write(Data([1]), toPath: path("missing/document"), format: .chunked(.app)))
+        XCTAssertEqual(try contents("document"), pattern(count: 100))
+    }
+
+    /// 64 documents of 4 KB written by 8 threads at once, each through the commit `committer` returns for its thread.
+    private func measureBurst(_ committer: (Int) -> SecureGroupCommit) {
+        let documents = (0..<64).map { pattern(count: 4096, seed: UInt8($0)) }
+        measure {
+            DispatchQueue.concurrentPerform(iterations: 8) { thread in
+                for index in stride(from: thread, to: documents.count, by: 8) {
+                    XCTAssertNoThrow(try committer(thread).write(documents[index], toPath: self.path("doc\(index)"),
+                                                                 format: .chunked(.app)))
+                }
+            }
+        }
+    }
+
+    func testGroupCommitPerformance() {
+        let groupCommit = self.groupCommit!
+        measureBurst { _ in groupCommit }
+    }
+
+    /// One commit per thread, so no two writes share a flush: the baseline for `testGroupCommitPerformance`.
+    func testCommitPerWriterPerformance() {
+        let commits = (0..<8).map { _ in SecureGroupCommit(keyProvider: keyProvider) }
+        measureBurst { commits[$0] }
+    }
+}
@@ -0,0 +1,137 @@
+//
+//  SecureIOVecTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureIOVecTests: SecureFileTestCase {
+    /// Splits `buffer` into vectors of the given sizes, which must add up to its length.
+    private func withVectors<R>(_ buffer: UnsafeMutableRawBufferPointer, sizes: [Int],
+                                _ body: (UnsafeBufferPointer<iovec>) throws -> R) rethrows -> R {
+        var offset = 0
+        let vectors = sizes.map { size -> iovec in
+            defer { offset += size }
+            return iovec(iov_base: buffer.baseAddress! + offset, iov_len: size)
+        }
+        return try vectors.withUnsafeBufferPointer(body)
+    }
+
+    func testCursorGatherAndScatterAcrossVectors() {
+        var storage = [UInt8](repeating: 0, count: 10)
+        storage.withUnsafeMutableBytes { buffer in
+            withVectors(buffer, sizes: [3, 0, 4, 3]) { vectors in
+                var cursor = SecureIOVecCursor(vectors)
+                XCTAssertEqual(cursor.remaining, 10)
+                XCTAssertNotNil(cursor.contiguous(3))
+                XCTAssertNil(cursor.contiguous(4))
+                [UInt8](0..<10).withUnsafeBytes { cursor.scatter(from: $0) }
+                XCTAssertEqual(cursor.remaining, 0)
+            }
+        }
+        XCTAssertEqual(storage, [UInt8](0..<10))
+
+        var gathered = [UInt8](repeating: 0, count: 10)
+        storage.withUnsafeMutableBytes { buffer in
+            withVectors(buffer, sizes: [1, 9]) { vectors in
+                var cursor = SecureIOVecCursor(vectors)
+                gathered.withUnsafeMutableBytes { cursor.gather(into: $0) }
+            }
+        }
+        XCTAssertEqual(gathered, storage)
+    }
+
+    func testVectoredWriteAndReadRoundTrip() throws {
+        let chunkSize = 4096
+        let sizes = [100, chunkSize, chunkSize * 2 + 17, 1, chunkSize - 118]
+        var contents = [UInt8](pattern(count: sizes.reduce(0, +)))
+        let file = try makeFile("vectored")
+        try contents.withUnsafeMutableBytes { buffer in
+            try withVectors(buffer, sizes: sizes) { try file.write($0, at: 50) }
+        }
+        XCTAssertEqual(try file.read(length: contents.count, at: 50), Data(contents))
+
+        var readBack = [UInt8](repeating: 0, count: contents.count)
+        let count = try readBack.withUnsafeMutableBytes { buffer in
+            try withVectors(buffer, sizes: sizes.reversed()) { try file.read(into: $0, at: 50) }
+        }
+        XCTAssertEqual(count, contents.count)
+        XCTAssertEqual(readBack, contents)
+    }
+
+    func testSequentialVectoredCallsAdvanceThePosition() throws {
+        let file = try makeFile("sequential")
+        var first = [UInt8](repeating: 1, count: 5000)
+        var second = [UInt8](repeating: 2, count: 300)
+        try first.withUnsafeMutableBytes { buffer in
+            try withVectors(buffer, sizes: [2500, 2500]) { try file.write($0) }
+        }
+        try second.withUnsafeMutableBytes { buffer in
+            try withVectors(buffer, sizes: [300]) { try file.write($0) }
+        }
+        XCTAssertEqual(file.length, 5300)
+
+        try file.seek(to: 0)
+        var readBack = [UInt8](repeating: 0, count: 5300)
+        let count = try readBack.withUnsafeMutableBytes { buffer in
+            try withVectors(buffer, sizes: [4096, 1204]) { try file.read(into: $0) }
+        }
+        XCTAssertEqual(count, 5300)
+        XCTAssertEqual(readBack, first + second)
+    }
+
+    /// Writes and reads back 1 MB split into `vectorCount` equal vectors.
+    private func measureVectoredIO(vectorCount: Int) throws {
+        let length = 1024 * 1024
+        var contents = [UInt8](pattern(count: length))
+        let sizes = [Int](repeating: length / vectorCount, count: vectorCount)
+        let file = try makeFile("vectored")
+        defer { file.close() }
+        contents.withUnsafeMutableBytes { buffer in
+            withVectors(buffer, sizes: sizes) { vectors in
+                measure {
+                    XCTAssertNoThrow(try file.write(vectors, at: 0))
+                    XCTAssertEqual(try file.read(into: vectors, at: 0), length)
+                }
+            }
+        }
+    }
+
+    func testOneVectorPerformance() throws {
+        try measureVectoredIO(vectorCount: 1)
+    }
+
+    func testSixteenVectorsPerformance() throws {
+        try measureVectoredIO(vectorCount: 16)
+    }
+
+    func testTwoHundredFiftySixVectorsPerformance() throws {
+        try measureVectoredIO(vectorCount: 256)
+    }
+
+    /// The 256 vectors gathered into one buffer and written with a single call, then read back and scattered, as
+    /// callers did before vectored I/O: the baseline for `testTwoHundredFiftySixVectorsPerformance`.
+    func testGatherAndScatterByHandPerformance() throws {
+        let length = 1024 * 1024
+        let vectorSize = length / 256
+        let contents = pattern(count: length)
+        let pieces = (0..<256).map { contents.subdata(in: $0 * vectorSize..<($0 + 1) * vectorSize) }
+        var readBack = pieces
+        let file = try makeFile("gathered")
+        defer { file.close() }
+        measure {
+            var gathered = Data(capacity: length)
+            pieces.forEach { gathered.append($0) }
+            XCTAssertNoThrow(try file.write(gathered, at: 0))
+            guard let data = try? file.read(length: length, at: 0) else { return XCTFail("read failed") }
+            for index in readBack.indices {
+                readBack[index] = data.subdata(in: index * vectorSize..<(index + 1) * vectorSize)
+            }
+        }
+        XCTAssertEqual(readBack, pieces)
+    }
+}
@@ -0,0 +1,130 @@
+//
+//  SecureKeyCacheTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import CryptoKit
+@testable import MyAppConnect
+
+class SecureKeyCacheTests: XCTestCase {
+    private var derivations = 0
+
+    private func derive(_ value: UInt8) -> () -> SymmetricKey {
+        return {
+            self.derivations += 1
+            return SymmetricKey(data: Data(repeating: value, count: 32))
+        }
+    }
+
+    private func bytes(_ key: SymmetricKey) -> Data {
+        return key.withUnsafeBytes { Data($0) }
+    }
+
+    func testKeysAreDerivedOnce() {
+        let cache = SecureKeyCache<String>(capacity: 4)
+        XCTAssertEqual(bytes(cache.key(for: "a", derive: derive(1))), Data(repeating: 1, count: 32))
+        XCTAssertEqual(bytes(cache.key(for: "a", derive: derive(2))), Data(repeating: 1, count: 32))
+        XCTAssertEqual(derivations, 1)
+        XCTAssertEqual(cache.statistics.hits, 1)
+        XCTAssertEqual(cache.statistics.misses, 1)
+        XCTAssertEqual(cache.statistics.hitRate, 0.5)
+    }
+
+    func testLeastRecentlyUsedKeyIsEvicted() {
+        let cache = SecureKeyCache<String>(capacity: 2)
+        _ = cache.key(for: "a", derive: derive(1))
+        _ = cache.key(for: "b", derive: derive(2))
+        _ = cache.key(for: "a", derive: derive(1))
+        _ = cache.key(for: "c", derive: derive(3))
+        XCTAssertEqual(cache.statistics.evictions, 1)
+
+        _ = cache.key(for: "a", derive: derive(1))
+        XCTAssertEqual(derivations, 3)
+        _ = cache.key(for: "b", derive: derive(2))
+        XCTAssertEqual(derivations, 4)
+    }
+
+    func testFlushForcesDerivation() {
+        let cache = SecureKeyCache<String>(capacity: 2)
+        _ = cache.key(for: "a", derive: derive(1))
+        cache.removeAll()
+        cache.removeAll()
+        XCTAssertEqual(cache.statistics.flushes, 1)
+        _ = cache.key(for: "a", derive: derive(1))
+        XCTAssertEqual(derivations, 2)
+    }
+
+    func testFailedDerivationCachesNothing() {
+        let cache = SecureKeyCache<String>(capacity: 2)
+        XCTAssertThrowsError(try cache.key(for: "a") { throw SecureFileError.noKeys })
+        _ = cache.key(for: "a", derive: derive(1))
+        XCTAssertEqual(derivations, 1)
+        XCTAssertEqual(cache.statistics.misses, 2)
+    }
+
+    func testNewerGenerationFlushesTheCache() {
+        let cache = SecureKeyCache<String>(capacity: 4)
+        _ = cache.key(for: "a", generation: 1, derive: derive(1))
+        _ = cache.key(for: "a", generation: 1, derive: derive(2))
+        XCTAssertEqual(derivations, 1)
+
+        XCTAssertEqual(bytes(cache.key(for: "a", generation: 2, derive: derive(3))), Data(repeating: 3, count: 32))
+        XCTAssertEqual(derivations, 2)
+        XCTAssertEqual(cache.statistics.flushes, 1)
+
+        // A lookup that read its generation before the flush gets a key of its own that is never cached.
+        XCTAssertEqual(bytes(cache.key(for: "b", generation: 1, derive: derive(4))), Data(repeating: 4, count: 32))
+        XCTAssertEqual(bytes(cache.key(for: "b", generation: 2, derive: derive(5))), Data(repeating: 5, count: 32))
+        XCTAssertEqual(derivations, 4)
+    }
+
+    func testConcurrentLookupsAgreeOnTheCachedKey() {
+        let cache = SecureKeyCache<String>(capacity: 8)
+        let lock = NSLock()
+        var keys = Set<Data>()
+        DispatchQueue.concurrentPerform(iterations: 100) { _ in
+            let key = cache.key(for: "shared") { SymmetricKey(size: .bits256) }
+            lock.lock()
+            keys.insert(bytes(key))
+            lock.unlock()
+        }
+        // Lookups that missed together may each see their own key; every later lookup sees the cached one.
+        XCTAssertLessThanOrEqual(keys.count, cache.statistics.misses)
+        XCTAssertEqual(cache.statistics.hits + cache.statistics.misses, 100)
+        let cached = bytes(cache.key(for: "shared") { SymmetricKey(size: .bits256) })
+        XCTAssertTrue(keys.contains(cached))
+    }
+
+    /// Lookups of 16 group keys from every core at once; every lookup after the first 16 hits.
+    private func measureGroupKeyLookups(_ lookup: (String) -> SymmetricKey) {
+        let groups = (0..<16).map { "group\($0)" }
+        measure {
+            DispatchQueue.concurrentPerform(iterations: ProcessInfo.processInfo.activeProcessorCount) { thread in
+                for index in 0..<10_000 {
+                    _ = lookup(groups[(thread + index) % groups.count])
+                }
+            }
+        }
+    }
+
+    func testConcurrentLookupPerformance() {
+        let cache = SecureKeyCache<String>(capacity: 16)
+        let master = SymmetricKey(size: .bits256)
+        measureGroupKeyLookups { group in
+            cache.key(for: group) { SecureKeyDerivation.deriveKey(from: master, salt: Data(), info: group) }
+        }
+    }
+
+    /// An HKDF per lookup, as each group key cost before it was cached: the baseline for
+    /// `testConcurrentLookupPerformance`.
+    func testDerivationPerLookupPerformance() {
+        let master = SymmetricKey(size: .bits256)
+        measureGroupKeyLookups { group in
+            SecureKeyDerivation.deriveKey(from: master, salt: Data(), info: group)
+        }
+    }
+}
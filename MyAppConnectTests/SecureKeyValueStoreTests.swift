@@ -0,0 +1,186 @@
+//
+//  SecureKeyValueStoreTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureKeyValueStoreTests: SecureFileTestCase {
+    private func key(_ index: Int) -> Data {
+        return Data("key-\(index)".utf8)
+    }
+
+    private func makeStore(_ name: String, memtableBudget: Int = SecureKeyValueStore.defaultMemtableBudget) throws
+        -> SecureKeyValueStore {
+        return try SecureKeyValueStore(directory: path(name), keyProvider: keyProvider, memtableBudget: memtableBudget)
+    }
+
+    /// Copies the files of a store that is still open, which is what a crash leaves behind once writes are durable.
+    private func snapshot(_ name: String, as copy: String) throws {
+        try FileManager.default.copyItem(atPath: path(name), toPath: path(copy))
+    }
+
+    private func newestLog(in name: String) throws -> String {
+        let logs = try FileManager.default.contentsOfDirectory(atPath: path(name)).compactMap { entry -> UInt64? in
+            return entry.hasPrefix("log-") ? UInt64(entry.dropFirst(4)) : nil
+        }
+        return (path(name) as NSString).appendingPathComponent("log-\(logs.max() ?? 0)")
+    }
+
+    func testAcknowledgedWritesSurviveCrash() throws {
+        let store = try makeStore("store")
+        for index in 0..<200 {
+            try store.setValue(pattern(count: index, seed: UInt8(index % 256)), forKey: key(index))
+        }
+        try store.removeValue(forKey: key(7))
+        try store.write([(key: key(8), value: Data("eight".utf8)), (key: key(9), value: nil)])
+        try snapshot("store", as: "crashed")
+        store.close()
+
+        let reopened = try makeStore("crashed")
+        defer { reopened.close() }
+        XCTAssertNil(try reopened.value(forKey: key(7)))
+        XCTAssertEqual(try reopened.value(forKey: key(8)), Data("eight".utf8))
+        XCTAssertNil(try reopened.value(forKey: key(9)))
+        XCTAssertEqual(try reopened.value(forKey: key(199)), pattern(count: 199, seed: 199))
+        XCTAssertEqual(try reopened.value(forKey: key(0)), Data())
+    }
+
+    func testTornCommitIsDroppedOnReopen() throws {
+        let store = try makeStore("store")
+        try store.setValue(Data("kept".utf8), forKey: key(1))
+        try snapshot("store", as: "crashed")
+        store.close()
+
+        // A commit whose frame claims more bytes than reached the log before the crash.
+        let log = try SecureChunkedFile(path: newestLog(in: "crashed"), keyProvider: keyProvider,
+                                        chunkSize: SecureKeyValueStore.logChunkSize, cacheBudget: 0)
+        let chunkSize = UInt64(SecureKeyValueStore.logChunkSize)
+        var torn = Data()
+        SecureKeyValueCodec.append(UInt32(10_000), to: &torn)
+        SecureKeyValueCodec.append(key: key(2), value: Data("lost".utf8), to: &torn)
+        try log.write(torn, at: (log.length + chunkSize - 1) / chunkSize * chunkSize)
+        log.close()
+
+        let reopened = try makeStore("crashed")
+        XCTAssertEqual(try reopened.value(forKey: key(1)), Data("kept".utf8))
+        XCTAssertNil(try reopened.value(forKey: key(2)))
+        // The torn tail is cut off, so commits after the crash replay on the next open.
+        try reopened.setValue(Data("after".utf8), forKey: key(3))
+        reopened.close()
+
+        let again = try makeStore("crashed")
+        defer { again.close() }
+        XCTAssertEqual(try again.value(forKey: key(1)), Data("kept".utf8))
+        XCTAssertNil(try again.value(forKey: key(2)))
+        XCTAssertEqual(try again.value(forKey: key(3)), Data("after".utf8))
+    }
+
+    func testCorruptCommitInTheMiddleFailsTheOpen() throws {
+        let store = try makeStore("store")
+        for index in 1...3 {
+            try store.setValue(Data("value \(index)".utf8), forKey: key(index))
+        }
+        try snapshot("store", as: "crashed")
+        store.close()
+
+        // Each commit starts on a chunk of its own; damage the second of the three.
+        let log = try newestLog(in: "crashed")
+        let file = try SecureChunkedFile(path: log, flags: O_RDONLY, keyProvider: keyProvider, cacheBudget: 0)
+        let slotSize = file.slotSize
+        file.close()
+        flipBytes(of: log, at: off_t(SecureChunkedFileHeader.size + slotSize + 20))
+        let damaged = FileManager.default.contents(atPath: log)
+
+        assertThrows(SecureFileError.badKeyOrCorruptData) {
+            _ = try self.makeStore("crashed")
+        }
+        // The third commit was acknowledged, so the log must not have been cut before it.
+        XCTAssertEqual(FileManager.default.contents(atPath: log), damaged)
+    }
+
+    func testFlushedSegmentsSurviveReopen() throws {
+        let store = try makeStore("store", memtableBudget: 4096)
+        for index in 0..<1000 {
+            try store.setValue(pattern(count: 64, seed: UInt8(index % 256)), forKey: key(index))
+        }
+        for index in stride(from: 0, to: 1000, by: 10) {
+            try store.removeValue(forKey: key(index))
+        }
+        store.close()
+        XCTAssertGreaterThan(store.statistics.flushes, 0)
+
+        let reopened = try makeStore("store", memtableBudget: 4096)
+        defer { reopened.close() }
+        for index in 0..<1000 {
+            let expected: Data? = index % 10 == 0 ? nil : pattern(count: 64, seed: UInt8(index % 256))
+            XCTAssertEqual(try reopened.value(forKey: key(index)), expected, "key \(index)")
+        }
+    }
+
+    func testWritesAfterCloseFail() throws {
+        let store = try makeStore("store")
+        store.close()
+        assertThrows(SecureFileError.posix(EBADF)) {
+            try store.setValue(Data("late".utf8), forKey: key(1))
+        }
+    }
+
+    // MARK: Performance
+
+    private let recordCount = 10_000
+
+    /// A store holding `recordCount` 100 byte values.
+    private func makeLoadedStore(_ name: String) throws -> SecureKeyValueStore {
+        let store = try makeStore(name)
+        for index in 0..<recordCount {
+            try store.setValue(pattern(count: 100, seed: UInt8(index % 256)), forKey: key(index))
+        }
+        return store
+    }
+
+    /// Runs 20,000 operations on random keys, of which one in `writeEvery` is an update and the rest are reads.
+    private func run(_ store: SecureKeyValueStore, writeEvery: Int) {
+        var random = SystemRandomNumberGenerator()
+        for operation in 0..<20_000 {
+            let index = Int.random(in: 0..<recordCount, using: &random)
+            if operation % writeEvery == 0 {
+                XCTAssertNoThrow(try store.setValue(pattern(count: 100, seed: UInt8(operation % 256)),
+                                                    forKey: key(index)))
+            } else {
+                XCTAssertNoThrow(try store.value(forKey: key(index)))
+            }
+        }
+    }
+
+    func testLoadPerformance() {
+        measure {
+            guard let store = try? makeLoadedStore(UUID().uuidString) else {
+                return XCTFail()
+            }
+            store.close()
+        }
+    }
+
+    /// 95% reads.
+    func testReadHeavyPerformance() throws {
+        let store = try makeLoadedStore("store")
+        defer { store.close() }
+        measure {
+            run(store, writeEvery: 20)
+        }
+    }
+
+    /// 50% updates.
+    func testUpdateHeavyPerformance() throws {
+        let store = try makeLoadedStore("store")
+        defer { store.close() }
+        measure {
+            run(store, writeEvery: 2)
+        }
+    }
+}
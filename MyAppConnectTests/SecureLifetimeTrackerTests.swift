@@ -0,0 +1,106 @@
+//
+//  SecureLifetimeTrackerTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureLifetimeTrackerTests: XCTestCase {
+    /// Lets the tracker's timer and the main run loop observer run.
+    private func spin(for interval: TimeInterval) {
+        let end = Date(timeIntervalSinceNow: interval)
+        while Date() < end {
+            RunLoop.main.run(until: Date(timeIntervalSinceNow: 0.01))
+        }
+    }
+
+    func testDisabledTrackerDoesNothing() {
+        let tracker = SecureLifetimeTracker(environment: [:])
+        XCTAssertFalse(tracker.isEnabled)
+        let object = NSObject()
+        tracker.track(object, size: 8)
+        XCTAssertTrue(tracker.overdueInstances().isEmpty)
+    }
+
+    func testObjectsAliveTooLongAreReported() {
+        let tracker = SecureLifetimeTracker(maxLifetime: 0.25, maxRunLoopIterations: nil, sampleInterval: 1)
+        let kept = NSObject()
+        var released: NSObject? = NSObject()
+        tracker.track(kept, size: 32)
+        tracker.track(released!, size: 64)
+        released = nil
+        XCTAssertTrue(tracker.overdueInstances().isEmpty)
+
+        spin(for: 0.8)
+        let reports = tracker.overdueInstances()
+        XCTAssertEqual(reports.count, 1)
+        XCTAssertEqual(reports.first?.size, 32)
+        XCTAssertGreaterThanOrEqual(reports.first?.age ?? 0, 0.25)
+        XCTAssertFalse(reports.first?.allocationSite.isEmpty ?? true)
+        XCTAssertNil(reports.first?.runLoopIterations)
+    }
+
+    /// An object past both limits is in the timing wheel and in the run loop list, but is reported once.
+    func testObjectPastBothLimitsIsReportedOnce() {
+        let tracker = SecureLifetimeTracker(maxLifetime: 0.25, maxRunLoopIterations: 2)
+        let objects = (0..<3).map { _ in NSObject() }
+        for object in objects {
+            tracker.track(object, size: 16)
+        }
+        spin(for: 0.8)
+        let reports = tracker.overdueInstances()
+        XCTAssertEqual(reports.count, objects.count)
+        XCTAssertGreaterThanOrEqual(reports.first?.runLoopIterations ?? 0, 2)
+
+        spin(for: 0.3)
+        XCTAssertEqual(tracker.overdueInstances().count, objects.count)
+    }
+
+    func testRunLoopLimitAlone() {
+        let tracker = SecureLifetimeTracker(maxLifetime: nil, maxRunLoopIterations: 3)
+        let object = NSObject()
+        tracker.track(object, size: 16)
+        XCTAssertTrue(tracker.overdueInstances().isEmpty)
+        spin(for: 0.5)
+        XCTAssertEqual(tracker.overdueInstances().count, 1)
+    }
+
+    func testHugeLifetimesAreClamped() {
+        for lifetime in [TimeInterval.infinity, 1e300, TimeInterval.greatestFiniteMagnitude] {
+            let tracker = SecureLifetimeTracker(maxLifetime: lifetime, maxRunLoopIterations: nil)
+            XCTAssertEqual(tracker.maxLifetime, SecureLifetimeTracker.longestLifetime)
+            let object = NSObject()
+            tracker.track(object, size: 8)
+            XCTAssertTrue(tracker.overdueInstances().isEmpty)
+        }
+        XCTAssertNil(SecureLifetimeTracker(maxLifetime: .nan, maxRunLoopIterations: nil).maxLifetime)
+    }
+
+    /// Threads only have a few hundred keys, so trackers must give theirs back.
+    func testReleasedTrackersDeleteTheirThreadKey() {
+        for _ in 0..<Int(PTHREAD_KEYS_MAX) + 10 {
+            let tracker = SecureLifetimeTracker(maxLifetime: 60, maxRunLoopIterations: nil)
+            let object = NSObject()
+            tracker.track(object, size: 8)
+        }
+        let tracker = SecureLifetimeTracker(maxLifetime: 0.25, maxRunLoopIterations: nil)
+        let object = NSObject()
+        tracker.track(object, size: 8)
+        spin(for: 0.8)
+        XCTAssertEqual(tracker.overdueInstances().count, 1)
+    }
+
+    func testTrackingOverhead() {
+        let tracker = SecureLifetimeTracker(maxLifetime: 60, maxRunLoopIterations: nil)
+        let objects = (0..<10_000).map { _ in NSObject() }
+        measure {
+            for object in objects {
+                tracker.track(object, size: 32)
+            }
+        }
+    }
+}
@@ -0,0 +1,112 @@
+//
+//  SecureMappedViewTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import UIKit
+@testable import MyAppConnect
+
+class SecureMappedViewTests: SecureFileTestCase {
+    private let pageSize = 4096
+
+    private func makeView(pages: Int, residentPages: Int) throws -> (SecureMappedView, Data) {
+        let contents = pattern(count: pageSize * pages - 100)
+        let file = try makeFile("mapped")
+        try file.write(contents, at: 0)
+        let view = try SecureMappedView(source: file, pageSize: pageSize, residentBudget: residentPages * pageSize)
+        return (view, contents)
+    }
+
+    func testPagesFaultOnceAndThenHit() throws {
+        let (view, contents) = try makeView(pages: 4, residentPages: 4)
+        XCTAssertEqual(try view.subdata(in: 10..<20), contents[10..<20])
+        XCTAssertEqual(try view.subdata(in: 30..<40), contents[30..<40])
+        XCTAssertEqual(view.statistics.faults, 1)
+        XCTAssertEqual(view.statistics.hits, 1)
+    }
+
+    func testResidentBudgetIsRespected() throws {
+        let (view, contents) = try makeView(pages: 6, residentPages: 2)
+        for page in 0..<6 {
+            XCTAssertEqual(try view.subdata(in: page * pageSize..<(page * pageSize + 1)),
+                           contents[(page * pageSize)..<(page * pageSize + 1)])
+        }
+        XCTAssertEqual(view.statistics.faults, 6)
+        XCTAssertEqual(view.statistics.evictions, 4)
+
+        // Pages 4 and 5 are resident; page 0 was dropped and faults again.
+        _ = try view.subdata(in: 5 * pageSize..<(5 * pageSize + 1))
+        _ = try view.subdata(in: 0..<1)
+        XCTAssertEqual(view.statistics.hits, 1)
+        XCTAssertEqual(view.statistics.faults, 7)
+    }
+
+    func testPurgeDropsEveryPage() throws {
+        let (view, _) = try makeView(pages: 2, residentPages: 2)
+        _ = try view.subdata(in: 0..<view.count)
+        view.purge()
+        _ = try view.subdata(in: 0..<view.count)
+        XCTAssertEqual(view.statistics.faults, 4)
+    }
+
+    func testMemoryWarningPurgesPages() throws {
+        let (view, _) = try makeView(pages: 2, residentPages: 2)
+        _ = try view.subdata(in: 0..<view.count)
+        NotificationCenter.default.post(name: UIApplication.didReceiveMemoryWarningNotification, object: nil)
+        _ = try view.subdata(in: 0..<view.count)
+        XCTAssertEqual(view.statistics.faults, 4)
+        XCTAssertEqual(view.statistics.hits, 0)
+    }
+
+    func testRecentlyHitPageSurvivesEviction() throws {
+        let (view, _) = try makeView(pages: 4, residentPages: 3)
+        for page in 0..<3 {
+            _ = try view.subdata(in: page * pageSize..<(page * pageSize + 1))
+        }
+        // Touching page 0 makes page 1 the least recently used, so page 3 evicts it.
+        _ = try view.subdata(in: 0..<1)
+        _ = try view.subdata(in: 3 * pageSize..<(3 * pageSize + 1))
+        _ = try view.subdata(in: 0..<1)
+        _ = try view.subdata(in: 2 * pageSize..<(2 * pageSize + 1))
+        XCTAssertEqual(view.statistics.hits, 3)
+        _ = try view.subdata(in: pageSize..<(pageSize + 1))
+        XCTAssertEqual(view.statistics.faults, 5)
+        XCTAssertEqual(view.statistics.evictions, 2)
+    }
+
+    func testRangesAcrossPages() throws {
+        let (view, contents) = try makeView(pages: 4, residentPages: 1)
+        let range = 100..<(3 * pageSize + 50)
+        XCTAssertEqual(try view.withUnsafeBytes(in: range) { Data($0) }, contents[range])
+
+        var runs: [Int] = []
+        var enumerated = Data()
+        try view.enumerateBytes(in: range) { bytes, offset in
+            runs.append(offset)
+            enumerated.append(contentsOf: bytes)
+        }
+        XCTAssertEqual(runs, [100, pageSize, 2 * pageSize, 3 * pageSize])
+        XCTAssertEqual(enumerated, contents[range])
+
+        var copy = [UInt8](repeating: 0, count: 500)
+        XCTAssertEqual(try copy.withUnsafeMutableBytes { try view.copyBytes(to: $0, from: view.count - 200) }, 200)
+        XCTAssertEqual(Data(copy.prefix(200)), contents.suffix(200))
+    }
+
+    func testAssembledRangesAreCapped() throws {
+        let pages = SecureMappedView.maximumAssembledRange / pageSize + 2
+        let (view, contents) = try makeView(pages: pages, residentPages: 2)
+        let range = 0..<(SecureMappedView.maximumAssembledRange + 1)
+        assertThrows(SecureFileError.invalidArgument) {
+            _ = try view.withUnsafeBytes(in: range) { $0.count }
+        }
+        XCTAssertEqual(try view.subdata(in: range), contents[range])
+        assertThrows(SecureFileError.invalidArgument) {
+            _ = try view.subdata(in: 0..<(view.count + 1))
+        }
+    }
+}
@@ -0,0 +1,99 @@
+//
+//  SecureMemoryTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import AppConnect
+@testable import MyAppConnect
+
+class SecureMemoryTests: XCTestCase {
+    private func equal(_ lhs: [UInt8], _ rhs: [UInt8]) -> Bool {
+        return lhs.withUnsafeBytes { left in rhs.withUnsafeBytes { SecureMemory.constantTimeEqual(left, $0) } }
+    }
+
+    func testWipeZeroesEveryByte() {
+        var bytes = [UInt8](repeating: 0xFF, count: 1000)
+        bytes.withUnsafeMutableBytes { SecureMemory.wipe(UnsafeMutableRawBufferPointer(rebasing: $0[3..<997])) }
+        XCTAssertEqual(bytes[0..<3], [0xFF, 0xFF, 0xFF])
+        XCTAssertFalse(bytes[3..<997].contains { $0 != 0 })
+        XCTAssertEqual(bytes[997...], [0xFF, 0xFF, 0xFF])
+        SecureMemory.wipe(UnsafeMutableRawBufferPointer(start: nil, count: 0))
+    }
+
+    /// Covers the 64 byte loop, the 16 byte loop and the scalar tail, with a difference at every position.
+    func testConstantTimeEqualFindsEveryDifference() {
+        for count in 0...200 {
+            let bytes = (0..<count).map { UInt8(truncatingIfNeeded: $0 &* 13) }
+            XCTAssertTrue(equal(bytes, bytes), "\(count)")
+            for position in 0..<count {
+                var changed = bytes
+                changed[position] ^= 0x80
+                XCTAssertFalse(equal(bytes, changed), "\(count) at \(position)")
+            }
+        }
+        XCTAssertFalse(equal([1, 2], [1, 2, 3]))
+        XCTAssertTrue(SecureMemory.constantTimeEqual(Data([1, 2, 3]), Data([1, 2, 3])))
+        XCTAssertFalse(SecureMemory.constantTimeEqual(Data([1, 2, 3]), Data([1, 2, 4])))
+    }
+
+    func testSecureBufferAndSensitiveDataComparison() throws {
+        let first = try SecureBuffer(count: 100)
+        let second = try SecureBuffer(count: 100)
+        XCTAssertTrue(first.isEqualInConstantTime(to: second))
+        first.bytes[99] = 1
+        XCTAssertFalse(first.isEqualInConstantTime(to: second))
+        first.wipe()
+        XCTAssertTrue(first.isEqualInConstantTime(to: second))
+
+        let data1 = try XCTUnwrap(ACSensitiveMutableData(length: 48))
+        let data2 = try XCTUnwrap(ACSensitiveMutableData(length: 48))
+        XCTAssertTrue(data1.isEqualInConstantTime(to: data2))
+        data1.mutableBytes.storeBytes(of: 7, toByteOffset: 40, as: UInt8.self)
+        XCTAssertFalse(data1.isEqualInConstantTime(to: data2))
+    }
+
+    func testShrinkingSensitiveDataWipesTheDroppedBytes() throws {
+        let data = try XCTUnwrap(ACSensitiveMutableData(length: 64))
+        memset(data.mutableBytes, 0xAB, 64)
+        data.setLengthWiping(16)
+        XCTAssertEqual(data.length, 16)
+        data.length = 64
+        let bytes = UnsafeRawBufferPointer(start: data.bytes, count: 64)
+        XCTAssertFalse(bytes[0..<16].contains { $0 != 0xAB })
+        XCTAssertFalse(bytes[16...].contains { $0 != 0 })
+        data.wipe()
+        XCTAssertFalse(UnsafeRawBufferPointer(start: data.bytes, count: 64).contains { $0 != 0 })
+    }
+
+    func testConstantTimeEqualThroughput() {
+        let lhs = [UInt8](repeating: 0x5A, count: 16 * 1024 * 1024)
+        let rhs = lhs
+        measure {
+            XCTAssertTrue(equal(lhs, rhs))
+        }
+    }
+
+    /// Byte-at-a-time baseline for `testConstantTimeEqualThroughput`.
+    func testScalarEqualThroughput() {
+        let lhs = [UInt8](repeating: 0x5A, count: 16 * 1024 * 1024)
+        let rhs = lhs
+        measure {
+            var difference: UInt8 = 0
+            for index in 0..<lhs.count {
+                difference |= lhs[index] ^ rhs[index]
+            }
+            XCTAssertEqual(difference, 0)
+        }
+    }
+
+    func testWipeThroughput() {
+        var bytes = [UInt8](repeating: 0xFF, count: 16 * 1024 * 1024)
+        measure {
+            bytes.withUnsafeMutableBytes { SecureMemory.wipe($0) }
+        }
+    }
+}
@@ -0,0 +1,48 @@
+//
+//  SecureParallelEncryptionTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureParallelEncryptionTests: SecureFileTestCase {
+    func testParallelWriteReadsBackLikeSerialWrite() throws {
+        // Unaligned start and end, so the run has partial chunks on both sides of the parallel part.
+        let contents = pattern(count: 4096 * 300 + 77)
+        let parallel = try makeFile("parallel")
+        parallel.parallelThreshold = 4096
+        parallel.maxConcurrency = 4
+        try parallel.write(contents, at: 1000)
+        parallel.close()
+
+        let serial = try makeFile("serial")
+        serial.maxConcurrency = 1
+        try serial.write(contents, at: 1000)
+        serial.close()
+
+        XCTAssertEqual(try makeFile("parallel").read(length: contents.count, at: 1000), contents)
+        XCTAssertEqual(rawSize(of: path("parallel")), rawSize(of: path("serial")))
+    }
+
+    func testParallelWriteSpansSeveralBatches() throws {
+        let file = try makeFile("batches", chunkSize: 16 * 1024)
+        file.parallelThreshold = 0
+        let contents = pattern(count: SecureChunkedFile.parallelBatchSize * 2 + 16 * 1024 * 3)
+        try file.write(contents, at: 0)
+        file.close()
+
+        XCTAssertEqual(try makeFile("batches").read(length: contents.count, at: 0), contents)
+    }
+
+    func testParallelPerformance() throws {
+        let contents = pattern(count: 16 * 1024 * 1024)
+        let file = try makeFile("performance", chunkSize: 16 * 1024)
+        measure {
+            XCTAssertNoThrow(try file.write(contents, at: 0))
+        }
+    }
+}
@@ -0,0 +1,174 @@
+//
+//  SecurePropertyListReaderTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import AppConnect
+@testable import MyAppConnect
+
+class SecurePropertyListReaderTests: SecureFileTestCase {
+    private let sample: NSDictionary = [
+        "name": "configuration",
+        "unicode": "Grüße ✓",
+        "count": 42,
+        "negative": -7,
+        "large": Int64.max,
+        "ratio": 0.25,
+        "enabled": true,
+        "disabled": false,
+        "created": Date(timeIntervalSinceReferenceDate: 600_000_000),
+        "blob": Data([0, 1, 2, 255]),
+        "servers": ["a.example.com", "b.example.com"],
+        "nested": ["depth": ["level": 2]],
+    ]
+
+    /// A secure chunked file holding `contents`, positioned at the start.
+    private func makeSource(_ name: String, contents: Data) throws -> SecureChunkedFile {
+        let file = try makeFile(name, chunkSize: 1024)
+        try file.write(contents, at: 0)
+        try file.seek(to: 0)
+        return file
+    }
+
+    private func parseXML(_ xml: String, bufferSize: Int = 64) throws -> Any {
+        let source = try makeSource("xml", contents: Data(xml.utf8))
+        return try SecurePropertyListReader.parseXML(from: source, bufferSize: bufferSize)
+    }
+
+    /// A hand-built bplist00 holding an array with one element whose marker byte is `marker`.
+    private func singleElementList(marker: UInt8) -> Data {
+        var bytes = Array("bplist00".utf8)
+        bytes += [0xA1, 0x01, marker]
+        bytes += [8, 10]
+        bytes += [UInt8](repeating: 0, count: 6) + [1, 1]
+        bytes += [0, 0, 0, 0, 0, 0, 0, 2]
+        bytes += [0, 0, 0, 0, 0, 0, 0, 0]
+        bytes += [0, 0, 0, 0, 0, 0, 0, 11]
+        return Data(bytes)
+    }
+
+    // MARK: Binary
+
+    func testBinaryListDecodesEveryType() throws {
+        let data = try PropertyListSerialization.data(fromPropertyList: sample, format: .binary, options: 0)
+        let file = try makeSource("binary", contents: data)
+        XCTAssertTrue(try SecureBinaryPropertyList.isBinary(file))
+        let root = try SecureBinaryPropertyList(source: file).rootObject()
+        XCTAssertEqual(root as? NSDictionary, sample)
+    }
+
+    func testBinaryListLargerThanTheWindow() throws {
+        let strings = (0..<5000).map { "value \($0)" }
+        let list: NSDictionary = ["strings": strings, "blob": pattern(count: 40_000)]
+        let data = try PropertyListSerialization.data(fromPropertyList: list, format: .binary, options: 0)
+        XCTAssertGreaterThan(data.count, SecureBinaryPropertyList.windowSize)
+        let root = try SecureBinaryPropertyList(source: makeSource("large", contents: data)).rootObject()
+        XCTAssertEqual((root as? NSDictionary)?["strings"] as? [String], strings)
+        XCTAssertEqual((root as? NSDictionary)?["blob"] as? Data, pattern(count: 40_000))
+    }
+
+    func testLazyDictionaryDecodesValuesOnDemand() throws {
+        let data = try PropertyListSerialization.data(fromPropertyList: sample, format: .binary, options: 0)
+        let lazy = try SecureLazyDictionary(list: SecureBinaryPropertyList(source: makeSource("lazy", contents: data)))
+        XCTAssertEqual(Set(lazy.keys), Set(sample.allKeys as! [String]))
+        XCTAssertEqual(try lazy.value(forKey: "count") as? Int, 42)
+        XCTAssertNil(try lazy.value(forKey: "missing"))
+        XCTAssertEqual(try lazy.materialize(), sample)
+    }
+
+    func testUnknownSimpleMarkerIsRejected() throws {
+        let valid = try SecureBinaryPropertyList(source: makeSource("true", contents: singleElementList(marker: 0x09)))
+        XCTAssertEqual(try valid.rootObject() as? [Bool], [true])
+
+        for marker: UInt8 in [0x00, 0x0F] {
+            let list = try SecureBinaryPropertyList(source: makeSource("marker\(marker)",
+                                                                       contents: singleElementList(marker: marker)))
+            assertThrows(SecureFileError.badKeyOrCorruptData) { _ = try list.rootObject() }
+        }
+    }
+
+    func testIntegersAboveInt64MaxRoundTrip() throws {
+        let list: NSDictionary = ["max": NSNumber(value: UInt64.max), "above": NSNumber(value: UInt64(Int64.max) + 1),
+                                  "min": NSNumber(value: Int64.min)]
+        let data = try PropertyListSerialization.data(fromPropertyList: list, format: .binary, options: 0)
+        let root = try SecureBinaryPropertyList(source: makeSource("unsigned", contents: data)).rootObject()
+        let decoded = try XCTUnwrap(root as? NSDictionary)
+        XCTAssertEqual(decoded, list)
+        XCTAssertEqual((decoded["max"] as? NSNumber)?.uint64Value, UInt64.max)
+        XCTAssertEqual((decoded["above"] as? NSNumber)?.uint64Value, UInt64(Int64.max) + 1)
+        XCTAssertEqual((decoded["min"] as? NSNumber)?.int64Value, Int64.min)
+    }
+
+    func testTruncatedBinaryListIsRejected() throws {
+        let data = try PropertyListSerialization.data(fromPropertyList: sample, format: .binary, options: 0)
+        XCTAssertThrowsError(try SecureBinaryPropertyList(source: makeSource("short", contents: data.prefix(20))))
+    }
+
+    // MARK: XML
+
+    func testXMLListDecodesAcrossManyBuffers() throws {
+        let data = try PropertyListSerialization.data(fromPropertyList: sample, format: .xml, options: 0)
+        let source = try makeSource("sample", contents: data)
+        XCTAssertFalse(try SecureBinaryPropertyList.isBinary(source))
+        let root = try SecurePropertyListReader.parseXML(from: source, bufferSize: 16)
+        XCTAssertEqual(root as? NSDictionary, sample)
+    }
+
+    func testXMLKeyFollowedByKeyIsRejected() {
+        XCTAssertThrowsError(try parseXML("<plist><dict><key>a</key><key>b</key><string>x</string></dict></plist>"))
+    }
+
+    func testXMLKeyWithoutValueIsRejected() {
+        XCTAssertThrowsError(try parseXML("<plist><dict><key>a</key></dict></plist>"))
+    }
+
+    func testXMLValueWithoutKeyIsRejected() {
+        XCTAssertThrowsError(try parseXML("<plist><dict><string>x</string></dict></plist>"))
+    }
+
+    func testMalformedXMLStopsTheProducer() {
+        let xml = "<plist><array>" + String(repeating: "<string>x</string>", count: 10_000) + "<bogus/></array></plist>"
+        XCTAssertThrowsError(try parseXML(xml, bufferSize: 32))
+    }
+
+    // MARK: Performance
+
+    /// An 8 MB secure file holding a property list of many small dictionaries, in `format`.
+    private func makeLargeSecureList(_ name: String, format: PropertyListSerialization.PropertyListFormat) throws
+        -> String {
+        try requireAppConnect()
+        let records = (0..<50_000).map {
+            ["id": $0, "name": "record \($0)", "blob": pattern(count: 100)] as NSDictionary
+        }
+        let list: NSDictionary = ["records": records]
+        let data = try PropertyListSerialization.data(fromPropertyList: list, format: format, options: 0)
+        try FileManager.default.createSecureFile(atPath: path(name), contents: data, attributes: nil)
+        return path(name)
+    }
+
+    func testStreamingXMLPerformance() throws {
+        let path = try makeLargeSecureList("xml", format: .xml)
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()]) {
+            XCTAssertNoThrow(try SecurePropertyListReader.dictionary(contentsOfSecureFile: path))
+        }
+    }
+
+    func testLazyBinaryPerformance() throws {
+        let path = try makeLargeSecureList("binary", format: .binary)
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()]) {
+            XCTAssertEqual(try SecurePropertyListReader.lazyDictionary(contentsOfSecureFile: path).keys, ["records"])
+        }
+    }
+
+    /// Whole-file baseline for `testStreamingXMLPerformance`: AppConnect decrypts everything, then parses it.
+    func testWholeFileXMLPerformance() throws {
+        let path = try makeLargeSecureList("xml", format: .xml)
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()]) {
+            XCTAssertNoThrow(try NSDictionary(contentsOfSecureFile: path))
+        }
+    }
+}
@@ -0,0 +1,159 @@
+//
+//  SecureReadAheadHandleTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import AppConnect
+@testable import MyAppConnect
+
+/// Serves `contents` from memory and fails every read once `failAt` bytes have been returned.
+private final class FailingFileHandle: ACFileHandle {
+    var contents = Data()
+    var failAt = 0
+    private var offset = 0
+
+    override var offsetInFile: UInt64 {
+        return UInt64(offset)
+    }
+
+    override func readData(ofLength length: Int, error: NSErrorPointer) -> Data? {
+        guard offset < failAt else {
+            error?.pointee = SecureFileError.posix(EIO)
+            return nil
+        }
+        let end = min(offset + length, failAt, contents.count)
+        defer { offset = end }
+        return contents.subdata(in: offset..<end)
+    }
+
+    override func closeFile() {
+    }
+}
+
+class SecureReadAheadHandleTests: SecureFileTestCase {
+    private func makeReader(_ name: String, contents: Data, blockSize: Int = 4096) throws -> SecureReadAheadHandle {
+        try requireAppConnect()
+        try FileManager.default.createSecureFile(atPath: path(name), contents: contents, attributes: nil)
+        let handle = try ACFileHandle(forReadingFrom: URL(fileURLWithPath: path(name)))
+        return SecureReadAheadHandle(handle: handle, blockSize: blockSize, maxDepth: 4)
+    }
+
+    func testSequentialReadsReturnTheContents() throws {
+        let contents = pattern(count: 100_000)
+        let reader = try makeReader("sequential", contents: contents)
+        var read = Data()
+        while true {
+            let block = try reader.readData(ofLength: 3000)
+            if block.isEmpty {
+                break
+            }
+            read.append(block)
+        }
+        reader.close()
+
+        XCTAssertEqual(read, contents)
+        XCTAssertEqual(reader.statistics.bytesRead, UInt64(contents.count))
+        XCTAssertGreaterThan(reader.statistics.hits + reader.statistics.stalls, 0)
+        XCTAssertLessThanOrEqual(reader.statistics.depth, 4)
+    }
+
+    func testSeekDiscardsReadAhead() throws {
+        let contents = pattern(count: 50_000)
+        let reader = try makeReader("seek", contents: contents)
+        for _ in 0..<4 {
+            _ = try reader.readData(ofLength: 1000)
+        }
+        reader.seek(toFileOffset: 30_000)
+        XCTAssertEqual(reader.offsetInFile, 30_000)
+        XCTAssertEqual(try reader.readData(ofLength: 5000), contents[30_000..<35_000])
+        reader.seek(toFileOffset: 10)
+        XCTAssertEqual(try reader.readData(ofLength: 10), contents[10..<20])
+        reader.close()
+    }
+
+    func testReadPastTheEndIsShort() throws {
+        let contents = pattern(count: 5000)
+        let reader = try makeReader("short", contents: contents, blockSize: 1024)
+        XCTAssertEqual(try reader.readData(ofLength: 10_000), contents)
+        XCTAssertEqual(try reader.readData(ofLength: 10), Data())
+        reader.close()
+    }
+
+    private func makeFailingReader(contents: Data, failAt: Int) -> SecureReadAheadHandle {
+        let handle = FailingFileHandle(fileDescriptor: -1, closeOnDealloc: false)
+        handle.contents = contents
+        handle.failAt = failAt
+        return SecureReadAheadHandle(handle: handle, blockSize: 1024, maxDepth: 4)
+    }
+
+    func testFailedDirectReadKeepsTheBytesBeforeIt() throws {
+        let contents = pattern(count: 10_000)
+        let reader = makeFailingReader(contents: contents, failAt: 6000)
+        XCTAssertEqual(try reader.readData(ofLength: 10_000), contents.prefix(6000))
+        XCTAssertEqual(reader.offsetInFile, 6000)
+        assertThrows(SecureFileError.posix(EIO)) {
+            _ = try reader.readData(ofLength: 10)
+        }
+        XCTAssertEqual(reader.offsetInFile, 6000)
+    }
+
+    func testFailedReadAheadKeepsTheBufferedBytes() throws {
+        let contents = pattern(count: 10_000)
+        let reader = makeFailingReader(contents: contents, failAt: 6000)
+        for index in 0..<3 {
+            XCTAssertEqual(try reader.readData(ofLength: 1000), contents[(index * 1000)..<((index + 1) * 1000)])
+        }
+        XCTAssertEqual(try reader.readData(ofLength: 10_000), contents[3000..<6000])
+        XCTAssertEqual(reader.offsetInFile, 6000)
+        assertThrows(SecureFileError.posix(EIO)) {
+            _ = try reader.readData(ofLength: 10)
+        }
+    }
+
+    func testSequentialReadThroughput() throws {
+        let contents = pattern(count: 16 * 1024 * 1024)
+        try requireAppConnect()
+        try FileManager.default.createSecureFile(atPath: path("throughput"), contents: contents, attributes: nil)
+        let url = URL(fileURLWithPath: path("throughput"))
+        measure {
+            guard let handle = try? ACFileHandle(forReadingFrom: url) else {
+                return XCTFail()
+            }
+            let reader = SecureReadAheadHandle(handle: handle)
+            var total = 0
+            while let block = try? reader.readData(ofLength: 16 * 1024), !block.isEmpty {
+                total += block.count
+            }
+            reader.close()
+            XCTAssertEqual(total, contents.count)
+        }
+    }
+
+    /// Attaches the 50th, 90th and 99th percentile latency of 16 KB reads, which `measure` cannot report.
+    func testReadLatencyPercentiles() throws {
+        let reader = try makeReader("latency", contents: pattern(count: 16 * 1024 * 1024),
+                                    blockSize: SecureReadAheadHandle.defaultBlockSize)
+        var latencies: [UInt64] = []
+        while true {
+            let start = DispatchTime.now().uptimeNanoseconds
+            let block = try reader.readData(ofLength: 16 * 1024)
+            latencies.append(DispatchTime.now().uptimeNanoseconds - start)
+            if block.isEmpty {
+                break
+            }
+        }
+        reader.close()
+        latencies.sort()
+        let summary = [50, 90, 99].map { percentile -> String in
+            let latency = latencies[min(latencies.count - 1, latencies.count * percentile / 100)]
+            return "p\(percentile) \(Double(latency) / 1000) µs"
+        }
+        let attachment = XCTAttachment(string: summary.joined(separator: ", "))
+        attachment.lifetime = .keepAlways
+        add(attachment)
+    }
+}
@@ -0,0 +1,164 @@
+//
+//  SecureSQLiteVFSTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import SQLite3
+@testable import MyAppConnect
+
+class SecureSQLiteVFSTests: SecureFileTestCase {
+    /// Each test registers its own VFS name, so it uses its own key provider.
+    private var vfsName: String!
+
+    override func setUp() {
+        super.setUp()
+        vfsName = "secure-test-\(UUID().uuidString)"
+        XCTAssertEqual(SecureSQLiteVFS.register(name: vfsName, keyProvider: keyProvider), SQLITE_OK)
+    }
+
+    private func open(_ name: String, usingDefaultVFS: Bool = false) throws -> OpaquePointer {
+        var db: OpaquePointer?
+        let result = sqlite3_open_v2(path(name), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                                     usingDefaultVFS ? nil : vfsName)
+        guard result == SQLITE_OK, let handle = db else {
+            sqlite3_close(db)
+            throw NSError(domain: "SQLite", code: Int(result))
+        }
+        return handle
+    }
+
+    private func execute(_ db: OpaquePointer, _ sql: String, file: StaticString = #file, line: UInt = #line) {
+        XCTAssertEqual(sqlite3_exec(db, sql, nil, nil, nil), SQLITE_OK, String(cString: sqlite3_errmsg(db)),
+                       file: file, line: line)
+    }
+
+    /// Returns the first column of the first row of `sql` as text, or nil if the statement fails.
+    private func scalar(_ db: OpaquePointer, _ sql: String) -> String? {
+        var statement: OpaquePointer?
+        guard sqlite3_prepare_v2(db, sql, -1, &statement, nil) == SQLITE_OK else { return nil }
+        defer { sqlite3_finalize(statement) }
+        guard sqlite3_step(statement) == SQLITE_ROW, let text = sqlite3_column_text(statement, 0) else {
+            return nil
+        }
+        return String(cString: text)
+    }
+
+    private func populate(_ db: OpaquePointer, rows: Int) {
+        execute(db, "PRAGMA page_size = \(SecureSQLiteVFS.defaultPageSize)")
+        execute(db, "CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT, payload BLOB)")
+        execute(db, "CREATE INDEX items_name ON items (name)")
+        execute(db, "BEGIN")
+        for row in 0..<rows {
+            execute(db, "INSERT INTO items (name, payload) VALUES ('item \(row)', randomblob(\(row % 700)))")
+        }
+        execute(db, "COMMIT")
+    }
+
+    func testIntegrityCheckPassesAfterReopen() throws {
+        let db = try open("store.sqlite")
+        populate(db, rows: 2000)
+        execute(db, "DELETE FROM items WHERE id % 3 = 0")
+        execute(db, "UPDATE items SET payload = randomblob(900) WHERE id % 5 = 0")
+        XCTAssertEqual(scalar(db, "PRAGMA integrity_check"), "ok")
+        XCTAssertEqual(sqlite3_close(db), SQLITE_OK)
+
+        let reopened = try open("store.sqlite")
+        defer { sqlite3_close(reopened) }
+        XCTAssertEqual(scalar(reopened, "PRAGMA integrity_check"), "ok")
+        XCTAssertEqual(scalar(reopened, "SELECT count(*) FROM items"), "1334")
+        XCTAssertEqual(scalar(reopened, "SELECT name FROM items WHERE id = 2000"), "item 1999")
+    }
+
+    func testVacuumKeepsDatabaseIntact() throws {
+        let db = try open("vacuum.sqlite")
+        defer { sqlite3_close(db) }
+        populate(db, rows: 500)
+        execute(db, "DELETE FROM items WHERE id > 100")
+        execute(db, "VACUUM")
+        XCTAssertEqual(scalar(db, "PRAGMA integrity_check"), "ok")
+        XCTAssertEqual(scalar(db, "SELECT count(*) FROM items"), "100")
+    }
+
+    func testDatabaseIsNotStoredInPlaintext() throws {
+        let db = try open("plain.sqlite")
+        populate(db, rows: 50)
+        XCTAssertEqual(sqlite3_close(db), SQLITE_OK)
+
+        let raw = try Data(contentsOf: URL(fileURLWithPath: path("plain.sqlite")))
+        XCTAssertNil(raw.range(of: Data("SQLite format 3".utf8)))
+        XCTAssertNil(raw.range(of: Data("item 42".utf8)))
+    }
+
+    func testTamperedPageFailsInsteadOfReturningGarbage() throws {
+        let db = try open("tampered.sqlite")
+        populate(db, rows: 1000)
+        XCTAssertEqual(sqlite3_close(db), SQLITE_OK)
+
+        flipBytes(of: path("tampered.sqlite"), at: rawSize(of: path("tampered.sqlite")) / 2, count: 8)
+        let reopened = try open("tampered.sqlite")
+        defer { sqlite3_close(reopened) }
+        XCTAssertNotEqual(scalar(reopened, "PRAGMA integrity_check"), "ok")
+    }
+
+    func testHotJournalRollsBackAfterCrashMidTransaction() throws {
+        let db = try open("crash.sqlite")
+        populate(db, rows: 2000)
+        let before = scalar(db, "SELECT count(*) || ' ' || sum(length(payload)) FROM items")
+        let committed = FileManager.default.contents(atPath: path("crash.sqlite"))
+
+        // A small page cache makes SQLite spill changed pages into the database, after syncing the journal, before
+        // the transaction commits.
+        execute(db, "PRAGMA cache_size = 10")
+        execute(db, "BEGIN")
+        execute(db, "UPDATE items SET payload = randomblob(900)")
+        execute(db, "DELETE FROM items WHERE id % 2 = 0")
+        // Copying the files now leaves what a crash would: a partly changed database and a hot journal.
+        try FileManager.default.copyItem(atPath: path("crash.sqlite"), toPath: path("crashed.sqlite"))
+        try FileManager.default.copyItem(atPath: path("crash.sqlite-journal"), toPath: path("crashed.sqlite-journal"))
+        execute(db, "ROLLBACK")
+        XCTAssertEqual(sqlite3_close(db), SQLITE_OK)
+        XCTAssertNotEqual(FileManager.default.contents(atPath: path("crashed.sqlite")), committed)
+
+        let recovered = try open("crashed.sqlite")
+        defer { sqlite3_close(recovered) }
+        XCTAssertEqual(scalar(recovered, "PRAGMA integrity_check"), "ok")
+        XCTAssertEqual(scalar(recovered, "SELECT count(*) || ' ' || sum(length(payload)) FROM items"), before)
+        XCTAssertFalse(FileManager.default.fileExists(atPath: path("crashed.sqlite-journal")))
+    }
+
+    // MARK: Performance
+
+    /// A reduced speedtest1 run: bulk inserts, indexed lookups, range updates and deletes, in a new database.
+    private func runSpeedtest(usingDefaultVFS: Bool) {
+        guard let db = try? open("speedtest-\(UUID().uuidString).sqlite", usingDefaultVFS: usingDefaultVFS) else {
+            return XCTFail()
+        }
+        defer { sqlite3_close(db) }
+        populate(db, rows: 5000)
+        execute(db, "BEGIN")
+        for row in stride(from: 0, to: 5000, by: 5) {
+            XCTAssertNotNil(scalar(db, "SELECT payload FROM items WHERE name = 'item \(row)'"))
+        }
+        execute(db, "COMMIT")
+        execute(db, "UPDATE items SET payload = randomblob(300) WHERE id BETWEEN 1000 AND 3000")
+        execute(db, "DELETE FROM items WHERE id % 7 = 0")
+        XCTAssertNotNil(scalar(db, "SELECT sum(length(payload)) FROM items"))
+    }
+
+    func testSpeedtestPerformance() {
+        measure {
+            runSpeedtest(usingDefaultVFS: false)
+        }
+    }
+
+    /// Unencrypted baseline for `testSpeedtestPerformance`.
+    func testSpeedtestDefaultVFSPerformance() {
+        measure {
+            runSpeedtest(usingDefaultVFS: true)
+        }
+    }
+}
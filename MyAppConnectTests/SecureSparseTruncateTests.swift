@@ -0,0 +1,138 @@
+//
+//  SecureSparseTruncateTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+@testable import MyAppConnect
+
+class SecureSparseTruncateTests: SecureFileTestCase {
+    private let chunkSize = 4096
+
+    private func slotOffset(_ file: SecureChunkedFile, _ index: Int) -> off_t {
+        return off_t(SecureChunkedFileHeader.size + index * file.slotSize)
+    }
+
+    private func zeroSlot(of file: SecureChunkedFile, _ index: Int) {
+        let fd = Darwin.open(file.path, O_RDWR)
+        XCTAssertGreaterThanOrEqual(fd, 0)
+        let zeros = [UInt8](repeating: 0, count: file.slotSize)
+        XCTAssertEqual(Darwin.pwrite(fd, zeros, zeros.count, slotOffset(file, index)), zeros.count)
+        Darwin.close(fd)
+    }
+
+    func testGrowingLeavesAHoleOnDisk() throws {
+        let file = try makeFile("grown")
+        try file.write(pattern(count: 100), at: 0)
+        let length = UInt64(64 * 1024 * 1024)
+        try file.truncate(to: length)
+        try file.synchronize()
+
+        XCTAssertEqual(file.length, length)
+        XCTAssertEqual(file.holes, [1..<(length / UInt64(chunkSize))])
+        XCTAssertEqual(rawSize(of: path("grown")), slotOffset(file, Int(length) / chunkSize))
+        var info = stat()
+        XCTAssertEqual(stat(path("grown"), &info), 0)
+        XCTAssertLessThan(Int64(info.st_blocks) * 512, 1024 * 1024)
+
+        XCTAssertEqual(try file.read(length: 200, at: 0), pattern(count: 100) + Data(count: 100))
+        XCTAssertEqual(try file.read(length: chunkSize, at: length - UInt64(chunkSize)), Data(count: chunkSize))
+    }
+
+    func testWritesIntoAHoleKeepTheirNeighboursZero() throws {
+        let file = try makeFile("filled")
+        try file.truncate(to: UInt64(chunkSize * 8))
+        try file.write(pattern(count: chunkSize + 10), at: UInt64(chunkSize * 3 + 5))
+        file.close()
+
+        let reopened = try makeFile("filled")
+        XCTAssertEqual(try reopened.read(length: chunkSize * 3 + 5, at: 0), Data(count: chunkSize * 3 + 5))
+        XCTAssertEqual(try reopened.read(length: chunkSize + 10, at: UInt64(chunkSize * 3 + 5)),
+                       pattern(count: chunkSize + 10))
+        let tail = UInt64(chunkSize * 4 + 15)
+        XCTAssertEqual(try reopened.read(length: chunkSize * 8, at: tail), Data(count: chunkSize * 8 - Int(tail)))
+    }
+
+    func testZeroedSlotOutsideRecordedHolesIsRejected() throws {
+        let dense = try makeFile("dense")
+        try dense.write(pattern(count: chunkSize * 3), at: 0)
+        zeroSlot(of: dense, 1)
+        assertThrows(SecureFileError.badKeyOrCorruptData) {
+            _ = try dense.read(length: 1, at: UInt64(self.chunkSize))
+        }
+
+        // Once written, chunks of a grown file are no longer holes and must authenticate like any other.
+        let grown = try makeFile("grown")
+        try grown.truncate(to: UInt64(chunkSize * 3))
+        try grown.write(pattern(count: chunkSize * 3), at: 0)
+        XCTAssertEqual(grown.holes, [])
+        grown.close()
+        zeroSlot(of: grown, 1)
+        let reopened = try makeFile("grown")
+        XCTAssertEqual(try reopened.read(length: chunkSize, at: 0), pattern(count: chunkSize))
+        assertThrows(SecureFileError.badKeyOrCorruptData) {
+            _ = try reopened.read(length: 1, at: UInt64(self.chunkSize))
+        }
+    }
+
+    func testHolesSurviveReopenAndSplitWhenWritten() throws {
+        let file = try makeFile("split")
+        try file.write(pattern(count: 10), at: 0)
+        try file.truncate(to: UInt64(chunkSize * 10))
+        try file.write(pattern(count: chunkSize, seed: 1), at: UInt64(chunkSize * 4))
+        XCTAssertEqual(file.holes, [1..<4, 5..<10])
+        file.close()
+
+        let reopened = try makeFile("split")
+        XCTAssertEqual(reopened.holes, [1..<4, 5..<10])
+        XCTAssertEqual(try reopened.read(length: chunkSize, at: UInt64(chunkSize * 4)),
+                       pattern(count: chunkSize, seed: 1))
+        XCTAssertEqual(try reopened.read(length: chunkSize, at: UInt64(chunkSize * 9)), Data(count: chunkSize))
+
+        try reopened.truncate(to: UInt64(chunkSize * 2 + 1))
+        XCTAssertEqual(reopened.holes, [1..<3])
+    }
+
+    func testHolesBeyondTheHeaderCapacityAreSealed() throws {
+        let file = try makeFile("gaps")
+        let gaps = SecureChunkedFileHeader.maxHoles + 2
+        for gap in 0...gaps {
+            try file.write(pattern(count: chunkSize, seed: UInt8(gap)), at: UInt64(chunkSize * 2 * gap))
+        }
+        XCTAssertEqual(file.holes.count, SecureChunkedFileHeader.maxHoles)
+        file.close()
+
+        let reopened = try makeFile("gaps")
+        for gap in 0...gaps {
+            XCTAssertEqual(try reopened.read(length: chunkSize, at: UInt64(chunkSize * 2 * gap)),
+                           pattern(count: chunkSize, seed: UInt8(gap)))
+            if gap > 0 {
+                XCTAssertEqual(try reopened.read(length: chunkSize, at: UInt64(chunkSize * (2 * gap - 1))),
+                               Data(count: chunkSize))
+            }
+        }
+        // The first gaps were sealed as zero chunks, so zeroing one of their slots is detected.
+        reopened.close()
+        zeroSlot(of: reopened, 1)
+        assertThrows(SecureFileError.badKeyOrCorruptData) {
+            _ = try self.makeFile("gaps").read(length: 1, at: UInt64(self.chunkSize))
+        }
+    }
+
+    func testShrinkingRewritesOnlyTheBoundaryChunk() throws {
+        let file = try makeFile("shrunk")
+        let contents = pattern(count: chunkSize * 4)
+        try file.write(contents, at: 0)
+        let firstSlot = FileManager.default.contents(atPath: path("shrunk"))!
+            .subdata(in: Int(slotOffset(file, 0))..<Int(slotOffset(file, 1)))
+
+        try file.truncate(to: UInt64(chunkSize + 10))
+        XCTAssertEqual(rawSize(of: path("shrunk")), slotOffset(file, 2))
+        let raw = FileManager.default.contents(atPath: path("shrunk"))!
+        XCTAssertEqual(raw.subdata(in: Int(slotOffset(file, 0))..<Int(slotOffset(file, 1))), firstSlot)
+        XCTAssertEqual(try file.read(length: chunkSize * 2, at: 0), contents.prefix(chunkSize + 10))
+    }
+}
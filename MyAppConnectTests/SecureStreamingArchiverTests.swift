@@ -0,0 +1,219 @@
+//
+//  SecureStreamingArchiverTests.swift
+//  MyAppConnectTests
+//
+//  Created by Vedarth Solutions on 10/17/26.
+//  Copyright © 2026 Sky Plc. All rights reserved.
+//
+
+import XCTest
+import AppConnect
+@testable import MyAppConnect
+
+/// Tree node with unconditional children and conditional parent and peer references.
+@objc(ArchivedNode)
+final class ArchivedNode: NSObject, NSSecureCoding {
+    static var supportsSecureCoding: Bool {
+        return true
+    }
+
+    let name: String
+    var children: [ArchivedNode] = []
+    weak var parent: ArchivedNode?
+    weak var peer: ArchivedNode?
+
+    init(name: String) {
+        self.name = name
+    }
+
+    func encode(with coder: NSCoder) {
+        coder.encode(name, forKey: "name")
+        coder.encode(children, forKey: "children")
+        coder.encodeConditionalObject(parent, forKey: "parent")
+        coder.encodeConditionalObject(peer, forKey: "peer")
+    }
+
+    init?(coder: NSCoder) {
+        guard let name = coder.decodeObject(of: [NSString.self], forKey: "name") as? String else {
+            return nil
+        }
+        self.name = name
+        children = coder.decodeObject(of: [NSArray.self, ArchivedNode.self], forKey: "children") as? [ArchivedNode]
+            ?? []
+        parent = coder.decodeObject(of: [ArchivedNode.self], forKey: "parent") as? ArchivedNode
+        peer = coder.decodeObject(of: [ArchivedNode.self], forKey: "peer") as? ArchivedNode
+    }
+}
+
+/// Adopts NSCoding but not NSSecureCoding.
+@objc(ArchivedInsecureNote)
+final class ArchivedInsecureNote: NSObject, NSCoding {
+    func encode(with coder: NSCoder) {
+        coder.encode("note", forKey: "text")
+    }
+
+    init?(coder: NSCoder) {}
+
+    override init() {}
+}
+
+class SecureStreamingArchiverTests: SecureFileTestCase {
+    private func archive(_ root: Any?, _ name: String = "archive", bufferSize: Int = 256) throws {
+        try SecureStreamingArchiver.archiveRootObject(root, toSecureFile: path(name), bufferSize: bufferSize)
+    }
+
+    private func unarchive(_ classes: [AnyClass], _ name: String = "archive") throws -> Any? {
+        return try SecureStreamingUnarchiver.unarchivedObject(ofClasses: classes, withSecureFile: path(name),
+                                                              bufferSize: 256)
+    }
+
+    func testNativeValuesAndObjectsRoundTrip() throws {
+        try requireAppConnect()
+        let tree = ArchivedNode(name: "root")
+        tree.children = [ArchivedNode(name: "left"), ArchivedNode(name: "right")]
+        let root: NSDictionary = [
+            "string": "Grüße",
+            "integer": -42,
+            "unsigned": UInt64.max,
+            "double": 0.5,
+            "flag": true,
+            "date": Date(timeIntervalSinceReferenceDate: 1000),
+            "small": Data([1, 2, 3]),
+            "large": pattern(count: 100_000),
+            "null": NSNull(),
+            "list": NSMutableArray(array: [1, "two"]),
+            "set": NSSet(array: [1, 2, 3]),
+            "tree": tree,
+        ]
+        try archive(root)
+
+        let decoded = try XCTUnwrap(unarchive([NSDictionary.self, ArchivedNode.self]) as? NSDictionary)
+        XCTAssertEqual(decoded.count, root.count)
+        for case let key as String in root.allKeys where key != "tree" {
+            XCTAssertEqual(decoded[key] as? NSObject, root[key] as? NSObject, key)
+        }
+        XCTAssertTrue(decoded["list"] is NSMutableArray)
+        let decodedTree = try XCTUnwrap(decoded["tree"] as? ArchivedNode)
+        XCTAssertEqual(decodedTree.children.map { $0.name }, ["left", "right"])
+    }
+
+    func testRepeatedObjectsKeepTheirIdentity() throws {
+        try requireAppConnect()
+        let shared = ArchivedNode(name: "shared")
+        try archive([shared, shared] as NSArray)
+        let decoded = try XCTUnwrap(unarchive([NSArray.self, ArchivedNode.self]) as? [ArchivedNode])
+        XCTAssertEqual(decoded.count, 2)
+        XCTAssertTrue(decoded[0] === decoded[1])
+    }
+
+    func testRootOutsideTheAllowedClassesIsRejected() throws {
+        try requireAppConnect()
+        try archive(ArchivedNode(name: "root"))
+        assertThrows(SecureFileError.badKeyOrCorruptData) { _ = try unarchive([NSDictionary.self]) }
+        XCTAssertEqual(try SecureStreamingUnarchiver.unarchivedObject(ofClass: ArchivedNode.self,
+                                                                      withSecureFile: path("archive"))?.name, "root")
+    }
+
+    func testNestedObjectOutsideTheAllowedClassesIsRejected() throws {
+        try requireAppConnect()
+        try archive(["node": ArchivedNode(name: "nested")] as NSDictionary)
+        assertThrows(SecureFileError.badKeyOrCorruptData) { _ = try unarchive([NSDictionary.self]) }
+    }
+
+    func testClassWithoutSecureCodingIsRejected() throws {
+        try requireAppConnect()
+        try archive(ArchivedInsecureNote())
+        assertThrows(SecureFileError.badKeyOrCorruptData) { _ = try unarchive([ArchivedInsecureNote.self]) }
+    }
+
+    func testReferenceToAnAncestorFailsArchiving() throws {
+        try requireAppConnect()
+        let parent = ArchivedNode(name: "parent")
+        let child = ArchivedNode(name: "child")
+        parent.children = [child]
+        child.parent = parent
+        assertThrows(SecureFileError.invalidArgument) { try archive(parent) }
+        XCTAssertFalse(FileManager.default.fileExists(atPath: path("archive")))
+
+        let list = NSMutableArray()
+        list.add(list)
+        assertThrows(SecureFileError.invalidArgument) { try archive(list, "cycle") }
+    }
+
+    func testConditionalReferenceResolvesOnlyToEarlierObjects() throws {
+        try requireAppConnect()
+        let first = ArchivedNode(name: "first")
+        let second = ArchivedNode(name: "second")
+        first.peer = second
+        second.peer = first
+        try archive([first, second] as NSArray)
+
+        let decoded = try XCTUnwrap(unarchive([NSArray.self, ArchivedNode.self]) as? [ArchivedNode])
+        // `second` was archived only after `first` referred to it, so that reference is lost.
+        XCTAssertNil(decoded[0].peer)
+        XCTAssertTrue(decoded[1].peer === decoded[0])
+    }
+
+    func testKeyedArchiveFallsBackToNSKeyedUnarchiver() throws {
+        try requireAppConnect()
+        let root: NSDictionary = ["key": "value", "numbers": [1, 2, 3]]
+        try NSKeyedArchiver.archiveRootObject(root, toSecureFile: path("keyed"))
+
+        let decoded = try SecureStreamingUnarchiver.unarchivedObject(
+            ofClasses: [NSDictionary.self, NSArray.self, NSString.self, NSNumber.self], withSecureFile: path("keyed"))
+        XCTAssertEqual(decoded as? NSDictionary, root)
+        XCTAssertThrowsError(try unarchive([NSArray.self], "keyed"))
+    }
+
+    func testTruncatedArchiveIsRejected() throws {
+        try requireAppConnect()
+        try FileManager.default.createSecureFile(atPath: path("short"), contents: Data([0x41]), attributes: nil)
+        assertThrows(SecureFileError.badKeyOrCorruptData) { _ = try unarchive([NSObject.self], "short") }
+    }
+
+    func testAtomicArchiveIsCommittedThroughGroupCommit() throws {
+        try requireAppConnect()
+        try archive(["version": 1] as NSDictionary)
+        let before = SecureGroupCommit.shared.statistics.files
+        try archive(["version": 2] as NSDictionary)
+        XCTAssertEqual(SecureGroupCommit.shared.statistics.files, before + 1)
+        XCTAssertEqual(try FileManager.default.contentsOfDirectory(atPath: directory).filter { $0.hasSuffix(".tmp") },
+                       [])
+        let decoded = try unarchive([NSDictionary.self, NSNumber.self, NSString.self]) as? NSDictionary
+        XCTAssertEqual(decoded?["version"] as? Int, 2)
+    }
+
+    // MARK: Performance
+
+    /// 3000 distinct 100 KB values, about 300 MB.
+    private func largeGraph() -> NSDictionary {
+        let graph = NSMutableDictionary()
+        for index in 0..<3000 {
+            graph["value \(index)"] = pattern(count: 100 * 1024, seed: UInt8(index % 256))
+        }
+        return graph
+    }
+
+    private var largeGraphOptions: XCTMeasureOptions {
+        let options = XCTMeasureOptions()
+        options.iterationCount = 3
+        return options
+    }
+
+    func testArchivingALargeGraphPerformance() throws {
+        try requireAppConnect()
+        let graph = largeGraph()
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()], options: largeGraphOptions) {
+            XCTAssertNoThrow(try SecureStreamingArchiver.archiveRootObject(graph, toSecureFile: path("large")))
+        }
+    }
+
+    /// In-memory baseline for `testArchivingALargeGraphPerformance`.
+    func testKeyedArchivingALargeGraphPerformance() throws {
+        try requireAppConnect()
+        let graph = largeGraph()
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()], options: largeGraphOptions) {
+            XCTAssertNoThrow(try NSKeyedArchiver.archiveRootObject(graph, toSecureFile: path("keyed")))
+        }
+    }
+}